@@ -0,0 +1,33 @@
+QT += core
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# Outil de recherche et d'import dans une banque de questions
+TARGET = QuizzBankTool
+TEMPLATE = app
+
+include(questionpacks.pri)
+
+SOURCES += \
+    quizzbanktool.cpp \
+    game.cpp \
+    gameclock.cpp \
+    roomflow.cpp \
+    teamstandings.cpp \
+    question.cpp \
+    questionbank.cpp \
+    questionimporter.cpp \
+    questionstore.cpp
+
+HEADERS += \
+    game.h \
+    gameclock.h \
+    roomflow.h \
+    teamstandings.h \
+    question.h \
+    questionbank.h \
+    questionimporter.h \
+    questionstore.h
@@ -1,11 +1,23 @@
-QT += core widgets network
+QT += core widgets network multimedia
 
-CONFIG += c++17
+CONFIG += c++20
 CONFIG += sdk_no_version_check
 
+# zlib : compression des trames (framecodec.cpp)
+LIBS += -lz
+
+# Transport hôte io_uring (uringtransport.cpp), choisi à l'exécution par QUIZZ_IO_URING=1
+linux:packagesExist(liburing) {
+    CONFIG += link_pkgconfig
+    PKGCONFIG += liburing
+    DEFINES += QUIZZ_HAVE_URING
+}
+
 TARGET = QuizzGame
 TEMPLATE = app
 
+include(questionpacks.pri)
+
 # Force le bon compilateur et SDK
 QMAKE_MACOSX_DEPLOYMENT_TARGET = 11.0
 QMAKE_MAC_SDK_VERSION = 15.2
@@ -13,15 +25,61 @@ QMAKE_MAC_SDK_VERSION = 15.2
 SOURCES += \
     main.cpp \
     mainwindow.cpp \
+    clienttable.cpp \
+    framecodec.cpp \
+    framereader.cpp \
     game.cpp \
+    gameclock.cpp \
+    gamecheckpoint.cpp \
+    gamejournal.cpp \
+    gamesession.cpp \
+    mediacache.cpp \
+    mediastreamer.cpp \
     networkmanager.cpp \
-    question.cpp
+    playerlistmodel.cpp \
+    roomflow.cpp \
+    scoretablemodel.cpp \
+    sockethandoff.cpp \
+    spectatorfeed.cpp \
+    startuptrace.cpp \
+    teamstandings.cpp \
+    trafficcapture.cpp \
+    uringtransport.cpp \
+    wirestrings.cpp \
+    question.cpp \
+    questionbank.cpp \
+    questionstore.cpp
 
 HEADERS += \
     mainwindow.h \
+    boundedqueue.h \
+    clienttable.h \
+    framecodec.h \
+    framereader.h \
     game.h \
+    gameclock.h \
+    gamecheckpoint.h \
+    gamejournal.h \
+    gamesession.h \
+    mediacache.h \
+    mediastreamer.h \
     networkmanager.h \
-    question.h
+    playerlistmodel.h \
+    roomflow.h \
+    scoretablemodel.h \
+    sockethandoff.h \
+    spectatorfeed.h \
+    startuptrace.h \
+    teamstandings.h \
+    trafficcapture.h \
+    uringtransport.h \
+    wirestrings.h \
+    question.h \
+    questionbank.h \
+    questionstore.h
 
 FORMS += \
-    mainwindow.ui
\ No newline at end of file
+    mainwindow.ui
+
+RESOURCES += \
+    resources.qrc
@@ -0,0 +1,17 @@
+QT += core network
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# Proxy de dégradation réseau (latence, gigue, débit, gels, coupures)
+TARGET = QuizzProxy
+TEMPLATE = app
+
+SOURCES += \
+    quizzproxy.cpp \
+    impairmentproxy.cpp
+
+HEADERS += \
+    impairmentproxy.h
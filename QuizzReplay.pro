@@ -0,0 +1,63 @@
+QT += core network
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# zlib : compression des trames (framecodec.cpp)
+LIBS += -lz
+
+# Rejeu d'une capture de trafic (QUIZZ_CAPTURE) dans une partie sans interface
+TARGET = QuizzReplay
+TEMPLATE = app
+
+include(questionpacks.pri)
+
+SOURCES += \
+    quizzreplay.cpp \
+    clienttable.cpp \
+    framecodec.cpp \
+    framereader.cpp \
+    game.cpp \
+    gameclock.cpp \
+    gamecheckpoint.cpp \
+    gamejournal.cpp \
+    gamesession.cpp \
+    mediacache.cpp \
+    mediastreamer.cpp \
+    networkmanager.cpp \
+    roomflow.cpp \
+    sockethandoff.cpp \
+    spectatorfeed.cpp \
+    teamstandings.cpp \
+    trafficcapture.cpp \
+    uringtransport.cpp \
+    wirestrings.cpp \
+    question.cpp \
+    questionbank.cpp \
+    questionstore.cpp
+
+HEADERS += \
+    boundedqueue.h \
+    clienttable.h \
+    framecodec.h \
+    framereader.h \
+    game.h \
+    gameclock.h \
+    gamecheckpoint.h \
+    gamejournal.h \
+    gamesession.h \
+    mediacache.h \
+    mediastreamer.h \
+    networkmanager.h \
+    roomflow.h \
+    sockethandoff.h \
+    spectatorfeed.h \
+    teamstandings.h \
+    trafficcapture.h \
+    uringtransport.h \
+    wirestrings.h \
+    question.h \
+    questionbank.h \
+    questionstore.h
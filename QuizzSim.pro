@@ -0,0 +1,31 @@
+QT += core
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# Parties simulées en temps virtuel (banc d'essai de Game)
+TARGET = QuizzSim
+TEMPLATE = app
+
+include(questionpacks.pri)
+
+SOURCES += \
+    quizzsim.cpp \
+    game.cpp \
+    gameclock.cpp \
+    roomflow.cpp \
+    teamstandings.cpp \
+    question.cpp \
+    questionbank.cpp \
+    questionstore.cpp
+
+HEADERS += \
+    game.h \
+    gameclock.h \
+    roomflow.h \
+    teamstandings.h \
+    question.h \
+    questionbank.h \
+    questionstore.h
@@ -0,0 +1,34 @@
+QT += core
+QT -= gui
+
+CONFIG += c++20 console
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# Outil hors ligne : statistiques par question à partir du journal
+TARGET = QuizzStats
+TEMPLATE = app
+
+include(questionpacks.pri)
+
+SOURCES += \
+    quizzstats.cpp \
+    game.cpp \
+    gameclock.cpp \
+    roomflow.cpp \
+    teamstandings.cpp \
+    gamejournal.cpp \
+    question.cpp \
+    questionbank.cpp \
+    questionstore.cpp
+
+HEADERS += \
+    boundedqueue.h \
+    game.h \
+    gameclock.h \
+    roomflow.h \
+    teamstandings.h \
+    gamejournal.h \
+    question.h \
+    questionbank.h \
+    questionstore.h
@@ -0,0 +1,27 @@
+QT += core testlib
+QT -= gui
+
+CONFIG += c++20 console testcase
+CONFIG -= app_bundle
+CONFIG += sdk_no_version_check
+
+# zlib : ClientSlot garde le dictionnaire de sa connexion (wirestrings.cpp)
+LIBS += -lz
+
+# Tests unitaires : classement des équipes, sessions et seaux à jetons,
+# lecture des trames, dictionnaire de chaînes
+TARGET = QuizzTests
+TEMPLATE = app
+
+SOURCES += \
+    quizztests.cpp \
+    clienttable.cpp \
+    framereader.cpp \
+    teamstandings.cpp \
+    wirestrings.cpp
+
+HEADERS += \
+    clienttable.h \
+    framereader.h \
+    teamstandings.h \
+    wirestrings.h
@@ -0,0 +1,71 @@
+#ifndef BOUNDEDQUEUE_H
+#define BOUNDEDQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// File bornée sans verrou, plusieurs producteurs / un consommateur
+// (schéma de D. Vyukov : un numéro de séquence par case).
+// tryPush ne bloque jamais : il échoue si la file est pleine.
+template <typename T>
+class BoundedQueue
+{
+public:
+    explicit BoundedQueue(std::size_t capacityPow2)
+        : mask(capacityPow2 - 1), cells(new Cell[capacityPow2]), head(0), tail(0)
+    {
+        for (std::size_t i = 0; i < capacityPow2; ++i)
+            cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+
+    BoundedQueue(const BoundedQueue &) = delete;
+    BoundedQueue &operator=(const BoundedQueue &) = delete;
+
+    bool tryPush(const T &value)
+    {
+        std::size_t pos = tail.load(std::memory_order_relaxed);
+        for (;;) {
+            Cell &cell = cells[pos & mask];
+            const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+            const std::ptrdiff_t diff = std::ptrdiff_t(seq) - std::ptrdiff_t(pos);
+            if (diff == 0) {
+                if (tail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                    cell.value = value;
+                    cell.sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            } else if (diff < 0) {
+                return false; // pleine
+            } else {
+                pos = tail.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    // Consommateur unique
+    bool tryPop(T *value)
+    {
+        Cell &cell = cells[head & mask];
+        const std::size_t seq = cell.sequence.load(std::memory_order_acquire);
+        if (std::ptrdiff_t(seq) - std::ptrdiff_t(head + 1) < 0)
+            return false; // vide
+        *value = cell.value;
+        cell.sequence.store(head + mask + 1, std::memory_order_release);
+        ++head;
+        return true;
+    }
+
+private:
+    struct Cell {
+        std::atomic<std::size_t> sequence;
+        T value;
+    };
+
+    const std::size_t mask;
+    std::unique_ptr<Cell[]> cells;
+    alignas(64) std::size_t head;
+    alignas(64) std::atomic<std::size_t> tail;
+};
+
+#endif // BOUNDEDQUEUE_H
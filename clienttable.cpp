@@ -0,0 +1,104 @@
+#include "clienttable.h"
+
+bool TokenBucket::take(double ratePerSecond, double burst, qint64 nowMs)
+{
+    if (tokens < 0) {
+        tokens = burst;
+    } else {
+        tokens = qMin(burst, tokens + (nowMs - lastMs) * ratePerSecond / 1000.0);
+    }
+    lastMs = nowMs;
+    if (tokens < 1.0)
+        return false;
+    tokens -= 1.0;
+    return true;
+}
+
+QString ClientHandle::clientId() const
+{
+    return QString("client_%1").arg(key());
+}
+
+ClientHandle ClientHandle::fromClientId(const QString &clientId)
+{
+    bool ok = false;
+    const quint64 key = clientId.startsWith(QLatin1String("client_")) ? clientId.mid(7).toULongLong(&ok) : 0;
+    return ok ? fromKey(key) : ClientHandle();
+}
+
+ClientHandle ClientTable::insert(QTcpSocket *socket)
+{
+    const ClientHandle handle = allocate();
+    entries[handle.index].socket = socket;
+    return handle;
+}
+
+ClientHandle ClientTable::insert(int descriptor)
+{
+    const ClientHandle handle = allocate();
+    entries[handle.index].descriptor = descriptor;
+    return handle;
+}
+
+ClientHandle ClientTable::allocate()
+{
+    quint32 index;
+    if (!freeList.isEmpty()) {
+        index = freeList.takeLast();
+    } else {
+        index = quint32(entries.size());
+        entries.append(ClientSlot());
+    }
+
+    ++liveCount;
+    return ClientHandle{index, entries.at(index).generation};
+}
+
+void ClientTable::remove(ClientHandle handle)
+{
+    if (find(handle))
+        release(entries[handle.index], handle.index);
+}
+
+void ClientTable::clear()
+{
+    // Les générations sont conservées : aucune ancienne poignée ne redevient valide
+    for (int i = 0; i < entries.size(); ++i) {
+        if (entries.at(i).isLive())
+            release(entries[i], quint32(i));
+    }
+}
+
+void ClientTable::release(ClientSlot &slot, quint32 index)
+{
+    const quint32 nextGeneration = slot.generation + 1 == 0 ? 1 : slot.generation + 1;
+    slot = ClientSlot();
+    slot.generation = nextGeneration;
+    freeList.append(index);
+    --liveCount;
+}
+
+ClientSlot *ClientTable::find(ClientHandle handle)
+{
+    if (handle.index >= quint32(entries.size()))
+        return nullptr;
+    ClientSlot &slot = entries[handle.index];
+    return slot.isLive() && slot.generation == handle.generation ? &slot : nullptr;
+}
+
+const ClientSlot *ClientTable::find(ClientHandle handle) const
+{
+    if (handle.index >= quint32(entries.size()))
+        return nullptr;
+    const ClientSlot &slot = entries.at(handle.index);
+    return slot.isLive() && slot.generation == handle.generation ? &slot : nullptr;
+}
+
+int ClientTable::spectatorCount() const
+{
+    int count = 0;
+    forEach([&count](ClientHandle, const ClientSlot &slot) {
+        count += slot.spectator;
+    });
+    return count;
+}
@@ -0,0 +1,109 @@
+#ifndef CLIENTTABLE_H
+#define CLIENTTABLE_H
+
+#include <QByteArray>
+#include <QString>
+#include <QVector>
+#include "wirestrings.h"
+
+class QTcpSocket;
+
+// Seau à jetons (débit moyen + rafale), rempli paresseusement à chaque prise
+struct TokenBucket
+{
+    double tokens = -1.0;       // < 0 : plein au premier usage
+    qint64 lastMs = 0;
+
+    bool take(double ratePerSecond, double burst, qint64 nowMs);
+    void refund() { tokens += 1.0; }    // prise annulée juste après take()
+};
+
+// Poignée de session : index de case + génération. Une case libérée change
+// de génération, une poignée périmée est donc rejetée par une comparaison.
+struct ClientHandle
+{
+    quint32 index = 0;
+    quint32 generation = 0;     // 0 : poignée nulle
+
+    bool isNull() const { return generation == 0; }
+    quint64 key() const { return (quint64(generation) << 32) | index; }
+    // "client_<génération:index>" : jamais réattribué pendant la vie du serveur
+    QString clientId() const;
+    static ClientHandle fromClientId(const QString &clientId);
+    static ClientHandle fromKey(quint64 key) { return ClientHandle{quint32(key & 0xffffffffu), quint32(key >> 32)}; }
+};
+
+struct ClientSlot
+{
+    QTcpSocket *socket = nullptr;       // null, et descriptor < 0 : case libre
+    int descriptor = -1;                // backend io_uring : connexion tenue par UringTransport
+    quint32 generation = 1;
+    bool spectator = false;             // lecture seule : exclu du jeu et des broadcasts
+    bool compressed = false;            // a négocié FrameCodec via "hello"
+    bool interned = false;              // a négocié WireStrings via "hello" : trames compactes acceptées
+    bool throttled = false;             // trames en attente du seau de son adresse
+    QString address;
+    QString playerName;                 // annoncé par join_game / rejoin_game
+    QByteArray inbound;                 // trame en cours de réception
+    QByteArray outbound;                // spectateur lent : seule la dernière trame attend
+    WireStrings strings;                // noms définis par ses trames compactes
+    TokenBucket messages;
+
+    qint64 connectedAtMs = 0;
+    quint64 framesIn = 0;
+    quint64 framesOut = 0;
+    quint64 bytesIn = 0;
+    quint64 bytesOut = 0;
+
+    bool isLive() const { return socket || descriptor >= 0; }
+};
+
+// Sessions clientes de l'hôte dans un tableau contigu.
+//
+// Accès O(1) par poignée, cases libres réutilisées en pile. Les pointeurs
+// renvoyés par find() ne restent valables que jusqu'au prochain insert().
+class ClientTable
+{
+public:
+    ClientHandle insert(QTcpSocket *socket);
+    ClientHandle insert(int descriptor);
+    void remove(ClientHandle handle);
+    void clear();
+
+    ClientSlot *find(ClientHandle handle);
+    const ClientSlot *find(ClientHandle handle) const;
+
+    int size() const { return liveCount; }
+    int spectatorCount() const;
+
+    // Parcours des sessions vivantes : fn(ClientHandle, ClientSlot &)
+    template <typename Fn>
+    void forEach(Fn fn)
+    {
+        for (int i = 0; i < entries.size(); ++i) {
+            ClientSlot &slot = entries[i];
+            if (slot.isLive())
+                fn(ClientHandle{quint32(i), slot.generation}, slot);
+        }
+    }
+
+    template <typename Fn>
+    void forEach(Fn fn) const
+    {
+        for (int i = 0; i < entries.size(); ++i) {
+            const ClientSlot &slot = entries.at(i);
+            if (slot.isLive())
+                fn(ClientHandle{quint32(i), slot.generation}, slot);
+        }
+    }
+
+private:
+    ClientHandle allocate();
+    void release(ClientSlot &slot, quint32 index);
+
+    QVector<ClientSlot> entries;
+    QVector<quint32> freeList;
+    int liveCount = 0;
+};
+
+#endif // CLIENTTABLE_H
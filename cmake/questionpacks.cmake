@@ -0,0 +1,189 @@
+# Génère les tables constexpr des packs de questions intégrés.
+#
+#   cmake -DOUTPUT=<en-tête> -DPACKS=<fichier>[;<fichier>...] -P questionpacks.cmake
+#
+# Un pack par fichier, dans l'ordre de l'énumération Game::Theme :
+#   .json : tableau de {"question": "...", "answers": ["", "", "", ""], "correct": 0..3}
+#   .csv  : question;réponse 1;réponse 2;réponse 3;réponse 4;indice correct
+#           (séparateur ';', sans guillemets, première ligne = en-tête, '#' = commentaire)
+#
+# Toute entrée invalide arrête la génération, donc la compilation.
+
+cmake_minimum_required(VERSION 3.19)
+
+if(NOT OUTPUT OR NOT PACKS)
+    message(FATAL_ERROR "questionpacks.cmake : OUTPUT et PACKS sont requis")
+endif()
+
+function(pack_literal out value)
+    string(REPLACE "\\" "\\\\" value "${value}")
+    string(REPLACE "\"" "\\\"" value "${value}")
+    string(REPLACE "\n" "\\n" value "${value}")
+    set(${out} "packString(u\"${value}\")" PARENT_SCOPE)
+endfunction()
+
+# Valide une entrée et l'ajoute à la variable ENTRIES de l'appelant
+function(pack_entry where question a0 a1 a2 a3 correct)
+    string(STRIP "${question}" question)
+    if(question STREQUAL "")
+        message(FATAL_ERROR "${where} : question vide")
+    endif()
+
+    # Concaténation de chaînes plutôt que list() : le texte peut contenir des ';'
+    set(answers "")
+    foreach(index RANGE 3)
+        string(STRIP "${a${index}}" answer)
+        if(answer STREQUAL "")
+            message(FATAL_ERROR "${where} : réponse ${index} vide")
+        endif()
+        pack_literal(literal "${answer}")
+        if(index GREATER 0)
+            string(APPEND answers ", ")
+        endif()
+        string(APPEND answers "${literal}")
+    endforeach()
+
+    string(STRIP "${correct}" correct)
+    if(NOT correct MATCHES "^[0-3]$")
+        message(FATAL_ERROR "${where} : indice de bonne réponse invalide (${correct}), attendu 0 à 3")
+    endif()
+
+    pack_literal(text "${question}")
+    set(ENTRIES "${ENTRIES}    { ${text}, { ${answers} }, ${correct} },\n" PARENT_SCOPE)
+endfunction()
+
+function(pack_read_json file)
+    file(READ "${file}" json)
+    string(JSON type ERROR_VARIABLE error TYPE "${json}")
+    if(error OR NOT type STREQUAL "ARRAY")
+        message(FATAL_ERROR "${file} : un tableau JSON est attendu ${error}")
+    endif()
+
+    string(JSON count LENGTH "${json}")
+    if(count EQUAL 0)
+        message(FATAL_ERROR "${file} : pack vide")
+    endif()
+    set(ENTRIES "")
+    math(EXPR last "${count} - 1")
+    foreach(i RANGE ${last})
+        math(EXPR number "${i} + 1")
+        set(where "${file} : entrée ${number}")
+
+        string(JSON type ERROR_VARIABLE error TYPE "${json}" ${i} question)
+        if(error OR NOT type STREQUAL "STRING")
+            message(FATAL_ERROR "${where} : champ \"question\" manquant ou non textuel")
+        endif()
+        string(JSON question GET "${json}" ${i} question)
+
+        string(JSON type ERROR_VARIABLE error TYPE "${json}" ${i} answers)
+        if(error OR NOT type STREQUAL "ARRAY")
+            message(FATAL_ERROR "${where} : champ \"answers\" manquant ou non tableau")
+        endif()
+        string(JSON answerCount LENGTH "${json}" ${i} answers)
+        if(NOT answerCount EQUAL 4)
+            message(FATAL_ERROR "${where} : 4 réponses attendues, ${answerCount} trouvées")
+        endif()
+        foreach(a RANGE 3)
+            string(JSON type TYPE "${json}" ${i} answers ${a})
+            if(NOT type STREQUAL "STRING")
+                message(FATAL_ERROR "${where} : la réponse ${a} n'est pas du texte")
+            endif()
+            string(JSON answer${a} GET "${json}" ${i} answers ${a})
+        endforeach()
+
+        string(JSON type ERROR_VARIABLE error TYPE "${json}" ${i} correct)
+        if(error OR NOT type STREQUAL "NUMBER")
+            message(FATAL_ERROR "${where} : champ \"correct\" manquant ou non numérique")
+        endif()
+        string(JSON correct GET "${json}" ${i} correct)
+
+        pack_entry("${where}" "${question}" "${answer0}" "${answer1}" "${answer2}" "${answer3}" "${correct}")
+    endforeach()
+    set(ENTRIES "${ENTRIES}" PARENT_SCOPE)
+endfunction()
+
+function(pack_read_csv file)
+    # Les ';' du fichier sont remplacés par un séparateur neutre avant le
+    # découpage en lignes (les listes CMake utilisent déjà ';')
+    string(ASCII 31 separator)
+    file(READ "${file}" content)
+    string(REPLACE "\r" "" content "${content}")
+    string(REPLACE ";" "${separator}" content "${content}")
+    string(REPLACE "\n" ";" lines "${content}")
+
+    set(ENTRIES "")
+    set(lineNumber 0)
+    set(header TRUE)
+    foreach(line IN LISTS lines)
+        math(EXPR lineNumber "${lineNumber} + 1")
+        string(STRIP "${line}" stripped)
+        if(stripped STREQUAL "" OR stripped MATCHES "^#")
+            continue()
+        endif()
+        if(header)
+            set(header FALSE)
+            continue()
+        endif()
+
+        string(REPLACE "${separator}" ";" fields "${line}")
+        list(LENGTH fields fieldCount)
+        if(NOT fieldCount EQUAL 6)
+            message(FATAL_ERROR "${file} : ligne ${lineNumber} : 6 champs attendus, ${fieldCount} trouvés")
+        endif()
+        list(GET fields 0 question)
+        list(GET fields 1 answer0)
+        list(GET fields 2 answer1)
+        list(GET fields 3 answer2)
+        list(GET fields 4 answer3)
+        list(GET fields 5 correct)
+        pack_entry("${file} : ligne ${lineNumber}" "${question}" "${answer0}" "${answer1}" "${answer2}" "${answer3}" "${correct}")
+    endforeach()
+    set(ENTRIES "${ENTRIES}" PARENT_SCOPE)
+endfunction()
+
+set(body "")
+set(packTable "")
+foreach(file IN LISTS PACKS)
+    get_filename_component(extension "${file}" LAST_EXT)
+    string(TOLOWER "${extension}" extension)
+    if(extension STREQUAL ".json")
+        pack_read_json("${file}")
+    elseif(extension STREQUAL ".csv")
+        pack_read_csv("${file}")
+    else()
+        message(FATAL_ERROR "${file} : format non pris en charge (.json ou .csv)")
+    endif()
+
+    if(ENTRIES STREQUAL "")
+        message(FATAL_ERROR "${file} : pack vide")
+    endif()
+
+    get_filename_component(fileName "${file}" NAME)
+    get_filename_component(name "${file}" NAME_WE)
+    string(MAKE_C_IDENTIFIER "${name}" name)
+    set(body "${body}// ${fileName}\ninline constexpr QuestionPackEntry questionPack_${name}[] = {\n${ENTRIES}};\n\n")
+    set(packTable "${packTable}    { questionPack_${name}, int(std::size(questionPack_${name})) },\n")
+endforeach()
+
+set(content "// Généré par cmake/questionpacks.cmake à partir des fichiers de questions : ne pas modifier.
+#ifndef QUESTIONPACKS_DATA_H
+#define QUESTIONPACKS_DATA_H
+
+#include <iterator>
+#include \"questionpack.h\"
+
+${body}// Dans l'ordre de Game::Theme
+inline constexpr QuestionPack builtinQuestionPacks[] = {
+${packTable}};
+
+#endif // QUESTIONPACKS_DATA_H
+")
+
+# Réécrit seulement si le contenu change (évite de tout recompiler)
+set(previous "")
+if(EXISTS "${OUTPUT}")
+    file(READ "${OUTPUT}" previous)
+endif()
+if(NOT previous STREQUAL content)
+    file(WRITE "${OUTPUT}" "${content}")
+endif()
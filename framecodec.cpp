@@ -0,0 +1,112 @@
+#include "framecodec.h"
+#include "game.h"
+#include <QtEndian>
+#include <zlib.h>
+
+static const int DICTIONARY_LIMIT = 32 * 1024;   // fenêtre deflate
+
+const char *FrameCodec::codecName()
+{
+    return "deflate-dict";
+}
+
+const QByteArray &FrameCodec::dictionary()
+{
+    // Construit une fois, identique des deux côtés pour une même version :
+    // la banque de questions d'abord, puis les fragments de messages les plus
+    // fréquents en fin de dictionnaire (distances les plus courtes pour deflate).
+    static const QByteArray dict = []() {
+        QByteArray corpus;
+        for (Game::Theme theme : {Game::SCIENCE, Game::SPORT, Game::CULTURE}) {
+            for (const Question &question : Game::getQuestionsForTheme(theme)) {
+                corpus += question.getQuestionText().toUtf8();
+                for (const QString &answer : question.getAnswers())
+                    corpus += "\"" + answer.toUtf8() + "\",";
+            }
+        }
+
+        static const char *const fragments[] = {
+            "{\"data\":{\"gameCode\":\"", "\"spectator_state\"", "\"leaderboard\":[",
+            "\"histogram\":[", "\"secondsLeft\":", "\"questionIndex\":", "\"totalQuestions\":",
+            "\"answers\":[\"", "\"question\":\"", "\"correctAnswer\":", "\"players\":",
+            "\"state\":", "\"theme\":", "\"setup_game\"", "\"start_game\"", "\"next_question\"",
+            "\"join_game\"", "\"answer\":", "\"score\":", "},\"sender\":\"", "\"type\":\"answer\"}",
+            "{\"playerName\":\"", "\"},{\"playerName\":\"",
+        };
+        for (const char *fragment : fragments)
+            corpus += fragment;
+
+        return corpus.right(DICTIONARY_LIMIT);
+    }();
+    return dict;
+}
+
+quint32 FrameCodec::dictionaryId()
+{
+    static const quint32 id = quint32(adler32(adler32(0L, Z_NULL, 0),
+                                              reinterpret_cast<const Bytef *>(dictionary().constData()),
+                                              uInt(dictionary().size())));
+    return id;
+}
+
+QByteArray FrameCodec::compressFrame(const QByteArray &payload)
+{
+    z_stream stream = {};
+    if (deflateInit2(&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+        return QByteArray();
+
+    const QByteArray &dict = dictionary();
+    deflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dict.constData()), uInt(dict.size()));
+
+    QByteArray frame(HEADER_SIZE + int(deflateBound(&stream, uLong(payload.size()))), Qt::Uninitialized);
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(payload.constData()));
+    stream.avail_in = uInt(payload.size());
+    stream.next_out = reinterpret_cast<Bytef *>(frame.data() + HEADER_SIZE);
+    stream.avail_out = uInt(frame.size() - HEADER_SIZE);
+
+    const int result = deflate(&stream, Z_FINISH);
+    const quint32 bodySize = quint32(stream.total_out);
+    deflateEnd(&stream);
+    if (result != Z_STREAM_END)
+        return QByteArray();
+
+    frame[0] = COMPRESSED_MARKER;
+    qToBigEndian(bodySize, frame.data() + 1);
+    frame.truncate(HEADER_SIZE + int(bodySize));
+    return frame;
+}
+
+bool FrameCodec::decompress(const QByteArray &body, QByteArray *payload, int maxSize)
+{
+    z_stream stream = {};
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+
+    const QByteArray &dict = dictionary();
+    inflateSetDictionary(&stream, reinterpret_cast<const Bytef *>(dict.constData()), uInt(dict.size()));
+
+    stream.next_in = reinterpret_cast<Bytef *>(const_cast<char *>(body.constData()));
+    stream.avail_in = uInt(body.size());
+
+    QByteArray out(qMin<qsizetype>(qMax<qsizetype>(body.size() * 4, 1024), maxSize), Qt::Uninitialized);
+    int result = Z_OK;
+    while (result == Z_OK) {
+        if (qsizetype(stream.total_out) == out.size()) {
+            if (out.size() >= maxSize)
+                break;
+            out.resize(qMin<qsizetype>(out.size() * 2, maxSize));
+        }
+        stream.next_out = reinterpret_cast<Bytef *>(out.data() + stream.total_out);
+        stream.avail_out = uInt(out.size() - qsizetype(stream.total_out));
+        result = inflate(&stream, Z_NO_FLUSH);
+    }
+
+    const int produced = int(stream.total_out);
+    inflateEnd(&stream);
+    if (result != Z_STREAM_END)
+        return false;
+
+    out.truncate(produced);
+    *payload = out;
+    return true;
+}
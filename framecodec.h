@@ -0,0 +1,31 @@
+#ifndef FRAMECODEC_H
+#define FRAMECODEC_H
+
+#include <QByteArray>
+
+// Compression des trames (deflate brut + dictionnaire prédéfini).
+//
+// Une trame texte est "JSON\n". Une trame compressée commence par
+// COMPRESSED_MARKER, suivi de la longueur (uint32 big-endian) puis des
+// données deflate ; un JSON ne commence jamais par ce caractère.
+class FrameCodec
+{
+public:
+    static constexpr char COMPRESSED_MARKER = '\x01';
+    static constexpr int HEADER_SIZE = 5;
+    static constexpr int COMPRESSION_THRESHOLD = 512;       // en dessous, on envoie en clair
+    static constexpr int MAX_DECOMPRESSED_SIZE = 4 * 1024 * 1024;
+
+    static const char *codecName();
+    static quint32 dictionaryId();
+
+    // payload = JSON sans terminateur ; renvoie la trame complète (en-tête inclus)
+    static QByteArray compressFrame(const QByteArray &payload);
+    // body = données deflate sans en-tête ; échoue au-delà de maxSize octets décompressés
+    static bool decompress(const QByteArray &body, QByteArray *payload, int maxSize = MAX_DECOMPRESSED_SIZE);
+
+private:
+    static const QByteArray &dictionary();
+};
+
+#endif // FRAMECODEC_H
@@ -0,0 +1,372 @@
+#include "framereader.h"
+#include "wirestrings.h"
+#include <QtAlgorithms>
+#include <climits>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64)
+#include <emmintrin.h>
+#define QUIZZ_SCAN_SSE2
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define QUIZZ_SCAN_NEON
+#endif
+
+static constexpr int MAX_DEPTH = 64;        // imbrication au-delà de laquelle on renonce
+
+// Premier octet égal à a ou à b (ou de contrôle, < 0x20, si controls), -1 sinon
+static qsizetype findEither(const char *data, qsizetype size, char a, char b, bool controls = false)
+{
+    qsizetype i = 0;
+#if defined(QUIZZ_SCAN_SSE2)
+    const __m128i wantA = _mm_set1_epi8(a);
+    const __m128i wantB = _mm_set1_epi8(b);
+    const __m128i lastControl = _mm_set1_epi8(controls ? 0x1f : 0);
+    for (; i + 16 <= size; i += 16) {
+        const __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i match = _mm_or_si128(_mm_cmpeq_epi8(chunk, wantA), _mm_cmpeq_epi8(chunk, wantB));
+        if (controls)   // octet <= 0x1f (non signé) : min(octet, 0x1f) == octet
+            match = _mm_or_si128(match, _mm_cmpeq_epi8(_mm_min_epu8(chunk, lastControl), chunk));
+        const int mask = _mm_movemask_epi8(match);
+        if (mask)
+            return i + qCountTrailingZeroBits(quint32(mask));
+    }
+#elif defined(QUIZZ_SCAN_NEON)
+    const uint8x16_t wantA = vdupq_n_u8(quint8(a));
+    const uint8x16_t wantB = vdupq_n_u8(quint8(b));
+    const uint8x16_t firstPrintable = vdupq_n_u8(controls ? 0x20 : 0);
+    for (; i + 16 <= size; i += 16) {
+        const uint8x16_t chunk = vld1q_u8(reinterpret_cast<const quint8 *>(data + i));
+        const uint8x16_t match = vorrq_u8(vorrq_u8(vceqq_u8(chunk, wantA), vceqq_u8(chunk, wantB)),
+                                          vcltq_u8(chunk, firstPrintable));
+        // Pas de movemask en NEON : 4 bits par octet après le décalage-rétrécissement
+        const quint64 mask = vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(match), 4)), 0);
+        if (mask)
+            return i + qCountTrailingZeroBits(mask) / 4;
+    }
+#endif
+    for (; i < size; ++i) {
+        if (data[i] == a || data[i] == b || (controls && quint8(data[i]) < 0x20))
+            return i;
+    }
+    return -1;
+}
+
+// Clé de data : son nom, ou son numéro dans la table de WireStrings (trame compacte)
+static bool isKey(QByteArrayView key, const char *name, int id, bool compact)
+{
+    if (!compact)
+        return key == QByteArrayView(name, qsizetype(std::strlen(name)));
+    if (key.isEmpty() || key.size() > 3)
+        return false;
+    int value = 0;
+    for (char c : key) {
+        if (c < '0' || c > '9')
+            return false;
+        value = value * 10 + (c - '0');
+    }
+    return value == id;
+}
+
+static bool isHexDigit(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'f') || (c >= 'A' && c <= 'F');
+}
+
+qsizetype FrameReader::findTerminator(const char *data, qsizetype size)
+{
+    return findEither(data, size, '\n', '\n');
+}
+
+namespace {
+
+// Curseur sur le JSON : chaque méthode avance au-delà de ce qu'elle a lu
+struct Cursor
+{
+    const char *p;
+    const char *end;
+
+    void skipSpace()
+    {
+        while (p < end && (*p == ' ' || *p == '\n' || *p == '\r' || *p == '\t'))
+            ++p;
+    }
+
+    bool at(char c)
+    {
+        skipSpace();
+        return p < end && *p == c;
+    }
+
+    bool atNumber()
+    {
+        skipSpace();
+        return p < end && (*p == '-' || (*p >= '0' && *p <= '9'));
+    }
+
+    bool consume(char c)
+    {
+        if (!at(c))
+            return false;
+        ++p;
+        return true;
+    }
+
+    // Chaîne sous le curseur ; raw = contenu brut entre les guillemets
+    bool string(QByteArrayView *raw, bool *escaped)
+    {
+        if (!consume('"'))
+            return false;
+        const char *start = p;
+        *escaped = false;
+        for (;;) {
+            const qsizetype i = findEither(p, end - p, '"', '\\', true);
+            if (i < 0)
+                return false;
+            p += i;
+            if (*p == '"')
+                break;
+            if (*p != '\\' || ++p == end)    // caractère de contrôle brut, ou barre finale
+                return false;
+            *escaped = true;
+            if (*p == 'u') {
+                if (end - p < 5 || !isHexDigit(p[1]) || !isHexDigit(p[2]) || !isHexDigit(p[3]) || !isHexDigit(p[4]))
+                    return false;
+                p += 5;
+            } else if (*p && std::strchr("\"\\/bfnrt", *p)) {
+                ++p;
+            } else {
+                return false;
+            }
+        }
+        *raw = QByteArrayView(start, p - start);
+        ++p;
+        return true;
+    }
+
+    bool literal(const char *word)
+    {
+        const qsizetype size = qsizetype(std::strlen(word));
+        if (end - p < size || std::memcmp(p, word, size_t(size)) != 0)
+            return false;
+        p += size;
+        return true;
+    }
+
+    // Nombre JSON ; isInt et value seulement pour un entier qui tient dans un int
+    bool number(int *value, bool *isInt)
+    {
+        skipSpace();
+        const bool negative = p < end && *p == '-';
+        if (negative)
+            ++p;
+        if (p >= end || *p < '0' || *p > '9')
+            return false;
+        qint64 magnitude = 0;
+        bool fits = true;
+        if (*p == '0') {
+            ++p;
+        } else {
+            while (p < end && *p >= '0' && *p <= '9') {
+                magnitude = magnitude * 10 + (*p++ - '0');
+                if (magnitude > qint64(INT_MAX) + 1) {
+                    fits = false;
+                    magnitude = 0;
+                }
+            }
+        }
+        bool integral = true;
+        if (p < end && *p == '.') {
+            integral = false;
+            ++p;
+            if (p >= end || *p < '0' || *p > '9')
+                return false;
+            while (p < end && *p >= '0' && *p <= '9')
+                ++p;
+        }
+        if (p < end && (*p == 'e' || *p == 'E')) {
+            integral = false;
+            ++p;
+            if (p < end && (*p == '+' || *p == '-'))
+                ++p;
+            if (p >= end || *p < '0' || *p > '9')
+                return false;
+            while (p < end && *p >= '0' && *p <= '9')
+                ++p;
+        }
+        const qint64 signedValue = negative ? -magnitude : magnitude;
+        *isInt = integral && fits && signedValue >= INT_MIN && signedValue <= INT_MAX;
+        if (*isInt)
+            *value = int(signedValue);
+        return true;
+    }
+
+    // Valide et saute une valeur quelconque
+    bool skipValue(int depth)
+    {
+        if (depth > MAX_DEPTH)
+            return false;
+        skipSpace();
+        if (p >= end)
+            return false;
+
+        QByteArrayView raw;
+        bool escaped = false;
+        switch (*p) {
+        case '"':
+            return string(&raw, &escaped);
+        case '{':
+            ++p;
+            if (consume('}'))
+                return true;
+            do {
+                if (!string(&raw, &escaped) || !consume(':') || !skipValue(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume('}');
+        case '[':
+            ++p;
+            if (consume(']'))
+                return true;
+            do {
+                if (!skipValue(depth + 1))
+                    return false;
+            } while (consume(','));
+            return consume(']');
+        case 't':
+            return literal("true");
+        case 'f':
+            return literal("false");
+        case 'n':
+            return literal("null");
+        default: {
+            int value = 0;
+            bool isInt = false;
+            return number(&value, &isInt);
+        }
+        }
+    }
+
+    // Objet "data" : on n'en retient que playerName et answer
+    bool readData(FrameReader::Fields *fields, bool compact)
+    {
+        if (!consume('{'))
+            return false;
+        if (consume('}'))
+            return true;
+        do {
+            QByteArrayView key;
+            bool escaped = false;
+            if (!string(&key, &escaped) || !consume(':'))
+                return false;
+            // Clé répétée : la dernière l'emporte, comme pour QJsonObject
+            if (!escaped && isKey(key, "playerName", WireStrings::PLAYER_NAME, compact)) {
+                fields->hasPlayerName = false;
+                fields->playerNameId = -1;
+                if (at('"')) {
+                    bool nameEscaped = false;
+                    if (!string(&fields->playerName, &nameEscaped))
+                        return false;
+                    fields->hasPlayerName = !nameEscaped && !compact;
+                    fields->definesName = fields->definesName || compact;
+                    continue;
+                }
+                if (compact && atNumber()) {
+                    bool isInt = false;
+                    if (!number(&fields->playerNameId, &isInt))
+                        return false;
+                    if (!isInt)
+                        fields->playerNameId = -1;
+                    continue;
+                }
+            } else if (!escaped && isKey(key, "answer", WireStrings::ANSWER, compact)) {
+                fields->hasAnswer = false;
+                if (atNumber()) {
+                    if (!number(&fields->answer, &fields->hasAnswer))
+                        return false;
+                    continue;
+                }
+            }
+            if (!skipValue(1))
+                return false;
+        } while (consume(','));
+        return consume('}');
+    }
+
+    // Trame compacte : [type, sender, data]
+    bool readCompact(FrameReader::Fields *fields)
+    {
+        if (!consume('['))
+            return false;
+        bool escaped = false;
+        bool isInt = false;
+        if (atNumber()) {
+            if (!number(&fields->typeId, &isInt))
+                return false;
+            if (!isInt)
+                fields->typeId = -1;
+        } else if (!string(&fields->type, &escaped) || escaped) {
+            return false;
+        }
+
+        if (!consume(','))
+            return false;
+        if (at('"')) {
+            QByteArrayView sender;
+            if (!string(&sender, &escaped))
+                return false;
+            fields->definesName = true;
+        } else if (atNumber()) {
+            if (!number(&fields->senderId, &isInt))
+                return false;
+            if (!isInt)
+                fields->senderId = -1;
+        } else {
+            return false;
+        }
+
+        if (consume(',') && !readData(fields, true))
+            return false;
+        return consume(']');
+    }
+};
+
+} // namespace
+
+bool FrameReader::read(QByteArrayView frame, Fields *fields)
+{
+    *fields = Fields();
+    Cursor cursor{frame.data(), frame.data() + frame.size()};
+
+    if (cursor.at('[')) {
+        fields->compact = true;
+        if (!cursor.readCompact(fields))
+            return false;
+    } else if (!cursor.consume('{')) {
+        return false;
+    } else if (!cursor.consume('}')) {
+        do {
+            QByteArrayView key;
+            bool escaped = false;
+            if (!cursor.string(&key, &escaped) || !cursor.consume(':'))
+                return false;
+            if (!escaped && key == QByteArrayView("type") && cursor.at('"')) {
+                bool typeEscaped = false;
+                if (!cursor.string(&fields->type, &typeEscaped) || typeEscaped)
+                    return false;
+            } else if (!escaped && key == QByteArrayView("data") && cursor.at('{')) {
+                if (!cursor.readData(fields, false))
+                    return false;
+            } else {
+                if (!escaped && key == QByteArrayView("type"))
+                    fields->type = QByteArrayView();
+                if (!cursor.skipValue(0))
+                    return false;
+            }
+        } while (cursor.consume(','));
+        if (!cursor.consume('}'))
+            return false;
+    }
+    cursor.skipSpace();
+    return cursor.p == cursor.end;
+}
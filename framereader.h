@@ -0,0 +1,38 @@
+#ifndef FRAMEREADER_H
+#define FRAMEREADER_H
+
+#include <QByteArray>
+
+// Lecture des trames entrantes sans passer par QJsonDocument.
+//
+// findTerminator() cherche la fin de trame 16 octets à la fois (SSE2 ou
+// NEON, boucle simple sinon). read() parcourt le JSON une seule fois, sur
+// place, et n'en garde que les champs des messages fréquents ; le reste est
+// validé puis sauté. Les vues renvoyées pointent dans la trame lue.
+class FrameReader
+{
+public:
+    struct Fields
+    {
+        QByteArrayView type;
+        QByteArrayView playerName;          // data.playerName, seulement sans séquence d'échappement
+        int answer = 0;                     // data.answer, seulement entier
+        bool hasPlayerName = false;
+        bool hasAnswer = false;
+
+        // Trame compacte (wirestrings.h) : numéros à la place des chaînes
+        bool compact = false;
+        int typeId = -1;
+        int senderId = -1;
+        int playerNameId = -1;
+        bool definesName = false;           // un nom passe en clair : à décoder par WireStrings
+    };
+
+    // Position du premier '\n', -1 s'il n'y en a pas
+    static qsizetype findTerminator(const char *data, qsizetype size);
+
+    // false : JSON invalide, ni objet ni trame compacte, ou "type" échappé (QJsonDocument tranchera)
+    static bool read(QByteArrayView frame, Fields *fields);
+};
+
+#endif // FRAMEREADER_H
@@ -1,30 +1,39 @@
 #include "game.h"
+#include "questionpacks_data.h"
 #include <QRandomGenerator>
 #include <QDebug>
 
-Game::Game(QObject *parent)
-    : QObject(parent), currentQuestionIndex(0), state(WAITING), isHost(false)
+Game::Game(QObject *parent, GameClock *gameClock)
+    : QObject(parent), clock(gameClock ? gameClock : new SystemClock(this)), waker(clock), questionStartMs(0),
+      resultsRequested(false), advanceRequested(false), flowRun(0),
+      currentQuestionIndex(0), state(WAITING), isHost(false), questionStore(nullptr)
 {
-    questionTimer = new QTimer(this);
-    questionTimer->setSingleShot(true);
-    connect(questionTimer, &QTimer::timeout, this, &Game::onTimeUp);
 }
 
 Game::~Game()
 {
-    questionTimer->stop();
+    stopFlow();
 }
 
 void Game::createGame(Theme theme)
 {
+    stopFlow();
     selectedTheme = theme;
     gameCode = generateGameCode();
-    questions = getQuestionsForTheme(theme);
+    if (questionStore) {
+        // Version de la banque figée pour toute la partie, même si elle est rechargée entre-temps
+        questionSnapshot = questionStore->snapshot();
+        questions = questionSnapshot.questionsForTheme(theme);
+    } else {
+        questions = getQuestionsForTheme(theme);
+    }
     currentQuestionIndex = 0;
     state = WAITING;
     isHost = true;
     playerScores.clear();
+    teams.clear();
     currentAnswers.clear();
+    currentAnswerTimes.clear();
     
     emit gameCreated(gameCode);
 }
@@ -40,10 +49,11 @@ void Game::joinGame(const QString& code)
     isHost = false;
 }
 
-void Game::addPlayer(const QString& playerName)
+void Game::addPlayer(const QString& playerName, const QString& team)
 {
     if (!playerScores.contains(playerName)) {
         playerScores[playerName] = 0;
+        teams.addMember(playerName, team);
         emit playerJoined(playerName);
     }
 }
@@ -52,7 +62,13 @@ void Game::removePlayer(const QString& playerName)
 {
     if (playerScores.contains(playerName)) {
         playerScores.remove(playerName);
+        teams.removeMember(playerName);
+        auto answer = currentAnswers.constFind(playerName);
+        if (answer != currentAnswers.constEnd() && answer.value() >= 0 && answer.value() < answerCounts.size()) {
+            answerCounts[answer.value()]--;
+        }
         currentAnswers.remove(playerName);
+        currentAnswerTimes.remove(playerName);
         emit playerLeft(playerName);
     }
 }
@@ -67,16 +83,20 @@ Game::Theme Game::getSelectedTheme() const
     return selectedTheme;
 }
 
-void Game::setupClientGame(Theme theme)
+void Game::setupClientGame(Theme theme, const QVector<Question>& hostQuestions)
 {
+    // Les questions viennent de l'hôte : sa banque a pu être rechargée
+    stopFlow();
     selectedTheme        = theme;
-    questions            = getQuestionsForTheme(theme);
+    questions            = hostQuestions.isEmpty() ? getQuestionsForTheme(theme) : hostQuestions;
     currentQuestionIndex = 0;
     state                = WAITING;
     isHost               = false;
 
     playerScores.clear();
+    teams.clear();
     currentAnswers.clear();
+    currentAnswerTimes.clear();
 }
 
 void Game::startGame()
@@ -85,65 +105,92 @@ void Game::startGame()
         return;
     }
     
+    stopFlow();
     currentQuestionIndex = 0;
     state = QUESTION_ACTIVE;
-    currentAnswers.clear();
     
     emit gameStarted();
-    emit questionChanged(questions[currentQuestionIndex]);
-    
-    // Start 10-second timer
-    questionTimer->start(10000);
-    
-    // Emit timer updates
-    QTimer* updateTimer = new QTimer(this);
-    updateTimer->setInterval(1000);
-    int secondsLeft = 10;
-    
-    connect(updateTimer, &QTimer::timeout, [this, updateTimer, &secondsLeft]() mutable {
-        secondsLeft--;
-        emit timeUpdate(secondsLeft);
-        if (secondsLeft <= 0) {
-            updateTimer->stop();
-            updateTimer->deleteLater();
-        }
-    });
-    
-    updateTimer->start();
+    flow = playRounds(false);
 }
 
 void Game::nextQuestion()
 {
-    currentQuestionIndex++;
-    
-    if (currentQuestionIndex >= questions.size()) {
-        endGame();
+    if (state == QUESTION_ACTIVE || state == SHOWING_RESULTS) {
+        advanceRequested = true;
+        waker.notify();
         return;
     }
     
-    state = QUESTION_ACTIVE;
-    currentAnswers.clear();
-    
-    emit questionChanged(questions[currentQuestionIndex]);
-    
-    // Start 10-second timer
-    questionTimer->start(10000);
-    
-    // Timer updates
-    QTimer* updateTimer = new QTimer(this);
-    updateTimer->setInterval(1000);
-    int secondsLeft = 10;
+    // Pas de déroulé en cours (début de partie manqué) : il part de la question suivante
+    stopFlow();
+    currentQuestionIndex++;
+    flow = playRounds(false);
+}
+
+RoomTask Game::playRounds(bool resumeAtResults, qint64 elapsedMs)
+{
+    // Un slot connecté à nos signaux peut relancer ou abandonner la partie :
+    // ce déroulé s'arrête alors sans toucher à la suite
+    const quint64 run = ++flowRun;
+    auto superseded = [this, run]() { return run != flowRun; };
     
-    connect(updateTimer, &QTimer::timeout, [this, updateTimer, &secondsLeft]() mutable {
-        secondsLeft--;
-        emit timeUpdate(secondsLeft);
-        if (secondsLeft <= 0) {
-            updateTimer->stop();
-            updateTimer->deleteLater();
+    for (; currentQuestionIndex < questions.size(); ++currentQuestionIndex) {
+        if (!resumeAtResults) {
+            state = QUESTION_ACTIVE;
+            resultsRequested = false;
+            resetAnswers();
+            // Reprise en cours de question : le début est antidaté
+            questionStartMs = clock->nowMs() - elapsedMs;
+            int secondsLeft = QUESTION_SECONDS - int(elapsedMs / 1000);
+            elapsedMs = 0;
+            emit questionChanged(questions[currentQuestionIndex]);
+            if (superseded()) {
+                co_return;
+            }
+            if (secondsLeft < QUESTION_SECONDS) {
+                emit timeUpdate(secondsLeft);
+                if (superseded()) {
+                    co_return;
+                }
+            }
+            
+            // Une échéance par seconde, calée sur le début de la question : pas de dérive cumulée
+            while (secondsLeft > 0 && !resultsRequested && !advanceRequested) {
+                const qint64 due = questionStartMs + qint64(QUESTION_SECONDS - secondsLeft + 1) * 1000;
+                if (co_await waker.until(due) == RoomWaker::DEADLINE) {
+                    emit timeUpdate(--secondsLeft);
+                    if (superseded()) {
+                        co_return;
+                    }
+                }
+            }
+            
+            // nextQuestion() avant la fin du chrono : question suivante sans résultats
+            if (!advanceRequested) {
+                publishResults();
+                if (superseded()) {
+                    co_return;
+                }
+            }
+        }
+        resumeAtResults = false;
+        
+        while (!advanceRequested) {
+            co_await waker.event();
         }
-    });
+        advanceRequested = false;
+    }
     
-    updateTimer->start();
+    finishGame();
+}
+
+void Game::stopFlow()
+{
+    ++flowRun;
+    waker.cancel();
+    flow.reset();
+    resultsRequested = false;
+    advanceRequested = false;
 }
 
 void Game::submitAnswer(const QString& playerName, int answerIndex)
@@ -152,16 +199,32 @@ void Game::submitAnswer(const QString& playerName, int answerIndex)
         return;
     }
     
+    auto previous = currentAnswers.constFind(playerName);
+    if (previous != currentAnswers.constEnd() && previous.value() >= 0 && previous.value() < answerCounts.size()) {
+        answerCounts[previous.value()]--;
+    }
+    if (answerIndex >= 0 && answerIndex < answerCounts.size()) {
+        answerCounts[answerIndex]++;
+    }
+    
     currentAnswers[playerName] = answerIndex;
+    currentAnswerTimes[playerName] = clock->nowMs() - questionStartMs;
     emit answerSubmitted(playerName, answerIndex);
     
     checkAllAnswersReceived();
 }
 
 void Game::showResults()
+{
+    if (state == QUESTION_ACTIVE) {
+        resultsRequested = true;
+        waker.notify();
+    }
+}
+
+void Game::publishResults()
 {
     state = SHOWING_RESULTS;
-    questionTimer->stop();
     
     QMap<QString, bool> results;
     Question currentQ = questions[currentQuestionIndex];
@@ -178,6 +241,10 @@ void Game::showResults()
                 playerScores[playerName]++;
             }
         }
+        // Équipe créditée réponse par réponse : O(1), sans reparcourir ses membres
+        if (isHost) {
+            teams.credit(playerName, isCorrect);
+        }
         
         results[playerName] = isCorrect;
     }
@@ -186,12 +253,30 @@ void Game::showResults()
 }
 
 void Game::endGame()
+{
+    stopFlow();
+    finishGame();
+}
+
+void Game::finishGame()
 {
     state = GAME_FINISHED;
-    questionTimer->stop();
     
     QString winner = getWinner();
     emit gameEnded(winner);
+    questionSnapshot = QuestionStore::Snapshot();
+}
+
+void Game::abortGame()
+{
+    // Abandon silencieux (retour au menu) : pas de gameEnded
+    stopFlow();
+    state = WAITING;
+    questionSnapshot = QuestionStore::Snapshot();
+    playerScores.clear();
+    teams.clear();
+    currentAnswers.clear();
+    currentAnswerTimes.clear();
 }
 
 Question Game::getCurrentQuestion() const
@@ -207,6 +292,73 @@ int Game::getCurrentQuestionIndex() const
     return currentQuestionIndex;
 }
 
+QVector<Question> Game::getQuestions() const
+{
+    return questions;
+}
+
+qint64 Game::questionRemainingMs() const
+{
+    if (state != QUESTION_ACTIVE) {
+        return 0;
+    }
+    return qMax(qint64(0), questionStartMs + qint64(QUESTION_SECONDS) * 1000 - clock->nowMs());
+}
+
+Game::Checkpoint Game::checkpoint() const
+{
+    Checkpoint checkpoint;
+    checkpoint.gameCode = gameCode;
+    checkpoint.theme = selectedTheme;
+    checkpoint.state = state;
+    checkpoint.questionIndex = currentQuestionIndex;
+    checkpoint.questions = questions;
+    checkpoint.scores = playerScores;
+    checkpoint.teams = teams.state();
+    return checkpoint;
+}
+
+void Game::restoreCheckpoint(const Checkpoint& checkpoint, bool host, qint64 remainingMs)
+{
+    stopFlow();
+    questionSnapshot = QuestionStore::Snapshot();   // les questions sont dans le point de reprise
+    gameCode = checkpoint.gameCode;
+    selectedTheme = checkpoint.theme;
+    questions = checkpoint.questions;
+    currentQuestionIndex = checkpoint.questionIndex;
+    playerScores = checkpoint.scores;
+    teams.restore(checkpoint.teams);
+    isHost = host;
+    currentAnswers.clear();
+    currentAnswerTimes.clear();
+    answerCounts.clear();
+    state = checkpoint.state;
+
+    // Question interrompue : rejouée en entier, sauf si l'hôte donne le temps
+    // restant ; résultats affichés : on attend la question suivante
+    if (currentQuestionIndex < questions.size()) {
+        if (state == QUESTION_ACTIVE) {
+            const qint64 total = qint64(QUESTION_SECONDS) * 1000;
+            flow = playRounds(false, remainingMs < 0 ? 0 : total - qBound(qint64(0), remainingMs, total));
+        } else if (state == SHOWING_RESULTS) {
+            flow = playRounds(true);
+        }
+    }
+}
+
+void Game::setQuestionStore(QuestionStore* store)
+{
+    questionStore = store;
+}
+
+QuestionStore::Snapshot Game::getQuestionSnapshot() const
+{
+    if (questionSnapshot.isNull() && questionStore) {
+        return questionStore->snapshot();
+    }
+    return questionSnapshot;
+}
+
 int Game::getTotalQuestions() const
 {
     return questions.size();
@@ -217,6 +369,45 @@ QMap<QString, int> Game::getPlayerScores() const
     return playerScores;
 }
 
+QMap<QString, qint64> Game::getAnswerTimes() const
+{
+    return currentAnswerTimes;
+}
+
+qint64 Game::getAnswerTime(const QString& playerName) const
+{
+    return currentAnswerTimes.value(playerName, -1);
+}
+
+QVector<int> Game::getAnswerHistogram() const
+{
+    return answerCounts;
+}
+
+const TeamStandings& Game::getTeamStandings() const
+{
+    return teams;
+}
+
+QJsonArray Game::takeTeamDelta()
+{
+    return teams.takeDelta();
+}
+
+bool Game::applyTeamStandings(const QJsonArray& delta, bool reset)
+{
+    if (reset) {
+        // Liste complète : les ids de l'hôte remplacent ceux qu'on connaissait
+        TeamStandings standings;
+        if (!standings.applyDelta(delta)) {
+            return false;
+        }
+        teams = standings;
+        return true;
+    }
+    return teams.applyDelta(delta);
+}
+
 Game::GameState Game::getState() const
 {
     return state;
@@ -255,63 +446,58 @@ QString Game::generateGameCode()
     return code;
 }
 
-QVector<Question> Game::getQuestionsForTheme(Theme theme)
+static QString packText(const QuestionPackString &string)
 {
-    QVector<Question> themeQuestions;
-    
-    switch (theme) {
-    case SCIENCE:
-        themeQuestions.append(Question("Quelle est la formule chimique de l'eau?", 
-                                     {"H2O", "CO2", "O2", "NaCl"}, 0));
-        themeQuestions.append(Question("Combien de planètes y a-t-il dans notre système solaire?", 
-                                     {"7", "8", "9", "10"}, 1));
-        themeQuestions.append(Question("Quel est l'élément chimique avec le symbole 'Au'?", 
-                                     {"Argent", "Or", "Aluminium", "Argon"}, 1));
-        themeQuestions.append(Question("Quelle est la vitesse de la lumière?", 
-                                     {"300 000 km/s", "150 000 km/s", "450 000 km/s", "600 000 km/s"}, 0));
-        themeQuestions.append(Question("Qui a développé la théorie de la relativité?", 
-                                     {"Newton", "Galilée", "Einstein", "Bohr"}, 2));
-        break;
-        
-    case SPORT:
-        themeQuestions.append(Question("Combien de joueurs y a-t-il dans une équipe de football?", 
-                                     {"10", "11", "12", "9"}, 1));
-        themeQuestions.append(Question("Quel pays a gagné la Coupe du Monde 2018?", 
-                                     {"Brésil", "Allemagne", "France", "Argentine"}, 2));
-        themeQuestions.append(Question("Combien de sets faut-il gagner pour remporter un match de tennis masculin en Grand Chelem?", 
-                                     {"2", "3", "4", "5"}, 1));
-        themeQuestions.append(Question("Quel sport Michael Jordan a-t-il pratiqué professionnellement?", 
-                                     {"Football", "Baseball", "Basketball", "Tennis"}, 2));
-        themeQuestions.append(Question("Combien de temps dure un match de rugby?", 
-                                     {"80 minutes", "90 minutes", "70 minutes", "60 minutes"}, 0));
-        break;
-        
-    case CULTURE:
-        themeQuestions.append(Question("Qui a peint la Joconde?", 
-                                     {"Picasso", "Van Gogh", "Leonardo da Vinci", "Monet"}, 2));
-        themeQuestions.append(Question("Quelle est la capitale de l'Australie?", 
-                                     {"Sydney", "Melbourne", "Canberra", "Perth"}, 2));
-        themeQuestions.append(Question("Quel écrivain a créé le personnage de Sherlock Holmes?", 
-                                     {"Agatha Christie", "Arthur Conan Doyle", "Edgar Allan Poe", "Charles Dickens"}, 1));
-        themeQuestions.append(Question("En quelle année a eu lieu la Révolution française?", 
-                                     {"1789", "1792", "1799", "1804"}, 0));
-        themeQuestions.append(Question("Quel est le plus long fleuve du monde?", 
-                                     {"Amazon", "Nil", "Mississippi", "Yangtsé"}, 1));
-        break;
+    // Pas de copie : la QString pointe directement sur la table statique
+    return QString::fromRawData(reinterpret_cast<const QChar *>(string.data), string.size);
+}
+
+static QVector<Question> questionsFromPack(const QuestionPack &pack)
+{
+    QVector<Question> questions;
+    questions.reserve(pack.size);
+    for (int i = 0; i < pack.size; ++i) {
+        const QuestionPackEntry &entry = pack.entries[i];
+        QStringList answers;
+        answers.reserve(4);
+        for (const QuestionPackString &answer : entry.answers) {
+            answers.append(packText(answer));
+        }
+        questions.append(Question(packText(entry.text), answers, entry.correctAnswerIndex));
     }
-    
-    return themeQuestions;
+    return questions;
 }
 
-void Game::onTimeUp()
+QVector<Question> Game::getQuestionsForTheme(Theme theme)
 {
-    showResults();
+    static_assert(std::size(builtinQuestionPacks) == CULTURE + 1,
+                  "un pack de questions par valeur de Game::Theme");
+
+    // Construits une seule fois, puis partagés (copie implicite sans allocation)
+    static const QVector<Question> themeQuestions[] = {
+        questionsFromPack(builtinQuestionPacks[SCIENCE]),
+        questionsFromPack(builtinQuestionPacks[SPORT]),
+        questionsFromPack(builtinQuestionPacks[CULTURE])
+    };
+
+    if (theme < SCIENCE || theme > CULTURE) {
+        return QVector<Question>();
+    }
+    return themeQuestions[theme];
 }
 
 void Game::checkAllAnswersReceived()
 {
     if (currentAnswers.size() == playerScores.size()) {
         emit allAnswersReceived();
-        showResults();
+        resultsRequested = true;
+        waker.notify();
     }
 }
+
+void Game::resetAnswers()
+{
+    currentAnswers.clear();
+    currentAnswerTimes.clear();
+    answerCounts.fill(0, questions[currentQuestionIndex].getAnswers().size());
+}
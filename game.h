@@ -5,8 +5,11 @@
 #include <QString>
 #include <QVector>
 #include <QMap>
-#include <QTimer>
+#include "gameclock.h"
+#include "roomflow.h"
 #include "question.h"
+#include "questionstore.h"
+#include "teamstandings.h"
 
 class Game : public QObject
 {
@@ -26,19 +29,45 @@ public:
         GAME_FINISHED
     };
 
+    // État repris à une frontière de question (voir GameCheckpoint) : les
+    // réponses en cours ne sont pas conservées, la question est rejouée
+    struct Checkpoint {
+        QString gameCode;
+        Theme theme = SCIENCE;
+        GameState state = WAITING;
+        int questionIndex = 0;
+        QVector<Question> questions;
+        QMap<QString, int> scores;
+        TeamStandings::State teams;
+    };
+
 private:
     QString gameCode;
     Theme selectedTheme;
     QVector<Question> questions;
     QMap<QString, int> playerScores;
+    TeamStandings teams;                        // hôte : crédité dans publishResults() ; client : deltas de l'hôte
     QMap<QString, int> currentAnswers;
+    QMap<QString, qint64> currentAnswerTimes;   // ms depuis l'affichage de la question
+    GameClock* clock;
+    RoomWaker waker;                            // attente en cours du déroulé
+    qint64 questionStartMs;
+    bool resultsRequested;                      // fin de question demandée (tous ont répondu, showResults)
+    bool advanceRequested;                      // nextQuestion() en attente
+    quint64 flowRun;                            // déroulé courant, voir playRounds()
+    QVector<int> answerCounts;                  // histogramme des réponses, tenu à jour
     int currentQuestionIndex;
     GameState state;
-    QTimer* questionTimer;
     bool isHost;
+    QuestionStore* questionStore;
+    QuestionStore::Snapshot questionSnapshot;   // tenu de createGame() à endGame()
+    RoomTask flow;                              // en dernier : détruit avant ce qu'il utilise
 
 public:
-    explicit Game(QObject *parent = nullptr);
+    static constexpr int QUESTION_SECONDS = 10;
+
+    // clock null : temps réel (SystemClock enfant de Game)
+    explicit Game(QObject *parent = nullptr, GameClock *clock = nullptr);
     ~Game();
     
     // Game setup
@@ -47,7 +76,7 @@ public:
     void joinGame(const QString& code);
     
     // Player management
-    void addPlayer(const QString& playerName);
+    void addPlayer(const QString& playerName, const QString& team = QString());
     void removePlayer(const QString& playerName);
     QStringList getPlayers() const;
     
@@ -57,25 +86,37 @@ public:
     void submitAnswer(const QString& playerName, int answerIndex);
     void showResults();
     void endGame();
+    void abortGame();
     
     // Getters
     Question getCurrentQuestion() const;
     int getCurrentQuestionIndex() const;
     int getTotalQuestions() const;
     QMap<QString, int> getPlayerScores() const;
+    QMap<QString, qint64> getAnswerTimes() const;
+    qint64 getAnswerTime(const QString& playerName) const;
+    QVector<int> getAnswerHistogram() const;
+    const TeamStandings& getTeamStandings() const;
+    QJsonArray takeTeamDelta();                             // hôte : équipes changées depuis le dernier appel
+    bool applyTeamStandings(const QJsonArray& delta, bool reset);   // client
     GameState getState() const;
     QString getWinner() const;
     bool getIsHost() const;
     Theme getSelectedTheme() const;
-    void setupClientGame(Theme theme);
+    void setupClientGame(Theme theme, const QVector<Question>& hostQuestions = QVector<Question>());
+    void setQuestionStore(QuestionStore* store);
+    // Banque figée par createGame() ; après une reprise (rien de figé), la courante
+    QuestionStore::Snapshot getQuestionSnapshot() const;
+    QVector<Question> getQuestions() const;
+    Checkpoint checkpoint() const;
+    // remainingMs : temps restant de la question interrompue, -1 pour la rejouer en entier
+    void restoreCheckpoint(const Checkpoint& checkpoint, bool host, qint64 remainingMs = -1);
+    qint64 questionRemainingMs() const;                     // 0 hors question
     
     // Static methods
     static QString generateGameCode();
     static QVector<Question> getQuestionsForTheme(Theme theme);
 
-private slots:
-    void onTimeUp();
-
 signals:
     void gameCreated(const QString& code);
     void playerJoined(const QString& playerName);
@@ -90,7 +131,12 @@ signals:
 
 private:
     void initializeQuestions();
+    RoomTask playRounds(bool resumeAtResults, qint64 elapsedMs = 0);
+    void publishResults();
+    void finishGame();
+    void stopFlow();
     void checkAllAnswersReceived();
+    void resetAnswers();
 };
 
 #endif // GAME_H
@@ -0,0 +1,302 @@
+#include "gamecheckpoint.h"
+#include <QDataStream>
+#include <QDateTime>
+#include <QDir>
+#include <QFileInfo>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <QDebug>
+#include <atomic>
+#include <cstring>
+#include <zlib.h>
+
+static const char FILE_MAGIC[4] = {'Q', 'Z', 'C', '1'};
+static constexpr int FILE_HEADER_SIZE = 32;     // magic, version, capacité, battement
+static constexpr int HEARTBEAT_OFFSET = 16;
+static constexpr int SLOT_HEADER_SIZE = 16;     // séquence, taille, crc32
+
+static qint64 fileSizeFor(qint64 slotCapacity)
+{
+    return FILE_HEADER_SIZE + 2 * (SLOT_HEADER_SIZE + slotCapacity);
+}
+
+static quint32 checksum(const char *data, qint64 size)
+{
+    return quint32(crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(data), uInt(size)));
+}
+
+static bool validHeader(const uchar *header, qint64 fileSize, qint64 *slotCapacity)
+{
+    if (fileSize < FILE_HEADER_SIZE || std::memcmp(header, FILE_MAGIC, 4) != 0
+        || qFromLittleEndian<quint32>(header + 4) != GameCheckpoint::FORMAT_VERSION)
+        return false;
+    *slotCapacity = qFromLittleEndian<qint64>(header + 8);
+    return *slotCapacity > 0 && fileSizeFor(*slotCapacity) <= fileSize;
+}
+
+static void writeQuestions(QDataStream &out, const QVector<Question> &questions)
+{
+    out << qint32(questions.size());
+    for (const Question &question : questions) {
+        const Question::Media &media = question.getMedia();
+        out << question.getQuestionText() << question.getAnswers() << qint32(question.getCorrectAnswerIndex())
+            << qint8(media.kind) << media.hash << media.size;
+    }
+}
+
+static void writeTeams(QDataStream &out, const TeamStandings::State &teams)
+{
+    out << teams.names << teams.scores << teams.attempts << teams.members;
+}
+
+GameCheckpoint::GameCheckpoint(const QString &path)
+    : file(path), map(nullptr), slotCapacity(0), sequence(0)
+{
+}
+
+GameCheckpoint::~GameCheckpoint()
+{
+    if (map)
+        file.unmap(map);
+}
+
+QString GameCheckpoint::defaultPath()
+{
+    QString path = qEnvironmentVariable("QUIZZ_CHECKPOINT");
+    if (path.isEmpty())
+        path = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/checkpoint.qck";
+    return path;
+}
+
+QString GameCheckpoint::path() const
+{
+    return file.fileName();
+}
+
+bool GameCheckpoint::openMap(qint64 capacity)
+{
+    if (map) {
+        file.unmap(map);
+        map = nullptr;
+    }
+    if (!file.isOpen()) {
+        QDir().mkpath(QFileInfo(file).absolutePath());
+        if (!file.open(QIODevice::ReadWrite)) {
+            qWarning() << "Checkpoint file not opened:" << file.fileName() << file.errorString();
+            return false;
+        }
+    }
+
+    // Un fichier existant garde sa capacité : la reprise continue sa séquence
+    uchar header[FILE_HEADER_SIZE] = {};
+    qint64 existingCapacity = 0;
+    file.seek(0);
+    const bool existing = file.read(reinterpret_cast<char *>(header), FILE_HEADER_SIZE) == FILE_HEADER_SIZE
+                       && validHeader(header, file.size(), &existingCapacity);
+    const bool grow = !existing || existingCapacity < capacity;
+    slotCapacity = grow ? capacity : existingCapacity;
+
+    if (grow && !file.resize(fileSizeFor(slotCapacity))) {
+        qWarning() << "Checkpoint file not resized:" << file.errorString();
+        return false;
+    }
+    map = file.map(0, fileSizeFor(slotCapacity));
+    if (!map)
+        return false;
+
+    if (grow) {
+        // Les emplacements ont bougé : anciens contenus invalidés
+        std::memset(slot(0), 0, SLOT_HEADER_SIZE);
+        std::memset(slot(1), 0, SLOT_HEADER_SIZE);
+        std::memcpy(map, FILE_MAGIC, 4);
+        qToLittleEndian<quint32>(FORMAT_VERSION, map + 4);
+        qToLittleEndian<qint64>(slotCapacity, map + 8);
+    }
+    sequence = qMax(qFromLittleEndian<quint64>(slot(0)), qFromLittleEndian<quint64>(slot(1)));
+    return true;
+}
+
+uchar *GameCheckpoint::slot(int index) const
+{
+    return map + FILE_HEADER_SIZE + index * (SLOT_HEADER_SIZE + slotCapacity);
+}
+
+bool GameCheckpoint::save(const Record &record)
+{
+    // Questions encodées une fois par partie : seuls l'index et les scores changent.
+    // Un code à 6 chiffres peut revenir : la clé porte aussi sur les questions elles-mêmes.
+    QByteArray key = record.game.gameCode.toLatin1();
+    key.append(reinterpret_cast<const char *>(&record.journalGameId), sizeof(record.journalGameId));
+    for (const Question &question : record.game.questions) {
+        const quint64 id = question.getId();
+        key.append(reinterpret_cast<const char *>(&id), sizeof(id));
+    }
+    if (questionCacheKey != key || questionCache.isEmpty()) {
+        questionCache.clear();
+        QDataStream out(&questionCache, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        writeQuestions(out, record.game.questions);
+        questionCacheKey = key;
+    }
+
+    payload.clear();
+    {
+        QDataStream out(&payload, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << record.game.gameCode << record.hostName << record.port << record.journalGameId
+            << QDateTime::currentMSecsSinceEpoch() << qint32(record.game.theme) << qint32(record.game.state)
+            << qint32(record.game.questionIndex) << record.game.scores;
+        out.writeRawData(questionCache.constData(), int(questionCache.size()));
+        writeTeams(out, record.game.teams);
+        out << record.rejoinSecret;
+    }
+
+    if (!map || payload.size() > slotCapacity) {
+        qint64 capacity = qMax(slotCapacity, INITIAL_SLOT_CAPACITY);
+        while (capacity < payload.size())
+            capacity *= 2;
+        if (!openMap(capacity))
+            return false;
+    }
+
+    // Emplacement le plus ancien : invalidé, rempli, puis validé par sa séquence
+    const quint64 next = sequence + 1;
+    uchar *target = slot(int(next % 2));
+    qToLittleEndian<quint64>(0, target);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::memcpy(target + SLOT_HEADER_SIZE, payload.constData(), payload.size());
+    qToLittleEndian<quint32>(quint32(payload.size()), target + 8);
+    qToLittleEndian<quint32>(checksum(payload.constData(), payload.size()), target + 12);
+    std::atomic_thread_fence(std::memory_order_release);
+    qToLittleEndian<quint64>(next, target);
+    sequence = next;
+    return true;
+}
+
+void GameCheckpoint::clear()
+{
+    save(Record());
+}
+
+void GameCheckpoint::heartbeat()
+{
+    if (map || openMap(INITIAL_SLOT_CAPACITY))
+        qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), map + HEARTBEAT_OFFSET);
+}
+
+bool GameCheckpoint::load(Record *record) const
+{
+    QFile input(file.fileName());
+    if (!input.open(QIODevice::ReadOnly))
+        return false;
+    const qint64 size = input.size();
+    const uchar *data = size >= FILE_HEADER_SIZE ? input.map(0, size) : nullptr;
+    if (!data)
+        return false;
+
+    qint64 capacity = 0;
+    QByteArray best;
+    quint64 bestSequence = 0;
+    if (validHeader(data, size, &capacity)) {
+        for (int i = 0; i < 2; ++i) {
+            const uchar *s = data + FILE_HEADER_SIZE + i * (SLOT_HEADER_SIZE + capacity);
+            // Lecture type seqlock : l'hôte peut réécrire cet emplacement en même temps
+            const quint64 before = qFromLittleEndian<quint64>(s);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            const quint32 length = qFromLittleEndian<quint32>(s + 8);
+            const quint32 crc = qFromLittleEndian<quint32>(s + 12);
+            if (before == 0 || before <= bestSequence || length > capacity)
+                continue;
+            QByteArray copy(reinterpret_cast<const char *>(s + SLOT_HEADER_SIZE), length);
+            std::atomic_thread_fence(std::memory_order_acquire);
+            if (qFromLittleEndian<quint64>(s) != before || checksum(copy.constData(), copy.size()) != crc)
+                continue;
+            best = copy;
+            bestSequence = before;
+        }
+    }
+    input.unmap(const_cast<uchar *>(data));
+
+    if (bestSequence == 0 || !decode(best, record))
+        return false;
+    record->sequence = bestSequence;
+    return true;
+}
+
+qint64 GameCheckpoint::lastHeartbeat() const
+{
+    QFile input(file.fileName());
+    uchar header[FILE_HEADER_SIZE];
+    qint64 capacity = 0;
+    if (!input.open(QIODevice::ReadOnly)
+        || input.read(reinterpret_cast<char *>(header), FILE_HEADER_SIZE) != FILE_HEADER_SIZE
+        || !validHeader(header, input.size(), &capacity))
+        return 0;
+    return qFromLittleEndian<qint64>(header + HEARTBEAT_OFFSET);
+}
+
+bool GameCheckpoint::isResumable(const Record &record)
+{
+    const Game::Checkpoint &game = record.game;
+    if (game.gameCode.isEmpty() || game.questions.isEmpty() || game.state == Game::GAME_FINISHED)
+        return false;
+    return game.state == Game::WAITING || game.questionIndex < game.questions.size();
+}
+
+QByteArray GameCheckpoint::encode(const Record &record)
+{
+    QByteArray bytes;
+    QDataStream out(&bytes, QIODevice::WriteOnly);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << record.game.gameCode << record.hostName << record.port << record.journalGameId
+        << record.savedAt << qint32(record.game.theme) << qint32(record.game.state)
+        << qint32(record.game.questionIndex) << record.game.scores;
+    writeQuestions(out, record.game.questions);
+    writeTeams(out, record.game.teams);
+    out << record.rejoinSecret;
+    return bytes;
+}
+
+bool GameCheckpoint::decode(const QByteArray &payload, Record *record)
+{
+    QDataStream in(payload);
+    in.setVersion(QDataStream::Qt_6_0);
+
+    Record result;
+    qint32 theme = 0, state = 0, questionIndex = 0, count = 0;
+    in >> result.game.gameCode >> result.hostName >> result.port >> result.journalGameId
+       >> result.savedAt >> theme >> state >> questionIndex >> result.game.scores >> count;
+    if (in.status() != QDataStream::Ok || theme < Game::SCIENCE || theme > Game::CULTURE
+        || state < Game::WAITING || state > Game::GAME_FINISHED || count < 0 || questionIndex < 0)
+        return false;
+
+    result.game.questions.reserve(count);
+    for (qint32 i = 0; i < count; ++i) {
+        QString text;
+        QStringList answers;
+        qint32 correct = -1;
+        qint8 kind = 0;
+        Question::Media media;
+        in >> text >> answers >> correct >> kind >> media.hash >> media.size;
+        if (in.status() != QDataStream::Ok || answers.size() != 4 || correct < 0 || correct >= answers.size()
+            || kind < Question::Media::NONE || kind > Question::Media::AUDIO)
+            return false;
+        Question question(text, answers, correct);
+        media.kind = static_cast<Question::Media::Kind>(kind);
+        if (!media.isNull())
+            question.setMedia(media);
+        result.game.questions.append(question);
+    }
+
+    TeamStandings::State &teams = result.game.teams;
+    in >> teams.names >> teams.scores >> teams.attempts >> teams.members >> result.rejoinSecret;
+    if (in.status() != QDataStream::Ok || teams.scores.size() != teams.names.size()
+        || teams.attempts.size() != teams.names.size())
+        return false;
+
+    result.game.theme = static_cast<Game::Theme>(theme);
+    result.game.state = static_cast<Game::GameState>(state);
+    result.game.questionIndex = questionIndex;
+    *record = result;
+    return true;
+}
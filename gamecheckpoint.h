@@ -0,0 +1,67 @@
+#ifndef GAMECHECKPOINT_H
+#define GAMECHECKPOINT_H
+
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include "game.h"
+
+// Points de reprise de la partie hébergée, écrits à chaque frontière de
+// question pour qu'un processus de secours (--standby) reprenne le port et
+// la partie si l'hôte disparaît.
+//
+// Le fichier est projeté en mémoire et contient deux emplacements écrits en
+// alternance : le plus récent dont la somme de contrôle est valide fait foi,
+// une écriture interrompue laisse donc toujours le précédent lisible. Pas de
+// fsync : il s'agit de survivre à la mort du processus, pas de la machine.
+class GameCheckpoint
+{
+public:
+    struct Record {
+        Game::Checkpoint game;
+        QString hostName;
+        quint16 port = 0;
+        quint64 journalGameId = 0;      // la reprise continue la même partie du journal
+        QByteArray rejoinSecret;        // hôte seulement : dérive les jetons de reconnexion
+        qint64 savedAt = 0;             // ms depuis l'époque Unix
+        quint64 sequence = 0;           // attribué par save()
+    };
+
+    static constexpr quint32 FORMAT_VERSION = 4;       // 2 : médias, 3 : équipes, 4 : secret de reconnexion
+    static constexpr qint64 INITIAL_SLOT_CAPACITY = 64 * 1024;
+
+    explicit GameCheckpoint(const QString &path);
+    ~GameCheckpoint();
+
+    // QUIZZ_CHECKPOINT, sinon checkpoint.qck dans AppDataLocation
+    static QString defaultPath();
+
+    QString path() const;
+
+    // Côté hôte
+    bool save(const Record &record);
+    void clear();                       // plus rien à reprendre
+    void heartbeat();                   // hôte vivant, appelé chaque seconde
+
+    // Côté secours : le fichier est relu à chaque appel
+    bool load(Record *record) const;
+    qint64 lastHeartbeat() const;
+
+    static bool isResumable(const Record &record);
+    static QByteArray encode(const Record &record);     // même format, pour le réseau
+    static bool decode(const QByteArray &payload, Record *record);
+
+private:
+    bool openMap(qint64 slotCapacity);
+    uchar *slot(int index) const;
+
+    QFile file;
+    uchar *map;
+    qint64 slotCapacity;
+    quint64 sequence;
+    QByteArray payload;                 // réutilisé d'un point à l'autre
+    QByteArray questionCache;           // questions déjà encodées de la partie en cours
+    QByteArray questionCacheKey;        // code, partie du journal et empreintes des questions
+};
+
+#endif // GAMECHECKPOINT_H
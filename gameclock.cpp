@@ -0,0 +1,148 @@
+#include "gameclock.h"
+#include <QTimer>
+
+GameClock::~GameClock() = default;
+
+DeadlineQueue::DeadlineQueue()
+    : nextId(1)
+{
+}
+
+int DeadlineQueue::push(qint64 atMs, GameClock::Task fn)
+{
+    const int id = nextId++;
+    if (nextId <= 0)
+        nextId = 1;
+
+    // multimap : insertion après les clés égales, donc ordre de programmation
+    pending.insert(id, queue.emplace(atMs, std::make_pair(id, std::move(fn))));
+    return id;
+}
+
+void DeadlineQueue::cancel(int id)
+{
+    const auto it = pending.find(id);
+    if (it == pending.end())
+        return;
+    queue.erase(it.value());
+    pending.erase(it);
+}
+
+bool DeadlineQueue::isEmpty() const
+{
+    return queue.empty();
+}
+
+qint64 DeadlineQueue::nextDeadline() const
+{
+    return queue.begin()->first;
+}
+
+GameClock::Task DeadlineQueue::pop()
+{
+    const auto first = queue.begin();
+    GameClock::Task fn = std::move(first->second.second);
+    pending.remove(first->second.first);
+    queue.erase(first);
+    return fn;
+}
+
+SystemClock::SystemClock(QObject *parent)
+    : QObject(parent)
+{
+    clock.start();
+    timer = new QTimer(this);
+    timer->setSingleShot(true);
+    timer->setTimerType(Qt::PreciseTimer);
+    connect(timer, &QTimer::timeout, this, &SystemClock::runDue);
+}
+
+qint64 SystemClock::nowMs() const
+{
+    return clock.elapsed();
+}
+
+int SystemClock::schedule(qint64 delayMs, Task fn)
+{
+    const qint64 at = clock.elapsed() + qMax<qint64>(0, delayMs);
+    const bool earliest = deadlines.isEmpty() || at < deadlines.nextDeadline();
+    const int id = deadlines.push(at, std::move(fn));
+    if (earliest)
+        rearm();
+    return id;
+}
+
+void SystemClock::cancel(int id)
+{
+    // Le timer peut rester armé : un réveil sans échéance due ne fait que réarmer
+    deadlines.cancel(id);
+}
+
+void SystemClock::runDue()
+{
+    while (!deadlines.isEmpty() && deadlines.nextDeadline() <= clock.elapsed()) {
+        const Task fn = deadlines.pop();
+        fn();       // peut programmer ou annuler d'autres échéances
+    }
+    rearm();
+}
+
+void SystemClock::rearm()
+{
+    if (deadlines.isEmpty()) {
+        timer->stop();
+        return;
+    }
+    timer->start(int(qMax<qint64>(0, deadlines.nextDeadline() - clock.elapsed())));
+}
+
+VirtualClock::VirtualClock()
+    : now(0)
+{
+}
+
+qint64 VirtualClock::nowMs() const
+{
+    return now;
+}
+
+int VirtualClock::schedule(qint64 delayMs, Task fn)
+{
+    return deadlines.push(now + qMax<qint64>(0, delayMs), std::move(fn));
+}
+
+void VirtualClock::cancel(int id)
+{
+    deadlines.cancel(id);
+}
+
+bool VirtualClock::advance()
+{
+    if (deadlines.isEmpty())
+        return false;
+
+    now = qMax(now, deadlines.nextDeadline());
+    const Task fn = deadlines.pop();
+    fn();
+    return true;
+}
+
+void VirtualClock::advanceTo(qint64 ms)
+{
+    while (!deadlines.isEmpty() && deadlines.nextDeadline() <= ms)
+        advance();
+    now = qMax(now, ms);
+}
+
+quint64 VirtualClock::runUntilIdle(quint64 maxTasks)
+{
+    quint64 count = 0;
+    while (count < maxTasks && advance())
+        ++count;
+    return count;
+}
+
+bool VirtualClock::isIdle() const
+{
+    return deadlines.isEmpty();
+}
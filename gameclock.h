@@ -0,0 +1,89 @@
+#ifndef GAMECLOCK_H
+#define GAMECLOCK_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <functional>
+#include <map>
+
+class QTimer;
+
+// Horloge et échéancier de Game : temps réel en jeu, temps virtuel pour les
+// simulations, bancs d'essai et rejeux (la même logique de partie tourne
+// sans attendre les 10 s de chaque question).
+class GameClock
+{
+public:
+    using Task = std::function<void()>;
+
+    virtual ~GameClock();
+
+    virtual qint64 nowMs() const = 0;
+    // fn appelée dans delayMs ; l'identifiant (jamais 0) sert à annuler
+    virtual int schedule(qint64 delayMs, Task fn) = 0;
+    virtual void cancel(int id) = 0;       // sans effet si déjà exécutée ou 0
+};
+
+// Échéances en attente, par instant puis par ordre de programmation
+class DeadlineQueue
+{
+public:
+    DeadlineQueue();
+
+    int push(qint64 atMs, GameClock::Task fn);
+    void cancel(int id);
+    bool isEmpty() const;
+    qint64 nextDeadline() const;        // file non vide
+    GameClock::Task pop();              // retire la première échéance
+
+private:
+    using Queue = std::multimap<qint64, std::pair<int, GameClock::Task>>;
+
+    int nextId;
+    Queue queue;
+    QHash<int, Queue::iterator> pending;
+};
+
+// Temps réel : un seul QTimer précis, armé sur l'échéance la plus proche,
+// pour toutes les salles qui partagent l'horloge (sur son thread)
+class SystemClock : public QObject, public GameClock
+{
+public:
+    explicit SystemClock(QObject *parent = nullptr);
+
+    qint64 nowMs() const override;
+    int schedule(qint64 delayMs, Task fn) override;
+    void cancel(int id) override;
+
+private:
+    void runDue();
+    void rearm();
+
+    QElapsedTimer clock;
+    QTimer *timer;
+    DeadlineQueue deadlines;
+};
+
+// Temps virtuel : rien ne s'écoule tout seul, advance() saute directement à
+// la prochaine échéance
+class VirtualClock : public GameClock
+{
+public:
+    VirtualClock();
+
+    qint64 nowMs() const override;
+    int schedule(qint64 delayMs, Task fn) override;
+    void cancel(int id) override;
+
+    bool advance();                     // exécute la prochaine échéance ; false si aucune
+    void advanceTo(qint64 ms);          // exécute tout ce qui échoit jusqu'à ms incluse
+    quint64 runUntilIdle(quint64 maxTasks = ~quint64(0));
+    bool isIdle() const;
+
+private:
+    qint64 now;
+    DeadlineQueue deadlines;
+};
+
+#endif // GAMECLOCK_H
@@ -0,0 +1,346 @@
+#include "gamejournal.h"
+#include <QDir>
+#include <QDateTime>
+#include <QStandardPaths>
+#include <QtEndian>
+#include <QDebug>
+#include <chrono>
+#include <cstring>
+#include <memory>
+
+static const char SEGMENT_MAGIC[4] = {'Q', 'Z', 'J', '1'};
+static constexpr int SEGMENT_HEADER_SIZE = 8;        // magic + version
+static constexpr quint32 SEGMENT_VERSION = 2;         // 1 : identifiants de question sur 32 bits
+static constexpr int RECORD_FIXED_SIZE = 38;          // voir encodeRecord()
+static constexpr int INDEX_ENTRY_SIZE = 16;           // gameId + offset
+static constexpr std::size_t QUEUE_CAPACITY = 1 << 14;
+static constexpr int MAX_BATCH = 1024;
+static constexpr int IDLE_WAIT_MS = 5;
+
+static void encodeRecord(const GameJournal::Record &record, QByteArray &out)
+{
+    const int size = RECORD_FIXED_SIZE + record.textLength;
+    const qsizetype start = out.size();
+    out.resize(start + size);
+    uchar *p = reinterpret_cast<uchar *>(out.data() + start);
+
+    qToLittleEndian<quint16>(quint16(size), p);              p += 2;
+    *p++ = record.type;
+    *p++ = record.flags;
+    qToLittleEndian<qint16>(record.answerIndex, p);          p += 2;
+    qToLittleEndian<quint16>(record.questionIndex, p);       p += 2;
+    qToLittleEndian<quint64>(record.questionId, p);          p += 8;
+    qToLittleEndian<quint64>(record.gameId, p);              p += 8;
+    qToLittleEndian<qint64>(record.timestampNs, p);          p += 8;
+    qToLittleEndian<qint32>(record.value, p);                p += 4;
+    qToLittleEndian<quint16>(record.textLength, p);          p += 2;
+    std::memcpy(p, record.text, record.textLength);
+}
+
+static bool decodeRecord(const uchar *p, qint64 available, quint32 version, GameJournal::Record *record,
+                         int *consumed)
+{
+    // Segments de version 1 toujours lisibles : leurs identifiants restent sur 32 bits
+    const int idSize = version >= 2 ? 8 : 4;
+    const int fixedSize = RECORD_FIXED_SIZE - 8 + idSize;
+    if (available < fixedSize)
+        return false;
+
+    const int size = qFromLittleEndian<quint16>(p);
+    if (size < fixedSize || size > available)
+        return false;
+
+    record->type = p[2];
+    record->flags = p[3];
+    record->answerIndex = qFromLittleEndian<qint16>(p + 4);
+    record->questionIndex = qFromLittleEndian<quint16>(p + 6);
+    record->questionId = idSize == 8 ? qFromLittleEndian<quint64>(p + 8) : qFromLittleEndian<quint32>(p + 8);
+    const uchar *rest = p + 8 + idSize;
+    record->gameId = qFromLittleEndian<quint64>(rest);
+    record->timestampNs = qFromLittleEndian<qint64>(rest + 8);
+    record->value = qFromLittleEndian<qint32>(rest + 16);
+    record->textLength = qMin<quint16>(qFromLittleEndian<quint16>(rest + 20), GameJournal::TEXT_CAPACITY);
+    if (fixedSize + record->textLength > size)
+        return false;
+    std::memcpy(record->text, p + fixedSize, record->textLength);
+
+    *consumed = size;
+    return true;
+}
+
+void GameJournal::Record::setText(const QString &string)
+{
+    QByteArray utf8 = string.toUtf8();
+    int length = qMin<int>(utf8.size(), TEXT_CAPACITY);
+    // Ne pas couper au milieu d'un caractère UTF-8
+    while (length > 0 && length < utf8.size() && (quint8(utf8.at(length)) & 0xC0) == 0x80)
+        --length;
+    std::memcpy(text, utf8.constData(), length);
+    textLength = quint16(length);
+}
+
+QString GameJournal::Record::textString() const
+{
+    return QString::fromUtf8(text, textLength);
+}
+
+GameJournal::GameJournal(const QString &directory)
+    : journalDir(directory), queue(QUEUE_CAPACITY), running(true), dropped(0),
+      segmentFile(nullptr), indexFile(nullptr), segmentNumber(0), segmentSize(0)
+{
+    QDir().mkpath(journalDir);
+
+    // Jamais de réécriture : on reprend après le dernier segment existant
+    const QStringList existing = segmentPaths(journalDir);
+    if (!existing.isEmpty())
+        segmentNumber = QFileInfo(existing.last()).baseName().mid(8).toInt();
+
+    writer = std::thread(&GameJournal::writerLoop, this);
+}
+
+GameJournal::~GameJournal()
+{
+    running.store(false, std::memory_order_release);
+    if (writer.joinable())
+        writer.join();
+}
+
+GameJournal *GameJournal::shared()
+{
+    static std::unique_ptr<GameJournal> instance = []() -> std::unique_ptr<GameJournal> {
+        if (qEnvironmentVariable("QUIZZ_JOURNAL") == "0")
+            return nullptr;
+        QString dir = qEnvironmentVariable("QUIZZ_JOURNAL_DIR");
+        if (dir.isEmpty())
+            dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation) + "/journal";
+        return std::make_unique<GameJournal>(dir);
+    }();
+    return instance.get();
+}
+
+quint64 GameJournal::newGameId(const QString &gameCode)
+{
+    // Milliseconde de création * 10^6 + code : unique et croissant dans le temps
+    return quint64(QDateTime::currentMSecsSinceEpoch()) * 1000000ULL + gameCode.toULongLong() % 1000000ULL;
+}
+
+bool GameJournal::append(Record record)
+{
+    record.timestampNs = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::system_clock::now().time_since_epoch()).count();
+    if (queue.tryPush(record))
+        return true;
+
+    dropped.fetch_add(1, std::memory_order_relaxed);
+    return false;
+}
+
+quint64 GameJournal::droppedRecords() const
+{
+    return dropped.load(std::memory_order_relaxed);
+}
+
+QString GameJournal::directory() const
+{
+    return journalDir;
+}
+
+QStringList GameJournal::segmentPaths(const QString &directory)
+{
+    QDir dir(directory);
+    QStringList paths;
+    const QStringList names = dir.entryList({"journal-*.qjl"}, QDir::Files, QDir::Name);
+    for (const QString &name : names)
+        paths.append(dir.filePath(name));
+    return paths;
+}
+
+QVector<GameJournal::Location> GameJournal::findGame(const QString &directory, quint64 gameId)
+{
+    QVector<Location> locations;
+
+    for (const QString &segmentPath : segmentPaths(directory)) {
+        QString indexPath = segmentPath;
+        indexPath.replace(indexPath.size() - 4, 4, ".idx");
+
+        QFile index(indexPath);
+        if (!index.open(QIODevice::ReadOnly) || index.size() < INDEX_ENTRY_SIZE)
+            continue;
+
+        const qint64 count = index.size() / INDEX_ENTRY_SIZE;
+        const uchar *entries = index.map(0, count * INDEX_ENTRY_SIZE);
+        if (!entries)
+            continue;
+
+        for (qint64 i = 0; i < count; ++i) {
+            const uchar *entry = entries + i * INDEX_ENTRY_SIZE;
+            if (qFromLittleEndian<quint64>(entry) == gameId)
+                locations.append({segmentPath, qint64(qFromLittleEndian<quint64>(entry + 8))});
+        }
+        index.unmap(const_cast<uchar *>(entries));
+    }
+
+    return locations;
+}
+
+void GameJournal::writerLoop()
+{
+    if (!openNextSegment()) {
+        qWarning() << "Game journal disabled: cannot write to" << journalDir;
+        return;
+    }
+
+    Record record;
+    for (;;) {
+        int batched = 0;
+        while (batched < MAX_BATCH && queue.tryPop(&record)) {
+            const qint64 recordSize = RECORD_FIXED_SIZE + record.textLength;
+            if (segmentSize + pendingRecords.size() + recordSize > SEGMENT_LIMIT) {
+                flushPending();
+                if (!openNextSegment())
+                    return;
+            }
+
+            if (record.type == GAME_CREATED) {
+                char entry[INDEX_ENTRY_SIZE];
+                qToLittleEndian<quint64>(record.gameId, entry);
+                qToLittleEndian<quint64>(quint64(segmentSize + pendingRecords.size()), entry + 8);
+                pendingIndex.append(entry, INDEX_ENTRY_SIZE);
+            }
+            encodeRecord(record, pendingRecords);
+            ++batched;
+        }
+
+        if (batched > 0) {
+            flushPending();   // un write() par lot
+            continue;
+        }
+
+        if (!running.load(std::memory_order_acquire))
+            break;
+        std::this_thread::sleep_for(std::chrono::milliseconds(IDLE_WAIT_MS));
+    }
+
+    flushPending();
+    segmentFile->close();
+    indexFile->close();
+    delete segmentFile;
+    delete indexFile;
+    segmentFile = nullptr;
+    indexFile = nullptr;
+}
+
+bool GameJournal::openNextSegment()
+{
+    if (segmentFile) {
+        segmentFile->close();
+        indexFile->close();
+        delete segmentFile;
+        delete indexFile;
+    }
+
+    ++segmentNumber;
+    const QString base = QDir(journalDir).filePath(QString("journal-%1").arg(segmentNumber, 6, 10, QChar('0')));
+    segmentFile = new QFile(base + ".qjl");
+    indexFile = new QFile(base + ".idx");
+
+    if (!segmentFile->open(QIODevice::WriteOnly | QIODevice::Append)
+        || !indexFile->open(QIODevice::WriteOnly | QIODevice::Append)) {
+        return false;
+    }
+
+    char header[SEGMENT_HEADER_SIZE];
+    std::memcpy(header, SEGMENT_MAGIC, 4);
+    qToLittleEndian<quint32>(SEGMENT_VERSION, header + 4);
+    segmentFile->write(header, SEGMENT_HEADER_SIZE);
+    segmentFile->flush();
+    segmentSize = SEGMENT_HEADER_SIZE;
+    return true;
+}
+
+void GameJournal::flushPending()
+{
+    if (!pendingRecords.isEmpty()) {
+        segmentFile->write(pendingRecords);
+        segmentFile->flush();
+        segmentSize += pendingRecords.size();
+        pendingRecords.clear();
+    }
+    if (!pendingIndex.isEmpty()) {
+        indexFile->write(pendingIndex);
+        indexFile->flush();
+        pendingIndex.clear();
+    }
+}
+
+GameJournal::Reader::Reader(const QString &directory)
+    : segments(GameJournal::segmentPaths(directory)), segmentIndex(-1), version(SEGMENT_VERSION),
+      data(nullptr), size(0), position(0)
+{
+}
+
+GameJournal::Reader::Reader(const QStringList &segmentPaths)
+    : segments(segmentPaths), segmentIndex(-1), version(SEGMENT_VERSION),
+      data(nullptr), size(0), position(0)
+{
+}
+
+GameJournal::Reader::~Reader()
+{
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+}
+
+bool GameJournal::Reader::seek(const Location &location)
+{
+    const int index = segments.indexOf(location.segmentPath);
+    if (index < 0 || !openSegment(index))
+        return false;
+    position = qMax<qint64>(location.offset, SEGMENT_HEADER_SIZE);
+    return position <= size;
+}
+
+bool GameJournal::Reader::next(Record *record)
+{
+    for (;;) {
+        if (data && position < size) {
+            int consumed = 0;
+            if (decodeRecord(data + position, size - position, version, record, &consumed)) {
+                position += consumed;
+                return true;
+            }
+            // Fin tronquée (écriture en cours ou arrêt brutal) : segment suivant
+        }
+        if (!openSegment(segmentIndex + 1))
+            return false;
+    }
+}
+
+bool GameJournal::Reader::openSegment(int index)
+{
+    if (data) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+    }
+    file.close();
+
+    for (segmentIndex = index; segmentIndex < segments.size(); ++segmentIndex) {
+        file.setFileName(segments.at(segmentIndex));
+        if (!file.open(QIODevice::ReadOnly) || file.size() < SEGMENT_HEADER_SIZE) {
+            file.close();
+            continue;
+        }
+        size = file.size();
+        data = file.map(0, size);
+        if (data && std::memcmp(data, SEGMENT_MAGIC, 4) == 0) {
+            version = qFromLittleEndian<quint32>(data + 4);
+            position = SEGMENT_HEADER_SIZE;
+            return true;
+        }
+        if (data)
+            file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+        file.close();
+    }
+    return false;
+}
@@ -0,0 +1,120 @@
+#ifndef GAMEJOURNAL_H
+#define GAMEJOURNAL_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QFile>
+#include <atomic>
+#include <thread>
+#include "boundedqueue.h"
+
+// Journal binaire, en ajout seul, des événements de partie.
+//
+// append() copie l'événement dans une file sans verrou et rend la main
+// immédiatement ; un thread d'écriture vide la file par lots dans des
+// segments journal-NNNNNN.qjl (rotation à SEGMENT_LIMIT). Chaque segment
+// a un index journal-NNNNNN.idx (gameId, offset) lu par mmap dans findGame().
+class GameJournal
+{
+public:
+    enum EventType : quint8 {
+        GAME_CREATED = 1,
+        PLAYER_JOINED = 2,
+        PLAYER_LEFT = 3,
+        QUESTION_SHOWN = 4,
+        ANSWER_SUBMITTED = 5,
+        QUESTION_RESULTS = 6,
+        FINAL_SCORE = 7,
+        GAME_ENDED = 8
+    };
+
+    enum RecordFlag : quint8 {
+        FLAG_CORRECT = 0x01
+    };
+
+    static constexpr int TEXT_CAPACITY = 80;
+    static constexpr qint64 SEGMENT_LIMIT = 64 * 1024 * 1024;
+
+    struct Record {
+        quint8 type = 0;
+        quint8 flags = 0;
+        qint16 answerIndex = -1;
+        quint16 questionIndex = 0;
+        quint64 questionId = 0;     // Question::getId()
+        quint64 gameId = 0;
+        qint64 timestampNs = 0;     // horloge murale, ns depuis l'époque Unix
+        qint32 value = 0;           // latence (ms), score, thème... selon le type
+        quint16 textLength = 0;
+        char text[TEXT_CAPACITY];
+
+        void setText(const QString &string);
+        QString textString() const;
+    };
+
+    struct Location {
+        QString segmentPath;
+        qint64 offset = 0;
+    };
+
+    explicit GameJournal(const QString &directory);
+    ~GameJournal();
+
+    GameJournal(const GameJournal &) = delete;
+    GameJournal &operator=(const GameJournal &) = delete;
+
+    // Instance du processus (QUIZZ_JOURNAL_DIR, QUIZZ_JOURNAL=0 pour désactiver)
+    static GameJournal *shared();
+    static quint64 newGameId(const QString &gameCode);
+
+    bool append(Record record);     // ne bloque jamais ; false si la file est pleine
+    quint64 droppedRecords() const;
+    QString directory() const;
+
+    static QStringList segmentPaths(const QString &directory);
+    static QVector<Location> findGame(const QString &directory, quint64 gameId);
+
+    // Lecture séquentielle des segments (mmap)
+    class Reader
+    {
+    public:
+        explicit Reader(const QString &directory);
+        explicit Reader(const QStringList &segmentPaths);   // sous-ensemble (lecture en parallèle)
+        ~Reader();
+
+        bool seek(const Location &location);
+        bool next(Record *record);
+
+    private:
+        bool openSegment(int index);
+
+        QStringList segments;
+        int segmentIndex;
+        QFile file;
+        quint32 version;            // du segment ouvert
+        const uchar *data;
+        qint64 size;
+        qint64 position;
+    };
+
+private:
+    void writerLoop();
+    bool openNextSegment();
+    void flushPending();
+
+    QString journalDir;
+    BoundedQueue<Record> queue;
+    std::atomic<bool> running;
+    std::atomic<quint64> dropped;
+    std::thread writer;
+
+    // Côté thread d'écriture uniquement
+    QFile *segmentFile;
+    QFile *indexFile;
+    int segmentNumber;
+    qint64 segmentSize;
+    QByteArray pendingRecords;
+    QByteArray pendingIndex;
+};
+
+#endif // GAMEJOURNAL_H
@@ -0,0 +1,848 @@
+#include "gamesession.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonArray>
+#include <QMessageAuthenticationCode>
+#include <QRandomGenerator>
+#include <QTimer>
+#include <algorithm>
+
+static const quint16 DEFAULT_PORT = 12345;
+static const int HEARTBEAT_INTERVAL_MS = 1000;
+static const int STANDBY_POLL_MS = 250;
+static const int RECONNECT_INTERVAL_MS = 500;
+static const int RECONNECT_ATTEMPTS = 40;      // 20 s pour qu'un secours reprenne le port
+static const int HANDOFF_FLUSH_POLL_MS = 10;
+static const int HANDOFF_FLUSH_ROUNDS = 50;    // 500 ms au plus pour que les écritures partent
+
+static QByteArray newRejoinSecret()
+{
+    // Nouveau secret par partie : un jeton d'une partie précédente ne vaut plus rien
+    QByteArray secret(32, Qt::Uninitialized);
+    QRandomGenerator::system()->fillRange(reinterpret_cast<quint32*>(secret.data()), secret.size() / 4);
+    return secret;
+}
+
+// Temps indépendant du premier octet différent : un client ne devine pas le jeton octet par octet
+static bool tokensEqual(const QString& a, const QString& b)
+{
+    const QByteArray left = a.toLatin1();
+    const QByteArray right = b.toLatin1();
+    if (left.size() != right.size()) {
+        return false;
+    }
+    quint8 difference = 0;
+    for (qsizetype i = 0; i < left.size(); ++i) {
+        difference |= quint8(left.at(i) ^ right.at(i));
+    }
+    return difference == 0;
+}
+
+GameSession::GameSession(QObject *parent, GameClock *clock)
+    : QObject(parent), game(nullptr), networkManager(nullptr), spectatorFeed(nullptr), mediaStreamer(nullptr),
+      questionStore(nullptr),
+      journal(nullptr), journalGameId(0), checkpoint(GameCheckpoint::defaultPath()),
+      handoff(nullptr), handoffPending(false), handoffFlushRounds(0), standbySince(0), reconnectAttempts(0), hostPort(DEFAULT_PORT), isHost(false),
+      inRemoteGame(false), epoch(0)
+{
+    qRegisterMetaType<GameSnapshot>();
+
+    heartbeatTimer = new QTimer(this);
+    heartbeatTimer->setInterval(HEARTBEAT_INTERVAL_MS);
+    connect(heartbeatTimer, &QTimer::timeout, this, [this]() { checkpoint.heartbeat(); });
+
+    standbyTimer = new QTimer(this);
+    standbyTimer->setInterval(STANDBY_POLL_MS);
+    connect(standbyTimer, &QTimer::timeout, this, &GameSession::pollStandby);
+
+    reconnectTimer = new QTimer(this);
+    reconnectTimer->setInterval(RECONNECT_INTERVAL_MS);
+    connect(reconnectTimer, &QTimer::timeout, this, &GameSession::attemptReconnect);
+
+    // Attend que les écritures en cours partent, sans bloquer la boucle
+    handoffFlushTimer = new QTimer(this);
+    handoffFlushTimer->setInterval(HANDOFF_FLUSH_POLL_MS);
+    connect(handoffFlushTimer, &QTimer::timeout, this, [this]() {
+        if (networkManager->outputFlushed() || ++handoffFlushRounds >= HANDOFF_FLUSH_ROUNDS)
+            completeHandoff();
+    });
+
+    handoff = new SocketHandoff(this);
+    connect(handoff, &SocketHandoff::handoffRequested, this, &GameSession::onHandoffRequested);
+    connect(handoff, &SocketHandoff::requestCancelled, this, [this]() { handoffPending = false; });
+    connect(handoff, &SocketHandoff::received, this, &GameSession::onHandoffReceived);
+    connect(handoff, &SocketHandoff::failed, this, &GameSession::handoffFailed);
+
+    // Enfants de la session : ils suivent son moveToThread()
+    game = new Game(this, clock);
+    networkManager = new NetworkManager(this);
+    spectatorFeed = new SpectatorFeed(game, networkManager, this);
+
+    // Créé après Game : les enfants sont détruits dans l'ordre de création,
+    // la partie rend donc son Snapshot avant la destruction du store
+    questionStore = new QuestionStore(qEnvironmentVariable("QUIZZ_BANKS").split(QDir::listSeparator(), Qt::SkipEmptyParts), this);
+    game->setQuestionStore(questionStore);
+    mediaStreamer = new MediaStreamer(game, networkManager, this);
+
+    connect(game, &Game::gameCreated, this, &GameSession::gameCreated);
+    connect(game, &Game::playerJoined, this, &GameSession::playerJoined);
+    connect(game, &Game::playerLeft, this, &GameSession::playerLeft);
+    connect(game, &Game::gameStarted, this, &GameSession::gameStarted);
+    connect(game, &Game::timeUpdate, this, &GameSession::timeUpdate);
+    connect(game, &Game::questionChanged, this, [this](const Question& question) {
+        // Média toujours absent (demande perdue lors d'un passage de relais) : on redemande
+        if (!isHost && inRemoteGame && !question.getMedia().isNull() && !mediaCache.contains(question.getMedia().hash)) {
+            requestedMedia.clear();
+            requestMissingMedia();
+        }
+        emit questionChanged(snapshot());
+    });
+    connect(game, &Game::resultsReady, this, [this](const QMap<QString, bool>&) {
+        if (isHost) {
+            // Classement des équipes : seulement celles qui ont changé, les noms une seule fois
+            const QJsonArray delta = game->takeTeamDelta();
+            if (!delta.isEmpty()) {
+                QJsonObject data;
+                data["teams"] = delta;
+                sendNetworkMessage("team_standings", data);
+            }
+        }
+        emit resultsReady(snapshot());
+    });
+    connect(game, &Game::gameEnded, this, [this](const QString&) {
+        emit gameEnded(snapshot());
+    });
+
+    connectJournal();
+    setupCheckpoints();
+
+    connect(networkManager, &NetworkManager::connectedToHost, this, &GameSession::onConnectedToHost);
+    connect(networkManager, &NetworkManager::disconnectedFromHost, this, &GameSession::onDisconnectedFromHost);
+    connect(networkManager, &NetworkManager::messageReceived, this, &GameSession::onMessageReceived);
+    connect(networkManager, &NetworkManager::answerReceived, this, [this](const QString& name, int answer, const QString&) {
+        // Chemin rapide de "answer" côté hôte : même effet que dans handleNetworkMessage()
+        if (isHost) {
+            game->submitAnswer(name, answer);
+        }
+    });
+    connect(networkManager, &NetworkManager::connectionError, this, [this](const QString& error) {
+        // En partie, une coupure est gérée par la reconnexion (message à l'abandon seulement)
+        if (!inRemoteGame) {
+            emit connectionError(error);
+        }
+    });
+    connect(networkManager, &NetworkManager::serverStarted, this, [](quint16 port) {
+        qDebug() << "Server started on port:" << port;
+    });
+    connect(networkManager, &NetworkManager::clientConnected, this, [](const QString& clientId) {
+        qDebug() << "Client connected:" << clientId;
+    });
+    connect(networkManager, &NetworkManager::clientDisconnected, this, [](const QString& clientId) {
+        qDebug() << "Client disconnected:" << clientId;
+    });
+    connect(networkManager, &NetworkManager::spectatorJoined, this, [](const QString& clientId) {
+        qDebug() << "Spectator joined:" << clientId;
+    });
+}
+
+GameSession::~GameSession()
+{
+}
+
+GameSnapshot GameSession::snapshot() const
+{
+    GameSnapshot s;
+    s.state = game->getState();
+    s.gameCode = game->getGameCode();
+    s.isHost = isHost;
+    s.epoch = epoch;
+    s.questionIndex = game->getCurrentQuestionIndex();
+    s.totalQuestions = game->getTotalQuestions();
+    s.question = game->getCurrentQuestion();
+    const QByteArray& media = s.question.getMedia().hash;
+    if (!s.question.getMedia().isNull()) {
+        // L'hôte lit le fichier de sa banque ; un client (ou un secours) son cache
+        if (isHost) {
+            s.mediaPath = game->getQuestionSnapshot().bank().mediaFile(media);
+        }
+        if (s.mediaPath.isEmpty()) {
+            s.mediaPath = mediaCache.path(media);
+        }
+    }
+    s.scores = game->getPlayerScores();
+    s.winner = game->getWinner();
+    s.teams = game->getTeamStandings().standings(TEAM_ROWS);
+    return s;
+}
+
+void GameSession::hostGame(const QString& name, int theme, const QString& team)
+{
+    playerName = name;
+    playerTeam = team;
+    isHost = true;
+    setupJournal();
+
+    rejoinSecret = newRejoinSecret();
+
+    game->createGame(static_cast<Game::Theme>(theme));
+    game->addPlayer(playerName, playerTeam);
+
+    if (!networkManager->startServer(DEFAULT_PORT)) {
+        emit serverStartFailed();
+        return;
+    }
+    saveCheckpoint();
+    checkpoint.heartbeat();
+    heartbeatTimer->start();
+    handoff->listen(DEFAULT_PORT);
+}
+
+void GameSession::joinGame(const QString& name, const QString& hostAddress, const QString& gameCode,
+                           const QString& team)
+{
+    playerName = name;
+    playerTeam = team;
+    pendingGameCode = gameCode;
+    rejoinToken.clear();
+    isHost = false;
+    requestedMedia.clear();
+
+    // "adresse:port" : hôte sur un autre port (proxy QuizzProxy, plusieurs hôtes sur une machine)
+    this->hostAddress = hostAddress;
+    hostPort = DEFAULT_PORT;
+    const int colon = hostAddress.lastIndexOf(':');
+    if (colon > 0 && hostAddress.count(':') == 1) {
+        bool ok = false;
+        const quint16 port = hostAddress.mid(colon + 1).toUShort(&ok);
+        if (ok && port != 0) {
+            this->hostAddress = hostAddress.left(colon);
+            hostPort = port;
+        }
+    }
+
+    networkManager->connectToHost(this->hostAddress, hostPort);
+}
+
+void GameSession::startGame()
+{
+    if (!isHost) {
+        return;
+    }
+
+    game->startGame();
+    sendNetworkMessage("start_game");
+}
+
+void GameSession::submitAnswer(int answerIndex)
+{
+    game->submitAnswer(playerName, answerIndex);
+
+    // Send answer to network
+    QJsonObject data;
+    data["playerName"] = playerName;
+    data["answer"] = answerIndex;
+    sendNetworkMessage("answer", data);
+}
+
+void GameSession::nextQuestion()
+{
+    if (!isHost) {
+        qDebug() << "ERROR: Non-host tried to click next question!";
+        return;
+    }
+
+    game->nextQuestion();
+    sendNetworkMessage("next_question");
+    qDebug() << "Host processed next question";
+}
+
+void GameSession::leaveGame()
+{
+    // Le point de reprise est laissé en place : un secours (--standby)
+    // reprend la partie au lieu de la détruire pour tous
+    heartbeatTimer->stop();
+    reconnectTimer->stop();
+    handoff->close();
+    handoffPending = false;
+    if (handoffFlushTimer->isActive()) {
+        handoffFlushTimer->stop();
+        networkManager->cancelHandoff();    // fermeture propre, rien n'a été confié
+    }
+    inRemoteGame = false;
+
+    if (networkManager->isServer()) {
+        networkManager->stopServer();
+    } else {
+        networkManager->disconnectFromHost();
+    }
+
+    if (journalGameId != 0) {
+        journalEvent(GameJournal::GAME_ENDED, QStringLiteral("abandon"), -1);
+        journalGameId = 0;
+    }
+
+    game->abortGame();
+    playerName.clear();
+    pendingGameCode.clear();
+    hostAddress.clear();
+    isHost = false;
+
+    // Les signaux déjà en file vers l'interface portent l'ancienne valeur
+    ++epoch;
+    emit gameLeft(epoch);
+}
+
+void GameSession::replayHost(const QString& name, Game::Theme theme, const QVector<Question>& questions)
+{
+    playerName = name;
+    isHost = true;
+    rejoinSecret = newRejoinSecret();
+
+    Game::Checkpoint setup;
+    setup.theme = theme;
+    setup.questions = questions;
+    game->restoreCheckpoint(setup, true);
+    game->addPlayer(playerName);
+}
+
+void GameSession::replayMessage(const QJsonObject& message, const QString& senderId)
+{
+    handleNetworkMessage(message, senderId);
+}
+
+void GameSession::standby()
+{
+    // Seul un hôte vu vivant après notre lancement est repris : un vieux
+    // point de reprise laissé par un arrêt ancien n'est pas ressuscité
+    standbySince = QDateTime::currentMSecsSinceEpoch();
+    standbyTimer->start();
+    qDebug() << "Standby watching" << checkpoint.path();
+}
+
+void GameSession::pollStandby()
+{
+    if (checkpoint.lastHeartbeat() < standbySince) {
+        return;
+    }
+    GameCheckpoint::Record record;
+    if (!checkpoint.load(&record) || !GameCheckpoint::isResumable(record)) {
+        return;
+    }
+    // Tant que l'hôte tient le port, listen() échoue
+    if (!networkManager->tryStartServer(record.port)) {
+        return;
+    }
+    standbyTimer->stop();
+    takeOver(record);
+}
+
+void GameSession::takeOver(const GameCheckpoint::Record& record)
+{
+    qDebug() << "Standby took over game" << record.game.gameCode << "at question" << record.game.questionIndex
+             << "(checkpoint" << record.sequence << ")";
+
+    playerName = record.hostName;
+    isHost = true;
+    setupJournal();
+    journalGameId = record.journalGameId;
+    rejoinSecret = record.rejoinSecret;
+
+    emit tookOver(playerName);
+    emit gameCreated(record.game.gameCode);
+    for (auto it = record.game.scores.cbegin(); it != record.game.scores.cend(); ++it) {
+        emit playerJoined(it.key());
+    }
+    if (record.game.state != Game::WAITING) {
+        emit gameStarted();
+    }
+
+    // Une question interrompue est relancée (questionChanged) ; les clients
+    // la reçoivent à leur reconnexion via resume_game
+    game->restoreCheckpoint(record.game, true);
+    if (record.game.state == Game::SHOWING_RESULTS) {
+        emit resultsReady(snapshot());
+    }
+
+    if (record.game.state == Game::GAME_FINISHED) {
+        emit gameEnded(snapshot());
+    }
+
+    saveCheckpoint();
+    checkpoint.heartbeat();
+    heartbeatTimer->start();
+    handoff->listen(networkManager->getServerPort());
+}
+
+void GameSession::receiveHandoff()
+{
+    QString error;
+    if (!handoff->request(DEFAULT_PORT, &error)) {
+        emit handoffFailed(error);
+    }
+}
+
+void GameSession::onHandoffRequested()
+{
+    // Passage à une frontière de question seulement : rien n'est perdu ni rejoué
+    if (game->getState() == Game::QUESTION_ACTIVE) {
+        qDebug() << "Handoff deferred to the end of the question";
+        handoffPending = true;
+        return;
+    }
+    performHandoff();
+}
+
+void GameSession::performHandoff()
+{
+    handoffPending = false;
+    if (handoffFlushTimer->isActive())
+        return;
+
+    networkManager->beginHandoff();
+    handoffFlushRounds = 0;
+    handoffFlushTimer->start();
+}
+
+void GameSession::completeHandoff()
+{
+    handoffFlushTimer->stop();
+    if (game->getState() == Game::QUESTION_ACTIVE) {
+        // Question lancée pendant la vidange : on retente à ses résultats
+        networkManager->cancelHandoff();
+        handoffPending = true;
+        return;
+    }
+
+    GameCheckpoint::Record record;
+    record.game = game->checkpoint();
+    record.hostName = playerName;
+    record.port = networkManager->getServerPort();
+    record.journalGameId = journalGameId;
+    record.rejoinSecret = rejoinSecret;
+
+    SocketHandoff::Bundle bundle = networkManager->detachForHandoff();
+    bundle.state = GameCheckpoint::encode(record);
+
+    QString error;
+    if (!handoff->send(bundle, &error)) {
+        qWarning() << "Handoff failed, keeping the game:" << error;
+        networkManager->cancelHandoff();
+        handoff->listen(record.port);
+        return;
+    }
+
+    // Le successeur écrit désormais les points de reprise et le journal.
+    // Nos copies des descripteurs sont lâchées tout de suite : sinon Qt
+    // continuerait de lire des octets que le successeur ne verrait jamais.
+    qDebug() << "Game" << record.game.gameCode << "handed off with" << bundle.connections.size() << "connections";
+    networkManager->stopServer();
+    heartbeatTimer->stop();
+    journalGameId = 0;
+    emit handedOff();
+}
+
+void GameSession::onHandoffReceived(const SocketHandoff::Bundle& bundle)
+{
+    GameCheckpoint::Record record;
+    if (!GameCheckpoint::decode(bundle.state, &record)) {
+        SocketHandoff::closeDescriptors(bundle);
+        emit handoffFailed("invalid game state");
+        return;
+    }
+    if (!networkManager->adoptHandoff(bundle)) {
+        emit handoffFailed("server socket not adopted");
+        return;
+    }
+    takeOver(record);
+}
+
+void GameSession::onConnectedToHost()
+{
+    if (reconnectTimer->isActive()) {
+        reconnectTimer->stop();
+        QJsonObject data;
+        data["playerName"] = playerName;
+        data["team"] = playerTeam;
+        data["token"] = rejoinToken;
+        sendNetworkMessage("rejoin_game", data);
+        return;
+    }
+
+    // Join the game
+    QJsonObject data;
+    data["playerName"] = playerName;
+    data["gameCode"] = pendingGameCode;
+    data["team"] = playerTeam;
+    sendNetworkMessage("join_game", data);
+}
+
+void GameSession::onMessageReceived(const QJsonObject& message, const QString& senderId)
+{
+    handleNetworkMessage(message, senderId);
+}
+
+void GameSession::onDisconnectedFromHost()
+{
+    if (isHost || !inRemoteGame || reconnectTimer->isActive() || game->getState() == Game::GAME_FINISHED) {
+        return;
+    }
+    qDebug() << "Connection to host lost, reconnecting to" << hostAddress;
+    reconnectAttempts = 0;
+    reconnectTimer->start();
+}
+
+void GameSession::attemptReconnect()
+{
+    if (++reconnectAttempts > RECONNECT_ATTEMPTS) {
+        reconnectTimer->stop();
+        inRemoteGame = false;
+        emit connectionError("Connexion à l'hôte perdue");
+        return;
+    }
+    networkManager->connectToHost(hostAddress, hostPort);
+}
+
+void GameSession::setupCheckpoints()
+{
+    // Un point par frontière de question (et par changement de salle) :
+    // les réponses en cours ne sont jamais sauvegardées
+    connect(game, &Game::playerJoined, this, &GameSession::saveCheckpoint);
+    connect(game, &Game::playerLeft, this, &GameSession::saveCheckpoint);
+    connect(game, &Game::questionChanged, this, &GameSession::saveCheckpoint);
+    connect(game, &Game::resultsReady, this, &GameSession::saveCheckpoint);
+    connect(game, &Game::resultsReady, this, [this]() {
+        // Après les autres réactions aux résultats (diffusion, journal, point de reprise)
+        QMetaObject::invokeMethod(this, [this]() {
+            if (handoffPending) {
+                performHandoff();
+            }
+        }, Qt::QueuedConnection);
+    });
+    connect(game, &Game::gameEnded, this, [this]() {
+        // Comme saveCheckpoint() : un hôte sans serveur (rejeu) ne touche pas au fichier
+        if (isHost && networkManager->isServer()) {
+            heartbeatTimer->stop();
+            checkpoint.clear();
+        }
+    });
+}
+
+void GameSession::saveCheckpoint()
+{
+    if (!isHost || !networkManager->isServer()) {
+        return;
+    }
+
+    GameCheckpoint::Record record;
+    record.game = game->checkpoint();
+    record.hostName = playerName;
+    record.port = networkManager->getServerPort();
+    record.journalGameId = journalGameId;
+    record.rejoinSecret = rejoinSecret;
+    checkpoint.save(record);
+}
+
+void GameSession::setupJournal()
+{
+    // Ouvert seulement par un hôte : clients, secours en attente et successeurs
+    // pas encore aux commandes n'ont ni thread d'écriture ni segment à eux
+    if (!journal) {
+        journal = GameJournal::shared();
+    }
+}
+
+void GameSession::connectJournal()
+{
+    // Seul l'hôte fait autorité : les clients ne journalisent rien
+    connect(game, &Game::gameCreated, this, [this](const QString& code) {
+        if (!isHost) {
+            return;
+        }
+        journalGameId = GameJournal::newGameId(code);
+        journalEvent(GameJournal::GAME_CREATED, code, static_cast<int>(game->getSelectedTheme()));
+    });
+    connect(game, &Game::playerJoined, this, [this](const QString& name) {
+        journalEvent(GameJournal::PLAYER_JOINED, name);
+    });
+    connect(game, &Game::playerLeft, this, [this](const QString& name) {
+        journalEvent(GameJournal::PLAYER_LEFT, name);
+    });
+    connect(game, &Game::questionChanged, this, [this](const Question&) {
+        journalEvent(GameJournal::QUESTION_SHOWN, QString(), game->getTotalQuestions());
+    });
+    connect(game, &Game::answerSubmitted, this, [this](const QString& name, int answer) {
+        const bool correct = game->getCurrentQuestion().isCorrect(answer);
+        journalEvent(GameJournal::ANSWER_SUBMITTED, name, qint32(game->getAnswerTime(name)),
+                     qint16(answer), correct ? GameJournal::FLAG_CORRECT : 0);
+    });
+    connect(game, &Game::resultsReady, this, [this](const QMap<QString, bool>& results) {
+        const int correctCount = std::count(results.cbegin(), results.cend(), true);
+        journalEvent(GameJournal::QUESTION_RESULTS, QString(), correctCount,
+                     qint16(game->getCurrentQuestion().getCorrectAnswerIndex()));
+    });
+    connect(game, &Game::gameEnded, this, [this](const QString& winner) {
+        const QMap<QString, int> scores = game->getPlayerScores();
+        for (auto it = scores.cbegin(); it != scores.cend(); ++it) {
+            journalEvent(GameJournal::FINAL_SCORE, it.key(), it.value());
+        }
+        journalEvent(GameJournal::GAME_ENDED, winner, scores.size());
+        journalGameId = 0;
+    });
+}
+
+QString GameSession::rejoinTokenFor(const QString& name) const
+{
+    if (rejoinSecret.isEmpty()) {
+        return QString();
+    }
+    return QString::fromLatin1(QMessageAuthenticationCode::hash(name.toUtf8(), rejoinSecret,
+                                                                QCryptographicHash::Sha256).toHex());
+}
+
+void GameSession::journalEvent(GameJournal::EventType type, const QString& text, qint32 value,
+                               qint16 answerIndex, quint8 flags)
+{
+    if (!journal || journalGameId == 0) {
+        return;
+    }
+
+    GameJournal::Record record;
+    record.type = type;
+    record.flags = flags;
+    record.answerIndex = answerIndex;
+    record.gameId = journalGameId;
+    record.value = value;
+    if (game->getState() != Game::WAITING) {
+        record.questionIndex = quint16(game->getCurrentQuestionIndex());
+        record.questionId = game->getCurrentQuestion().getId();
+    }
+    record.setText(text);
+    journal->append(record);
+}
+
+QJsonArray GameSession::questionsToJson(const QVector<Question>& questions)
+{
+    QJsonArray array;
+    for (const Question& question : questions) {
+        QJsonObject object;
+        object["question"] = question.getQuestionText();
+        object["answers"] = QJsonArray::fromStringList(question.getAnswers());
+        object["correct"] = question.getCorrectAnswerIndex();
+        const Question::Media& media = question.getMedia();
+        if (!media.isNull()) {
+            // L'empreinte seulement : les octets passent par asset_request / asset_chunk
+            QJsonObject asset;
+            asset["kind"] = static_cast<int>(media.kind);
+            asset["hash"] = QString::fromLatin1(media.hash.toHex());
+            asset["size"] = static_cast<double>(media.size);
+            object["media"] = asset;
+        }
+        array.append(object);
+    }
+    return array;
+}
+
+QVector<Question> GameSession::questionsFromJson(const QJsonArray& array)
+{
+    QVector<Question> questions;
+    questions.reserve(array.size());
+    for (const QJsonValue& value : array) {
+        const QJsonObject object = value.toObject();
+        QStringList answers;
+        for (const QJsonValue& answer : object["answers"].toArray()) {
+            answers.append(answer.toString());
+        }
+        const int correct = object["correct"].toInt(-1);
+        if (answers.size() != 4 || correct < 0 || correct >= answers.size()) {
+            return QVector<Question>();   // liste invalide : packs intégrés
+        }
+        Question question(object["question"].toString(), answers, correct);
+        const QJsonObject asset = object["media"].toObject();
+        const int kind = asset["kind"].toInt();
+        if (kind > Question::Media::NONE && kind <= Question::Media::AUDIO) {
+            Question::Media media;
+            media.kind = static_cast<Question::Media::Kind>(kind);
+            media.hash = QByteArray::fromHex(asset["hash"].toString().toLatin1());
+            media.size = static_cast<qint64>(asset["size"].toDouble());
+            if (media.hash.size() == 32 && media.size > 0) {
+                question.setMedia(media);
+            }
+        }
+        questions.append(question);
+    }
+    return questions;
+}
+
+void GameSession::requestMissingMedia()
+{
+    // Questions restantes dans l'ordre : la prochaine arrive la première
+    const QVector<Question> questions = game->getQuestions();
+    QJsonArray assets;
+    for (int i = qMax(0, game->getCurrentQuestionIndex()); i < questions.size(); ++i) {
+        const Question::Media& media = questions.at(i).getMedia();
+        if (media.isNull() || requestedMedia.contains(media.hash) || mediaCache.contains(media.hash)) {
+            continue;
+        }
+        requestedMedia.insert(media.hash);
+        QJsonObject asset;
+        asset["hash"] = QString::fromLatin1(media.hash.toHex());
+        asset["offset"] = static_cast<double>(mediaCache.receivedBytes(media.hash));
+        assets.append(asset);
+    }
+    if (!assets.isEmpty()) {
+        QJsonObject data;
+        data["assets"] = assets;
+        sendNetworkMessage("asset_request", data);
+    }
+}
+
+void GameSession::receiveMediaChunk(const QJsonObject& data)
+{
+    const QByteArray hash = QByteArray::fromHex(data["hash"].toString().toLatin1());
+    const MediaCache::WriteResult result = mediaCache.write(hash, static_cast<qint64>(data["offset"].toDouble()),
+                                                            QByteArray::fromBase64(data["data"].toString().toLatin1()),
+                                                            static_cast<qint64>(data["size"].toDouble()));
+    if (result == MediaCache::REJECTED) {
+        requestedMedia.remove(hash);      // redemandé au prochain setup_game ou à la reconnexion
+        qDebug() << "Media chunk rejected:" << data["hash"].toString();
+    }
+    else if (result == MediaCache::COMPLETE && game->getState() == Game::QUESTION_ACTIVE
+             && game->getCurrentQuestion().getMedia().hash == hash) {
+        emit mediaReady(snapshot());
+    }
+}
+
+void GameSession::sendNetworkMessage(const QString& type, const QJsonObject& data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    message["sender"] = playerName;
+
+    networkManager->sendMessage(message);
+}
+
+void GameSession::sendNetworkMessageTo(const QString& clientId, const QString& type, const QJsonObject& data)
+{
+    QJsonObject message;
+    message["type"] = type;
+    message["data"] = data;
+    message["sender"] = playerName;
+
+    networkManager->sendMessageTo(clientId, message);
+}
+
+void GameSession::handleNetworkMessage(const QJsonObject& message, const QString& senderId)
+{
+    QString type = message["type"].toString();
+    QJsonObject data = message["data"].toObject();
+
+    qDebug() << "Received network message:" << type << "from:" << senderId;
+
+    if (type == "join_game") {
+        QString joiningPlayer = data["playerName"].toString();
+        const bool known = game->getPlayerScores().contains(joiningPlayer);
+        // Les équipes sont créées par l'hôte seul : ses ids font foi
+        game->addPlayer(joiningPlayer, isHost ? data["team"].toString() : QString());
+
+        // --- AJOUT : uniquement côté hôte, on diffuse le thème ---
+        if (isHost) {
+            // Jeton de reconnexion pour ce seul client ; un nom déjà pris n'en reçoit pas
+            if (!known) {
+                QJsonObject token;
+                token["token"] = rejoinTokenFor(joiningPlayer);
+                sendNetworkMessageTo(senderId, "rejoin_token", token);
+            }
+
+            QJsonObject info;
+            info["theme"] = static_cast<int>(game->getSelectedTheme());
+            info["questions"] = questionsToJson(game->getQuestions());
+            info["teams"] = game->getTeamStandings().toJson();
+            sendNetworkMessage("setup_game", info);
+        }
+    }
+    else if (type == "setup_game" && !isHost) {
+        int themeId = data["theme"].toInt();
+        game->setupClientGame(static_cast<Game::Theme>(themeId), questionsFromJson(data["questions"].toArray()));
+        game->applyTeamStandings(data["teams"].toArray(), true);
+        game->addPlayer(playerName);          // s’ajouter soi-même
+        inRemoteGame = true;
+        requestMissingMedia();
+    }
+    else if (type == "rejoin_game" && isHost) {
+        // Client revenu après une coupure (ou une reprise par le secours) :
+        // seul le détenteur du jeton reçu à l'inscription reprend ce joueur
+        const QString rejoiningPlayer = data["playerName"].toString();
+        const QString expected = rejoinTokenFor(rejoiningPlayer);
+        if (rejoiningPlayer.isEmpty() || expected.isEmpty() || !tokensEqual(data["token"].toString(), expected)) {
+            qDebug() << "Rejected rejoin_game for" << rejoiningPlayer << "from" << senderId;
+            return;
+        }
+        game->addPlayer(rejoiningPlayer, data["team"].toString());
+        GameCheckpoint::Record record;
+        record.game = game->checkpoint();
+        record.hostName = playerName;
+        QJsonObject resume;
+        resume["checkpoint"] = QString::fromLatin1(GameCheckpoint::encode(record).toBase64());
+        resume["remainingMs"] = double(game->questionRemainingMs());
+        sendNetworkMessageTo(senderId, "resume_game", resume);
+    }
+    else if (type == "rejoin_token" && !isHost) {
+        rejoinToken = data["token"].toString();
+    }
+    else if (type == "resume_game" && !isHost) {
+        GameCheckpoint::Record record;
+        if (!GameCheckpoint::decode(QByteArray::fromBase64(data["checkpoint"].toString().toLatin1()), &record)) {
+            qDebug() << "Invalid resume_game checkpoint";
+            return;
+        }
+        // Question en cours : le chrono reprend où en est celui de l'hôte
+        game->restoreCheckpoint(record.game, false, qint64(data["remainingMs"].toDouble(-1)));
+        // Reconnexion : les téléchargements interrompus reprennent où ils en étaient
+        requestedMedia.clear();
+        requestMissingMedia();
+        if (record.game.state == Game::SHOWING_RESULTS) {
+            emit resultsReady(snapshot());
+        }
+    }
+    else if (type == "asset_request" && isHost) {
+        mediaStreamer->request(senderId, data["assets"].toArray());
+    }
+    else if (type == "asset_chunk" && !isHost) {
+        receiveMediaChunk(data);
+    }
+    else if (type == "team_standings" && !isHost) {
+        if (!game->applyTeamStandings(data["teams"].toArray(), false)) {
+            qDebug() << "Invalid team_standings delta";
+            return;
+        }
+        // Arrivé après nos propres résultats : la vue se met à jour
+        if (game->getState() == Game::SHOWING_RESULTS) {
+            emit resultsReady(snapshot());
+        }
+    }
+    else if (type == "start_game") {
+        if (!isHost) {
+            qDebug() << "Client received start_game message";
+            game->startGame();
+        }
+    }
+    else if (type == "answer") {
+        QString answeringPlayer = data["playerName"].toString();
+        int answer = data["answer"].toInt();
+        if (isHost) {
+            game->submitAnswer(answeringPlayer, answer);
+        }
+    }
+    else if (type == "next_question") {
+        qDebug() << "Received next_question message, isHost:" << isHost;
+        if (!isHost) {
+            qDebug() << "Client processing next question";
+            game->nextQuestion();
+        } else {
+            qDebug() << "Host ignoring next_question message (already processed)";
+        }
+    }
+}
@@ -0,0 +1,152 @@
+#ifndef GAMESESSION_H
+#define GAMESESSION_H
+
+#include <QObject>
+#include <QString>
+#include <QMap>
+#include <QJsonObject>
+#include <QJsonArray>
+#include <QMetaType>
+#include <QSet>
+#include "game.h"
+#include "networkmanager.h"
+#include "spectatorfeed.h"
+#include "mediastreamer.h"
+#include "mediacache.h"
+#include "gamejournal.h"
+#include "gamecheckpoint.h"
+#include "questionstore.h"
+
+class QTimer;
+
+// Copie immuable de l'état d'une partie, envoyée à la vue par signal
+// (les conteneurs Qt sont partagés implicitement : copie quasi gratuite).
+struct GameSnapshot
+{
+    Game::GameState state = Game::WAITING;
+    QString gameCode;
+    bool isHost = false;
+    int questionIndex = 0;
+    int totalQuestions = 0;
+    Question question;
+    QString mediaPath;              // fichier local du média de la question, vide s'il manque encore
+    QMap<QString, int> scores;
+    QString winner;
+    QVector<TeamStandings::Standing> teams;     // les TEAM_ROWS premières, vide hors mode équipes
+    quint64 epoch = 0;              // partie de la session, incrémentée par leaveGame()
+};
+
+Q_DECLARE_METATYPE(GameSnapshot)
+
+// Coeur du jeu : Game + NetworkManager + traitement des messages.
+// Vit sur un thread dédié ; MainWindow ne lui parle que par appels
+// en file (QMetaObject::invokeMethod) et par signaux.
+class GameSession : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int TEAM_ROWS = 10;
+
+    // clock null : temps réel (voir Game)
+    explicit GameSession(QObject *parent = nullptr, GameClock *clock = nullptr);
+    ~GameSession();
+
+    GameSnapshot snapshot() const;
+
+    // Rejeu hors ligne (QuizzReplay) : hôte sans serveur, ni journal ni point
+    // de reprise, sur les questions de la partie capturée. Les messages des
+    // joueurs passent par le même traitement qu'en partie.
+    void replayHost(const QString& hostName, Game::Theme theme, const QVector<Question>& questions);
+    void replayMessage(const QJsonObject& message, const QString& senderId);
+
+    QString rejoinTokenFor(const QString& name) const;     // hôte ; vide sans secret
+    static QVector<Question> questionsFromJson(const QJsonArray& array);
+
+public slots:
+    void hostGame(const QString& playerName, int theme, const QString& team = QString());
+    void joinGame(const QString& playerName, const QString& hostAddress, const QString& gameCode,
+                  const QString& team = QString());
+    void startGame();
+    void submitAnswer(int answerIndex);
+    void nextQuestion();
+    void leaveGame();
+    void standby();                 // secours : reprend la partie si l'hôte disparaît
+    void receiveHandoff();          // nouvelle version : reprend sockets et partie de l'hôte en cours
+
+signals:
+    void tookOver(const QString& playerName);
+    void handedOff();               // sockets et partie confiées au successeur
+    void handoffFailed(const QString& error);
+    void gameLeft(quint64 epoch);   // tout signal émis avant appartient à la partie quittée
+    void gameCreated(const QString& code);
+    void playerJoined(const QString& playerName);
+    void playerLeft(const QString& playerName);
+    void gameStarted();
+    void questionChanged(const GameSnapshot& snapshot);
+    void mediaReady(const GameSnapshot& snapshot);      // média de la question en cours arrivé après elle
+    void timeUpdate(int secondsLeft);
+    void resultsReady(const GameSnapshot& snapshot);
+    void gameEnded(const GameSnapshot& snapshot);
+    void serverStartFailed();
+    void connectionError(const QString& error);
+
+private slots:
+    void onConnectedToHost();
+    void onMessageReceived(const QJsonObject& message, const QString& senderId);
+    void onDisconnectedFromHost();
+    void attemptReconnect();
+    void pollStandby();
+    void onHandoffRequested();
+    void performHandoff();
+    void completeHandoff();
+    void onHandoffReceived(const SocketHandoff::Bundle& bundle);
+
+private:
+    void sendNetworkMessage(const QString& type, const QJsonObject& data = QJsonObject());
+    void sendNetworkMessageTo(const QString& clientId, const QString& type, const QJsonObject& data);
+    void handleNetworkMessage(const QJsonObject& message, const QString& senderId);
+    void setupJournal();            // ouvre le journal, à l'hébergement ou à la reprise
+    void connectJournal();
+    void setupCheckpoints();
+    void saveCheckpoint();
+    void requestMissingMedia();
+    void receiveMediaChunk(const QJsonObject& data);
+    void takeOver(const GameCheckpoint::Record& record);
+    static QJsonArray questionsToJson(const QVector<Question>& questions);
+    void journalEvent(GameJournal::EventType type, const QString& text = QString(), qint32 value = 0,
+                      qint16 answerIndex = -1, quint8 flags = 0);
+
+    Game* game;
+    NetworkManager* networkManager;
+    SpectatorFeed* spectatorFeed;
+    MediaStreamer* mediaStreamer;
+    QuestionStore* questionStore;
+    GameJournal* journal;           // null si désactivé ou si l'on n'a jamais hébergé
+    quint64 journalGameId;          // 0 hors partie hébergée
+    GameCheckpoint checkpoint;
+    MediaCache mediaCache;          // client : médias reçus, partagés entre parties
+    QSet<QByteArray> requestedMedia;    // déjà demandés depuis la dernière (re)connexion
+    SocketHandoff* handoff;
+    bool handoffPending;            // demandé en pleine question : fait aux résultats
+    QTimer* handoffFlushTimer;      // vidange des écritures avant de confier les sockets
+    int handoffFlushRounds;
+    QTimer* heartbeatTimer;         // actif tant qu'on héberge une partie
+    QTimer* standbyTimer;
+    qint64 standbySince;
+    QTimer* reconnectTimer;
+    int reconnectAttempts;
+
+    QString playerName;
+    QString playerTeam;             // vide : pas d'équipe
+    QString pendingGameCode;
+    QString rejoinToken;            // client : remis par l'hôte à l'inscription
+    QByteArray rejoinSecret;        // hôte : repris avec la partie par un secours ou un successeur
+    QString hostAddress;
+    quint16 hostPort;
+    bool isHost;
+    bool inRemoteGame;              // client admis par l'hôte : reconnexion si coupure
+    quint64 epoch;
+};
+
+#endif // GAMESESSION_H
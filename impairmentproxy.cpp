@@ -0,0 +1,308 @@
+#include "impairmentproxy.h"
+#include <QRandomGenerator>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QDebug>
+#include <algorithm>
+
+#ifdef Q_OS_UNIX
+#include <sys/socket.h>
+#endif
+
+ImpairmentProxy::ImpairmentProxy(QObject *parent)
+    : QObject(parent), server(nullptr), targetPort(0), nextId(1)
+{
+    clock.start();
+    chaosTimer = new QTimer(this);
+    chaosTimer->setInterval(CHAOS_TICK_MS);
+    connect(chaosTimer, &QTimer::timeout, this, &ImpairmentProxy::onChaosTick);
+}
+
+ImpairmentProxy::~ImpairmentProxy()
+{
+    close();
+}
+
+bool ImpairmentProxy::listen(quint16 port, const QString &host, quint16 hostPort, QString *error)
+{
+    close();
+    targetHost = host;
+    targetPort = hostPort;
+
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &ImpairmentProxy::onNewConnection);
+    if (!server->listen(QHostAddress::Any, port)) {
+        *error = server->errorString();
+        delete server;
+        server = nullptr;
+        return false;
+    }
+    return true;
+}
+
+quint16 ImpairmentProxy::port() const
+{
+    return server ? server->serverPort() : 0;
+}
+
+void ImpairmentProxy::close()
+{
+    const QList<Connection *> connections = active.values();
+    for (Connection *connection : connections)
+        finish(connection, false);
+    if (server) {
+        server->close();
+        delete server;
+        server = nullptr;
+    }
+    chaosTimer->stop();
+}
+
+void ImpairmentProxy::setDefaultProfile(const Profile &profile)
+{
+    defaults = profile;
+    updateChaosTimer();
+}
+
+ImpairmentProxy::Profile ImpairmentProxy::defaultProfile() const
+{
+    return defaults;
+}
+
+bool ImpairmentProxy::setProfile(quint32 id, const Profile &profile)
+{
+    Connection *connection = active.value(id);
+    if (!connection)
+        return false;
+    connection->customProfile = true;
+    connection->profile = profile;
+    updateChaosTimer();
+    return true;
+}
+
+ImpairmentProxy::Profile ImpairmentProxy::profile(quint32 id) const
+{
+    const Connection *connection = active.value(id);
+    return connection ? profileFor(connection) : defaults;
+}
+
+const ImpairmentProxy::Profile &ImpairmentProxy::profileFor(const Connection *connection) const
+{
+    return connection->customProfile ? connection->profile : defaults;
+}
+
+QList<ImpairmentProxy::ConnectionInfo> ImpairmentProxy::connections() const
+{
+    QList<ConnectionInfo> list;
+    for (const Connection *connection : active) {
+        ConnectionInfo info;
+        info.id = connection->id;
+        info.peer = connection->peer;
+        info.bytesUp = connection->up.bytes;
+        info.bytesDown = connection->down.bytes;
+        info.queuedBytes = connection->up.queuedBytes + connection->down.queuedBytes;
+        list.append(info);
+    }
+    std::sort(list.begin(), list.end(), [](const ConnectionInfo &a, const ConnectionInfo &b) { return a.id < b.id; });
+    return list;
+}
+
+void ImpairmentProxy::stall(quint32 id, int ms)
+{
+    const qint64 until = clock.elapsed() + ms;
+    for (Connection *connection : std::as_const(active)) {
+        if (id != 0 && connection->id != id)
+            continue;
+        connection->stalledUntilMs = qMax(connection->stalledUntilMs, until);
+        schedulePump(connection, clock.elapsed());
+    }
+}
+
+void ImpairmentProxy::reset(quint32 id)
+{
+    const QList<Connection *> connections = active.values();
+    for (Connection *connection : connections) {
+        if (id == 0 || connection->id == id)
+            finish(connection, true);
+    }
+}
+
+void ImpairmentProxy::onNewConnection()
+{
+    while (server->hasPendingConnections()) {
+        Connection *connection = new Connection;
+        connection->id = nextId++;
+        connection->client = server->nextPendingConnection();
+        connection->peer = QString("%1:%2").arg(connection->client->peerAddress().toString())
+                                           .arg(connection->client->peerPort());
+        connection->upstream = new QTcpSocket(this);
+        connection->upstream->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connection->client->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+        connection->pump = new QTimer(this);
+        connection->pump->setSingleShot(true);
+        connection->pump->setTimerType(Qt::PreciseTimer);
+        active.insert(connection->id, connection);
+
+        connect(connection->pump, &QTimer::timeout, this, [this, connection]() { pump(connection); });
+        connect(connection->client, &QTcpSocket::readyRead, this, [this, connection]() { onReadable(connection, true); });
+        connect(connection->upstream, &QTcpSocket::readyRead, this, [this, connection]() { onReadable(connection, false); });
+        connect(connection->client, &QTcpSocket::disconnected, this, [this, connection]() { onSourceClosed(connection, true); });
+        connect(connection->upstream, &QTcpSocket::disconnected, this, [this, connection]() { onSourceClosed(connection, false); });
+        // Hôte injoignable : le client voit la connexion se fermer, comme sans proxy
+        connect(connection->upstream, &QTcpSocket::errorOccurred, this, [this, connection](QAbstractSocket::SocketError error) {
+            if (error != QAbstractSocket::RemoteHostClosedError)
+                finish(connection, false);
+        });
+
+        // Écrit en file par Qt tant que la connexion montante s'établit
+        connection->upstream->connectToHost(targetHost, targetPort);
+        updateChaosTimer();
+        emit connectionOpened(connection->id, connection->peer);
+    }
+}
+
+void ImpairmentProxy::onReadable(Connection *connection, bool fromClient)
+{
+    QTcpSocket *source = fromClient ? connection->client : connection->upstream;
+    enqueue(connection, fromClient ? connection->up : connection->down, source->readAll());
+}
+
+void ImpairmentProxy::enqueue(Connection *connection, Direction &direction, const QByteArray &data)
+{
+    if (data.isEmpty())
+        return;
+
+    const Profile &profile = profileFor(connection);
+    const qint64 now = clock.elapsed();
+    int delay = profile.latencyMs;
+    if (profile.jitterMs > 0)
+        delay += int(QRandomGenerator::global()->bounded(2 * profile.jitterMs + 1)) - profile.jitterMs;
+    const qint64 arrival = qMax(now + qMax(0, delay), direction.lastReleaseMs);
+
+    if (profile.bandwidth <= 0) {
+        direction.queue.enqueue(Chunk{data, arrival});
+        direction.lastReleaseMs = arrival;
+    } else {
+        // Sérialisation sur le lien : chaque segment attend la fin du précédent
+        for (qsizetype offset = 0; offset < data.size(); offset += SEGMENT_SIZE) {
+            const QByteArray segment = data.mid(offset, SEGMENT_SIZE);
+            const double start = qMax(double(arrival), direction.linkFreeAtMs);
+            direction.linkFreeAtMs = start + double(segment.size()) * 1000.0 / double(profile.bandwidth);
+            direction.lastReleaseMs = qint64(direction.linkFreeAtMs);
+            direction.queue.enqueue(Chunk{segment, direction.lastReleaseMs});
+        }
+    }
+    direction.queuedBytes += data.size();
+    schedulePump(connection, now);
+}
+
+void ImpairmentProxy::pump(Connection *connection)
+{
+    const qint64 now = clock.elapsed();
+    if (now >= connection->stalledUntilMs) {
+        const bool upDone = drain(connection->up, connection->upstream, now);
+        const bool downDone = drain(connection->down, connection->client, now);
+
+        // Un côté fermé : ce qu'il avait envoyé est livré, puis l'autre est fermé à son tour
+        if ((connection->up.sourceClosed && upDone) || (connection->down.sourceClosed && downDone)) {
+            finish(connection, false);
+            return;
+        }
+    }
+    schedulePump(connection, now);
+}
+
+bool ImpairmentProxy::drain(Direction &direction, QTcpSocket *target, qint64 now)
+{
+    while (!direction.queue.isEmpty() && direction.queue.head().releaseAtMs <= now) {
+        const Chunk chunk = direction.queue.dequeue();
+        direction.queuedBytes -= chunk.data.size();
+        direction.bytes += quint64(chunk.data.size());
+        target->write(chunk.data);
+    }
+    return direction.queue.isEmpty();
+}
+
+void ImpairmentProxy::schedulePump(Connection *connection, qint64 now)
+{
+    qint64 next = -1;
+    for (const Direction *direction : {&connection->up, &connection->down}) {
+        if (!direction->queue.isEmpty()) {
+            const qint64 due = direction->queue.head().releaseAtMs;
+            next = next < 0 ? due : qMin(next, due);
+        }
+    }
+    if (next < 0 && !connection->up.sourceClosed && !connection->down.sourceClosed)
+        return;
+
+    next = qMax(qMax(next, now), connection->stalledUntilMs);
+    connection->pump->start(int(next - now));
+}
+
+void ImpairmentProxy::onSourceClosed(Connection *connection, bool fromClient)
+{
+    onReadable(connection, fromClient);
+    (fromClient ? connection->up : connection->down).sourceClosed = true;
+    schedulePump(connection, clock.elapsed());
+}
+
+void ImpairmentProxy::finish(Connection *connection, bool hard)
+{
+    active.remove(connection->id);
+    for (QTcpSocket *socket : {connection->client, connection->upstream}) {
+        disconnect(socket, nullptr, this, nullptr);
+        if (hard) {
+#ifdef Q_OS_UNIX
+            // SO_LINGER à 0 : la fermeture envoie un RST, comme une box qui décroche
+            const linger option = {1, 0};
+            ::setsockopt(int(socket->socketDescriptor()), SOL_SOCKET, SO_LINGER, &option, sizeof(option));
+#endif
+            socket->abort();
+        } else {
+            socket->disconnectFromHost();
+        }
+        socket->deleteLater();
+    }
+    connection->pump->stop();
+    connection->pump->deleteLater();
+
+    const quint32 id = connection->id;
+    delete connection;
+    updateChaosTimer();
+    emit connectionClosed(id);
+}
+
+void ImpairmentProxy::onChaosTick()
+{
+    // Probabilité par tick d'un événement de fréquence moyenne donnée (par minute)
+    const double ticksPerMinute = 60000.0 / CHAOS_TICK_MS;
+    const QList<Connection *> connections = active.values();
+    for (Connection *connection : connections) {
+        const Profile &profile = profileFor(connection);
+        if (profile.resetsPerMinute > 0
+            && QRandomGenerator::global()->generateDouble() < profile.resetsPerMinute / ticksPerMinute) {
+            qDebug() << "Impairment: reset of connection" << connection->id;
+            finish(connection, true);
+            continue;
+        }
+        if (profile.stallsPerMinute > 0 && profile.stallMs > 0
+            && QRandomGenerator::global()->generateDouble() < profile.stallsPerMinute / ticksPerMinute) {
+            connection->stalledUntilMs = clock.elapsed() + profile.stallMs;
+            schedulePump(connection, clock.elapsed());
+        }
+    }
+}
+
+void ImpairmentProxy::updateChaosTimer()
+{
+    bool needed = false;
+    for (const Connection *connection : std::as_const(active)) {
+        const Profile &profile = profileFor(connection);
+        needed = needed || profile.resetsPerMinute > 0 || (profile.stallsPerMinute > 0 && profile.stallMs > 0);
+    }
+    if (needed && !chaosTimer->isActive())
+        chaosTimer->start();
+    else if (!needed)
+        chaosTimer->stop();
+}
@@ -0,0 +1,120 @@
+#ifndef IMPAIRMENTPROXY_H
+#define IMPAIRMENTPROXY_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QHash>
+#include <QList>
+#include <QQueue>
+#include <QString>
+
+class QTcpServer;
+class QTcpSocket;
+class QTimer;
+
+// Proxy TCP local qui dégrade le lien entre des clients et un hôte
+// NetworkManager : latence, gigue, débit plafonné, gels et coupures, par
+// connexion. Sert à observer le compte à rebours, la fin de question et la
+// reconnexion dans des conditions proches de la 4G ou d'un VPN.
+//
+// Les données ne sont jamais réordonnées (on reste du TCP) : la gigue ne
+// fait que retarder plus ou moins chaque bloc derrière le précédent.
+class ImpairmentProxy : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Profile {
+        int latencyMs = 0;              // par sens
+        int jitterMs = 0;               // ± uniforme autour de la latence
+        qint64 bandwidth = 0;           // octets/s par sens, 0 : illimité
+        double stallsPerMinute = 0.0;   // gels aléatoires...
+        int stallMs = 0;                // ... de cette durée
+        double resetsPerMinute = 0.0;   // coupures brutales (RST)
+    };
+
+    struct ConnectionInfo {
+        quint32 id = 0;
+        QString peer;
+        quint64 bytesUp = 0;            // client -> hôte
+        quint64 bytesDown = 0;
+        qint64 queuedBytes = 0;         // retenus par le proxy
+    };
+
+    static constexpr int SEGMENT_SIZE = 1400;       // découpage quand le débit est plafonné
+    static constexpr int CHAOS_TICK_MS = 100;
+
+    explicit ImpairmentProxy(QObject *parent = nullptr);
+    ~ImpairmentProxy();
+
+    bool listen(quint16 port, const QString &targetHost, quint16 targetPort, QString *error);
+    quint16 port() const;
+    void close();
+
+    // Profil des connexions qui n'en ont pas reçu un en propre
+    void setDefaultProfile(const Profile &profile);
+    Profile defaultProfile() const;
+    bool setProfile(quint32 connection, const Profile &profile);
+    Profile profile(quint32 connection) const;
+
+    QList<ConnectionInfo> connections() const;
+
+    // connection == 0 : toutes les connexions
+    void stall(quint32 connection, int ms);
+    void reset(quint32 connection);
+
+signals:
+    void connectionOpened(quint32 connection, const QString &peer);
+    void connectionClosed(quint32 connection);
+
+private:
+    struct Chunk {
+        QByteArray data;
+        qint64 releaseAtMs;
+    };
+
+    struct Direction {
+        QQueue<Chunk> queue;
+        qint64 queuedBytes = 0;
+        qint64 lastReleaseMs = 0;       // ordre préservé malgré la gigue
+        double linkFreeAtMs = 0.0;      // fin d'émission du dernier segment
+        quint64 bytes = 0;
+        bool sourceClosed = false;
+    };
+
+    struct Connection {
+        quint32 id = 0;
+        QString peer;
+        QTcpSocket *client = nullptr;
+        QTcpSocket *upstream = nullptr;
+        Direction up;                   // client -> hôte
+        Direction down;
+        bool customProfile = false;
+        Profile profile;
+        qint64 stalledUntilMs = 0;
+        QTimer *pump = nullptr;
+    };
+
+    void onNewConnection();
+    void onReadable(Connection *connection, bool fromClient);
+    void onSourceClosed(Connection *connection, bool fromClient);
+    void enqueue(Connection *connection, Direction &direction, const QByteArray &data);
+    void pump(Connection *connection);
+    bool drain(Direction &direction, QTcpSocket *target, qint64 now);
+    void schedulePump(Connection *connection, qint64 now);
+    void finish(Connection *connection, bool hard);
+    void onChaosTick();
+    void updateChaosTimer();
+    const Profile &profileFor(const Connection *connection) const;
+
+    QTcpServer *server;
+    QString targetHost;
+    quint16 targetPort;
+    Profile defaults;
+    QHash<quint32, Connection *> active;
+    quint32 nextId;
+    QElapsedTimer clock;
+    QTimer *chaosTimer;
+};
+
+#endif // IMPAIRMENTPROXY_H
@@ -1,12 +1,35 @@
 #include "mainwindow.h"
+#include "startuptrace.h"
 #include <QApplication>
+#include <QFile>
 
 int main(int argc, char *argv[])
 {
+    StartupTrace::begin(argc, argv);
     QApplication app(argc, argv);
+    StartupTrace::mark("QApplication");
+    
+    // Une seule feuille de style, embarquée par rcc et appliquée avant toute création de widget
+    QFile styleFile(":/style.qss");
+    if (styleFile.open(QIODevice::ReadOnly)) {
+        app.setStyleSheet(QString::fromUtf8(styleFile.readAll()));
+    }
+    StartupTrace::mark("stylesheet");
     
     MainWindow window;
-    window.show();
+    StartupTrace::mark("MainWindow");
+    StartupTrace::watchFirstFrame(&window);
+    const QStringList arguments = QCoreApplication::arguments();
+    if (arguments.contains("--standby")) {
+        // Processus de secours : reprend la partie si l'hôte de cette machine disparaît
+        window.startStandby();
+    } else if (arguments.contains("--takeover")) {
+        // Nouvelle version : reçoit les sockets et la partie de l'hôte en cours (Linux)
+        window.startTakeover();
+    } else {
+        window.show();
+        StartupTrace::mark("show");
+    }
     
     return app.exec();
-}
\ No newline at end of file
+}
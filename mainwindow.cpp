@@ -1,44 +1,76 @@
 #include "mainwindow.h"
+#include "startuptrace.h"
 #include <QtWidgets>
-#include <QJsonObject>
-#include <QJsonDocument>
-#include <QHostAddress>
-#include <QNetworkInterface>
+#include <QAudioOutput>
+#include <QMediaPlayer>
+#include <QThread>
+
+static const int MEDIA_MAX_WIDTH = 480;
+static const int MEDIA_MAX_HEIGHT = 270;
+static const int TEAM_SUMMARY_ROWS = 5;
 
 MainWindow::MainWindow(QWidget *parent)
-    : QMainWindow(parent), game(nullptr), networkManager(nullptr), 
-      isHost(false), selectedAnswer(-1)
+    : QMainWindow(parent), coreThread(nullptr), session(nullptr),
+      menuPage(nullptr), createGamePage(nullptr), joinGamePage(nullptr),
+      lobbyPage(nullptr), gamePage(nullptr), audioPlayer(nullptr), resultsPage(nullptr), finalResultsPage(nullptr),
+      isHost(false), selectedAnswer(-1), sessionEpoch(0), leftEpoch(0), dirtyFlags(0), pendingSecondsLeft(10),
+      pendingPage(-1)
 {
-    game = new Game(this);
-    networkManager = new NetworkManager(this);
+    playerModel = new PlayerListModel(this);
+    scoreModel = new ScoreTableModel(this);
+    
+    // Toutes les mises à jour de vue passent par un seul flush par frame
+    uiUpdateTimer = new QTimer(this);
+    uiUpdateTimer->setSingleShot(true);
+    uiUpdateTimer->setTimerType(Qt::PreciseTimer);
+    connect(uiUpdateTimer, &QTimer::timeout, this, &MainWindow::flushUpdates);
     
     setupUI();
     
-    // Connect game signals
-    connect(game, &Game::gameCreated, this, &MainWindow::onGameCreated);
-    connect(game, &Game::playerJoined, this, &MainWindow::onPlayerJoined);
-    connect(game, &Game::playerLeft, this, &MainWindow::onPlayerLeft);
-    connect(game, &Game::gameStarted, this, &MainWindow::onGameStarted);
-    connect(game, &Game::questionChanged, this, &MainWindow::onQuestionChanged);
-    connect(game, &Game::answerSubmitted, this, &MainWindow::onAnswerSubmitted);
-    connect(game, &Game::allAnswersReceived, this, &MainWindow::onAllAnswersReceived);
-    connect(game, &Game::resultsReady, this, &MainWindow::onResultsReady);
-    connect(game, &Game::gameEnded, this, &MainWindow::onGameEnded);
-    connect(game, &Game::timeUpdate, this, &MainWindow::onTimeUpdate);
-    
-    // Connect network signals
-    connect(networkManager, &NetworkManager::serverStarted, this, &MainWindow::onServerStarted);
-    connect(networkManager, &NetworkManager::clientConnected, this, &MainWindow::onClientConnected);
-    connect(networkManager, &NetworkManager::clientDisconnected, this, &MainWindow::onClientDisconnected);
-    connect(networkManager, &NetworkManager::connectedToHost, this, &MainWindow::onConnectedToHost);
-    connect(networkManager, &NetworkManager::messageReceived, this, &MainWindow::onMessageReceived);
-    connect(networkManager, &NetworkManager::connectionError, this, &MainWindow::onConnectionError);
+    // Le jeu, le réseau et les timers tournent hors du thread GUI :
+    // un repaint lourd ne retarde ni les réponses ni le compte à rebours
+    coreThread = new QThread(this);
+    coreThread->setObjectName("QuizzCore");
+    session = new GameSession();
+    session->moveToThread(coreThread);
+    connect(coreThread, &QThread::finished, session, &QObject::deleteLater);
+    
+    // Connect session signals (Qt::AutoConnection => en file entre threads)
+    connect(session, &GameSession::gameCreated, this, &MainWindow::onGameCreated);
+    connect(session, &GameSession::playerJoined, this, &MainWindow::onPlayerJoined);
+    connect(session, &GameSession::playerLeft, this, &MainWindow::onPlayerLeft);
+    connect(session, &GameSession::gameStarted, this, &MainWindow::onGameStarted);
+    connect(session, &GameSession::questionChanged, this, &MainWindow::onQuestionChanged);
+    connect(session, &GameSession::mediaReady, this, &MainWindow::onMediaReady);
+    connect(session, &GameSession::resultsReady, this, &MainWindow::onResultsReady);
+    connect(session, &GameSession::gameEnded, this, &MainWindow::onGameEnded);
+    connect(session, &GameSession::timeUpdate, this, &MainWindow::onTimeUpdate);
+    connect(session, &GameSession::serverStartFailed, this, &MainWindow::onServerStartFailed);
+    connect(session, &GameSession::connectionError, this, &MainWindow::onConnectionError);
+    connect(session, &GameSession::tookOver, this, &MainWindow::onTookOver);
+    connect(session, &GameSession::handedOff, this, &MainWindow::onHandedOff);
+    connect(session, &GameSession::handoffFailed, this, &MainWindow::onHandoffFailed);
+    connect(session, &GameSession::gameLeft, this, &MainWindow::onGameLeft);
+    
+    coreThread->start(QThread::HighPriority);
     
     showPage(MENU_PAGE);
 }
 
 MainWindow::~MainWindow()
 {
+    coreThread->quit();
+    coreThread->wait();
+}
+
+void MainWindow::startStandby()
+{
+    QMetaObject::invokeMethod(session, &GameSession::standby);
+}
+
+void MainWindow::startTakeover()
+{
+    QMetaObject::invokeMethod(session, &GameSession::receiveHandoff);
 }
 
 void MainWindow::setupUI()
@@ -46,13 +78,7 @@ void MainWindow::setupUI()
     stackedWidget = new QStackedWidget(this);
     setCentralWidget(stackedWidget);
     
-    setupMenuPage();
-    setupCreateGamePage();
-    setupJoinGamePage();
-    setupLobbyPage();
-    setupGamePage();
-    setupResultsPage();
-    setupFinalResultsPage();
+    // Les pages sont construites au premier showPage (voir ensurePage)
     
     setWindowTitle("QuizzGame");
     resize(800, 600);
@@ -65,21 +91,25 @@ void MainWindow::setupMenuPage()
     
     QLabel* titleLabel = new QLabel("QuizzGame");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 32px; font-weight: bold; color: #2c3e50; margin: 20px;");
+    titleLabel->setObjectName("appTitle");
     
     QLabel* nameLabel = new QLabel("Votre nom:");
     playerNameEdit = new QLineEdit();
     playerNameEdit->setPlaceholderText("Entrez votre nom...");
     
+    teamEdit = new QLineEdit();
+    teamEdit->setPlaceholderText("Équipe (facultatif)...");
+    
     createGameBtn = new QPushButton("Créer une partie");
     joinGameBtn = new QPushButton("Rejoindre une partie");
     
-    createGameBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #3498db; color: white; border: none; border-radius: 5px; } QPushButton:hover { background-color: #2980b9; }");
-    joinGameBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #27ae60; color: white; border: none; border-radius: 5px; } QPushButton:hover { background-color: #229954; }");
+    createGameBtn->setProperty("variant", "primary");
+    joinGameBtn->setProperty("variant", "success");
     
     layout->addWidget(titleLabel);
     layout->addWidget(nameLabel);
     layout->addWidget(playerNameEdit);
+    layout->addWidget(teamEdit);
     layout->addWidget(createGameBtn);
     layout->addWidget(joinGameBtn);
     layout->addStretch();
@@ -97,7 +127,7 @@ void MainWindow::setupCreateGamePage()
     
     QLabel* titleLabel = new QLabel("Créer une partie");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; margin: 20px;");
+    titleLabel->setProperty("role", "title");
     
     QLabel* themeLabel = new QLabel("Choisissez un thème:");
     themeComboBox = new QComboBox();
@@ -108,8 +138,8 @@ void MainWindow::setupCreateGamePage()
     createBtn = new QPushButton("Créer la partie");
     backToMenuBtn1 = new QPushButton("Retour");
     
-    createBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #3498db; color: white; border: none; border-radius: 5px; }");
-    backToMenuBtn1->setStyleSheet("QPushButton { padding: 8px; font-size: 14px; background-color: #95a5a6; color: white; border: none; border-radius: 5px; }");
+    createBtn->setProperty("variant", "primary");
+    backToMenuBtn1->setProperty("variant", "back");
     
     layout->addWidget(titleLabel);
     layout->addWidget(themeLabel);
@@ -127,13 +157,11 @@ void MainWindow::setupCreateGamePage()
         currentPlayerName = playerNameEdit->text();
         isHost = true;
         
-        Game::Theme theme = static_cast<Game::Theme>(themeComboBox->currentData().toInt());
-        game->createGame(theme);
-        
-        if (!networkManager->startServer()) {
-            QMessageBox::critical(this, "Erreur", "Impossible de démarrer le serveur!");
-            return;
-        }
+        int theme = themeComboBox->currentData().toInt();
+        QMetaObject::invokeMethod(session, [session = session, name = currentPlayerName, theme,
+                                            team = teamEdit->text().trimmed()]() {
+            session->hostGame(name, theme, team);
+        });
     });
     connect(backToMenuBtn1, &QPushButton::clicked, this, &MainWindow::onBackToMenuClicked);
     
@@ -147,7 +175,7 @@ void MainWindow::setupJoinGamePage()
     
     QLabel* titleLabel = new QLabel("Rejoindre une partie");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; margin: 20px;");
+    titleLabel->setProperty("role", "title");
     
     QLabel* codeLabel = new QLabel("Code de la partie:");
     gameCodeEdit = new QLineEdit();
@@ -156,8 +184,8 @@ void MainWindow::setupJoinGamePage()
     joinBtn = new QPushButton("Rejoindre");
     backToMenuBtn2 = new QPushButton("Retour");
     
-    joinBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #27ae60; color: white; border: none; border-radius: 5px; }");
-    backToMenuBtn2->setStyleSheet("QPushButton { padding: 8px; font-size: 14px; background-color: #95a5a6; color: white; border: none; border-radius: 5px; }");
+    joinBtn->setProperty("variant", "success");
+    backToMenuBtn2->setProperty("variant", "back");
     
     layout->addWidget(titleLabel);
     layout->addWidget(codeLabel);
@@ -182,10 +210,14 @@ void MainWindow::setupJoinGamePage()
         // ——— NOUVEAU : demander dynamiquement l’IP de l’hôte ———
         QString hostIp = QInputDialog::getText(this,
                                           "Adresse IP de l’hôte",
-                                          "Entrez l’IP de l’ordinateur qui a créé la partie :");
+                                          "Entrez l’IP de l’ordinateur qui a créé la partie\n(ip:port pour un autre port) :");
         if (hostIp.isEmpty()) return;   // utilisateur a annulé
 
-        networkManager->connectToHost(hostIp.trimmed(), 12345);
+        QMetaObject::invokeMethod(session, [session = session, name = currentPlayerName,
+                                            ip = hostIp.trimmed(), code = gameCodeEdit->text(),
+                                            team = teamEdit->text().trimmed()]() {
+            session->joinGame(name, ip, code, team);
+        });
     });
     connect(backToMenuBtn2, &QPushButton::clicked, this, &MainWindow::onBackToMenuClicked);
     
@@ -199,14 +231,17 @@ void MainWindow::setupLobbyPage()
     
     QLabel* titleLabel = new QLabel("Salle d'attente");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; margin: 20px;");
+    titleLabel->setProperty("role", "title");
     
     gameCodeLabel = new QLabel();
     gameCodeLabel->setAlignment(Qt::AlignCenter);
-    gameCodeLabel->setStyleSheet("font-size: 20px; font-weight: bold; color: #e74c3c; margin: 10px;");
+    gameCodeLabel->setObjectName("gameCodeLabel");
     
     QLabel* playersLabel = new QLabel("Joueurs connectés:");
-    playerListWidget = new QListWidget();
+    playerListView = new QListView();
+    playerListView->setModel(playerModel);
+    playerListView->setUniformItemSizes(true);
+    playerListView->setLayoutMode(QListView::Batched);
     
     statusLabel = new QLabel("En attente des joueurs...");
     statusLabel->setAlignment(Qt::AlignCenter);
@@ -214,13 +249,13 @@ void MainWindow::setupLobbyPage()
     startGameBtn = new QPushButton("Lancer la partie");
     backToMenuBtn3 = new QPushButton("Retour au menu");
     
-    startGameBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #e67e22; color: white; border: none; border-radius: 5px; }");
-    backToMenuBtn3->setStyleSheet("QPushButton { padding: 8px; font-size: 14px; background-color: #95a5a6; color: white; border: none; border-radius: 5px; }");
+    startGameBtn->setProperty("variant", "warning");
+    backToMenuBtn3->setProperty("variant", "back");
     
     layout->addWidget(titleLabel);
     layout->addWidget(gameCodeLabel);
     layout->addWidget(playersLabel);
-    layout->addWidget(playerListWidget);
+    layout->addWidget(playerListView);
     layout->addWidget(statusLabel);
     layout->addWidget(startGameBtn);
     layout->addWidget(backToMenuBtn3);
@@ -238,11 +273,11 @@ void MainWindow::setupGamePage()
     
     questionCounter = new QLabel();
     questionCounter->setAlignment(Qt::AlignCenter);
-    questionCounter->setStyleSheet("font-size: 16px; font-weight: bold;");
+    questionCounter->setObjectName("questionCounter");
     
     timerLabel = new QLabel("Temps restant: 10s");
     timerLabel->setAlignment(Qt::AlignCenter);
-    timerLabel->setStyleSheet("font-size: 18px; color: #e74c3c;");
+    timerLabel->setObjectName("timerLabel");
     
     timerProgress = new QProgressBar();
     timerProgress->setRange(0, 10);
@@ -251,7 +286,12 @@ void MainWindow::setupGamePage()
     questionLabel = new QLabel();
     questionLabel->setWordWrap(true);
     questionLabel->setAlignment(Qt::AlignCenter);
-    questionLabel->setStyleSheet("font-size: 20px; font-weight: bold; margin: 20px; padding: 20px; background-color: #ecf0f1; border-radius: 10px;");
+    questionLabel->setObjectName("questionLabel");
+    
+    mediaLabel = new QLabel();
+    mediaLabel->setAlignment(Qt::AlignCenter);
+    mediaLabel->setObjectName("mediaLabel");
+    mediaLabel->hide();
     
     QWidget* answersWidget = new QWidget();
     QVBoxLayout* answersLayout = new QVBoxLayout(answersWidget);
@@ -261,11 +301,10 @@ void MainWindow::setupGamePage()
     answer3Btn = new QRadioButton();
     answer4Btn = new QRadioButton();
     
-    QString radioStyle = "QRadioButton { font-size: 16px; padding: 10px; margin: 5px; } QRadioButton::indicator { width: 20px; height: 20px; }";
-    answer1Btn->setStyleSheet(radioStyle);
-    answer2Btn->setStyleSheet(radioStyle);
-    answer3Btn->setStyleSheet(radioStyle);
-    answer4Btn->setStyleSheet(radioStyle);
+    answer1Btn->setProperty("role", "answer");
+    answer2Btn->setProperty("role", "answer");
+    answer3Btn->setProperty("role", "answer");
+    answer4Btn->setProperty("role", "answer");
     
     answersLayout->addWidget(answer1Btn);
     answersLayout->addWidget(answer2Btn);
@@ -273,17 +312,19 @@ void MainWindow::setupGamePage()
     answersLayout->addWidget(answer4Btn);
     
     submitAnswerBtn = new QPushButton("Valider ma réponse");
-    submitAnswerBtn->setStyleSheet("QPushButton { padding: 12px; font-size: 16px; background-color: #27ae60; color: white; border: none; border-radius: 5px; }");
+    submitAnswerBtn->setObjectName("submitAnswerBtn");
+    submitAnswerBtn->setProperty("variant", "success");
     
     waitingLabel = new QLabel("En attente des autres joueurs...");
     waitingLabel->setAlignment(Qt::AlignCenter);
-    waitingLabel->setStyleSheet("font-size: 16px; color: #7f8c8d;");
+    waitingLabel->setObjectName("waitingLabel");
     waitingLabel->hide();
     
     layout->addWidget(questionCounter);
     layout->addWidget(timerLabel);
     layout->addWidget(timerProgress);
     layout->addWidget(questionLabel);
+    layout->addWidget(mediaLabel);
     layout->addWidget(answersWidget);
     layout->addWidget(submitAnswerBtn);
     layout->addWidget(waitingLabel);
@@ -295,15 +336,12 @@ void MainWindow::setupGamePage()
     connect(answer4Btn, &QRadioButton::clicked, this, &MainWindow::onAnswerSelected);
     connect(submitAnswerBtn, &QPushButton::clicked, [this]() {
         if (selectedAnswer >= 0) {
-            game->submitAnswer(currentPlayerName, selectedAnswer);
+            // Horodatée à la réception sur le thread du jeu
+            QMetaObject::invokeMethod(session, [session = session, answer = selectedAnswer]() {
+                session->submitAnswer(answer);
+            });
             submitAnswerBtn->setEnabled(false);
             waitingLabel->show();
-            
-            // Send answer to network
-            QJsonObject data;
-            data["playerName"] = currentPlayerName;
-            data["answer"] = selectedAnswer;
-            sendNetworkMessage("answer", data);
         }
     });
     
@@ -317,20 +355,23 @@ void MainWindow::setupResultsPage()
     
     QLabel* titleLabel = new QLabel("Résultats de la question");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; margin: 20px;");
+    titleLabel->setProperty("role", "title");
+    
+    resultsSummaryLabel = new QLabel();
+    resultsSummaryLabel->setWordWrap(true);
+    resultsSummaryLabel->setObjectName("resultsSummaryLabel");
     
-    resultsText = new QTextEdit();
-    resultsText->setReadOnly(true);
-    resultsText->setStyleSheet("font-size: 14px; background-color: #ecf0f1; border: 1px solid #bdc3c7; border-radius: 5px;");
+    resultsView = createScoreView();
     
     nextQuestionBtn = new QPushButton("Question suivante");
     backToMenuBtn4 = new QPushButton("Retour au menu");
     
-    nextQuestionBtn->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #3498db; color: white; border: none; border-radius: 5px; }");
-    backToMenuBtn4->setStyleSheet("QPushButton { padding: 8px; font-size: 14px; background-color: #95a5a6; color: white; border: none; border-radius: 5px; }");
+    nextQuestionBtn->setProperty("variant", "primary");
+    backToMenuBtn4->setProperty("variant", "back");
     
     layout->addWidget(titleLabel);
-    layout->addWidget(resultsText);
+    layout->addWidget(resultsSummaryLabel);
+    layout->addWidget(resultsView);
     layout->addWidget(nextQuestionBtn);
     layout->addWidget(backToMenuBtn4);
     
@@ -347,22 +388,20 @@ void MainWindow::setupFinalResultsPage()
     
     QLabel* titleLabel = new QLabel("Fin de la partie");
     titleLabel->setAlignment(Qt::AlignCenter);
-    titleLabel->setStyleSheet("font-size: 24px; font-weight: bold; margin: 20px;");
+    titleLabel->setProperty("role", "title");
     
     winnerLabel = new QLabel();
     winnerLabel->setAlignment(Qt::AlignCenter);
-    winnerLabel->setStyleSheet("font-size: 22px; font-weight: bold; color: #f39c12; margin: 20px;");
+    winnerLabel->setObjectName("winnerLabel");
     
-    finalScoresText = new QTextEdit();
-    finalScoresText->setReadOnly(true);
-    finalScoresText->setStyleSheet("font-size: 14px; background-color: #ecf0f1; border: 1px solid #bdc3c7; border-radius: 5px;");
+    finalScoresView = createScoreView();
     
     backToMenuBtn5 = new QPushButton("Retour au menu");
-    backToMenuBtn5->setStyleSheet("QPushButton { padding: 10px; font-size: 16px; background-color: #95a5a6; color: white; border: none; border-radius: 5px; }");
+    backToMenuBtn5->setProperty("variant", "secondary");
     
     layout->addWidget(titleLabel);
     layout->addWidget(winnerLabel);
-    layout->addWidget(finalScoresText);
+    layout->addWidget(finalScoresView);
     layout->addWidget(backToMenuBtn5);
     
     connect(backToMenuBtn5, &QPushButton::clicked, this, &MainWindow::onBackToMenuClicked);
@@ -383,13 +422,12 @@ void MainWindow::onJoinGameClicked()
 
 void MainWindow::onStartGameClicked()
 {
-    if (game->getPlayers().size() < 1) {
+    if (playerModel->rowCount() < 1) {
         QMessageBox::warning(this, "Erreur", "Il faut au moins 1 joueur pour commencer!");
         return;
     }
     
-    game->startGame();
-    sendNetworkMessage("start_game");
+    QMetaObject::invokeMethod(session, &GameSession::startGame);
 }
 
 void MainWindow::onAnswerSelected()
@@ -407,43 +445,49 @@ void MainWindow::onNextQuestionClicked()
 {
     qDebug() << "=== NEXT QUESTION CLICKED ===";
     qDebug() << "Is host:" << isHost;
-    qDebug() << "Current question index before:" << game->getCurrentQuestionIndex();
-    qDebug() << "Total questions:" << game->getTotalQuestions();
+    qDebug() << "Current question index before:" << snapshot.questionIndex;
+    qDebug() << "Total questions:" << snapshot.totalQuestions;
     
     if (isHost) {
-        game->nextQuestion();
-        sendNetworkMessage("next_question");
-        qDebug() << "Host processed next question";
+        QMetaObject::invokeMethod(session, &GameSession::nextQuestion);
     } else {
         qDebug() << "ERROR: Non-host tried to click next question!";
     }
     
-    qDebug() << "Current question index after:" << game->getCurrentQuestionIndex();
     qDebug() << "=============================";
 }
 void MainWindow::onBackToMenuClicked()
 {
-    // Reset everything
-    if (networkManager->isServer()) {
-        networkManager->stopServer();
-    } else {
-        networkManager->disconnectFromHost();
-    }
+    // Reset everything ; les signaux encore en file de la partie quittée seront ignorés
+    QMetaObject::invokeMethod(session, &GameSession::leaveGame);
+    ++sessionEpoch;
     
-    playerListWidget->clear();
+    resetPendingUpdates();
+    stopQuestionAudio();
+    playerModel->clear();
+    scoreModel->clear();
     selectedAnswer = -1;
     isHost = false;
     currentPlayerName.clear();
+    snapshot = GameSnapshot();
     
     showPage(MENU_PAGE);
 }
 
 // Game event handlers
+void MainWindow::onGameLeft(quint64 epoch)
+{
+    leftEpoch = epoch;
+}
+
 void MainWindow::onGameCreated(const QString& code)
 {
-    game->addPlayer(currentPlayerName);
+    if (isLeaving()) {
+        return;
+    }
+    ensurePage(LOBBY_PAGE);
     gameCodeLabel->setText(QString("Code de la partie: %1").arg(code));
-    updatePlayerList();
+    playerModel->clear();
     showPage(LOBBY_PAGE);
     
     if (isHost) {
@@ -457,137 +501,134 @@ void MainWindow::onGameCreated(const QString& code)
 
 void MainWindow::onPlayerJoined(const QString& playerName)
 {
-    updatePlayerList();
+    if (isLeaving()) {
+        return;
+    }
+    pendingRoster.append({playerName, true});
+    scheduleUpdate(DIRTY_ROSTER);
 }
 
 void MainWindow::onPlayerLeft(const QString& playerName)
 {
-    updatePlayerList();
+    if (isLeaving()) {
+        return;
+    }
+    pendingRoster.append({playerName, false});
+    scheduleUpdate(DIRTY_ROSTER);
 }
 
 void MainWindow::onGameStarted()
 {
-    showPage(GAME_PAGE);
+    if (isLeaving()) {
+        return;
+    }
+    schedulePage(GAME_PAGE);
 }
 
-void MainWindow::onQuestionChanged(const Question& question)
+void MainWindow::onQuestionChanged(const GameSnapshot& newSnapshot)
 {
+    if (isStale(newSnapshot)) {
+        return;
+    }
+    snapshot = newSnapshot;
+    
     qDebug() << "=== QUESTION CHANGED ===";
-    qDebug() << "New question:" << question.getQuestionText();
-    qDebug() << "Question index:" << game->getCurrentQuestionIndex();
+    qDebug() << "New question:" << snapshot.question.getQuestionText();
+    qDebug() << "Question index:" << snapshot.questionIndex;
     qDebug() << "Is host:" << isHost;
     
-    updateGameQuestion();
-    
-    // Reset UI
-    answer1Btn->setChecked(false);
-    answer2Btn->setChecked(false);
-    answer3Btn->setChecked(false);
-    answer4Btn->setChecked(false);
     selectedAnswer = -1;
-    submitAnswerBtn->setEnabled(false);
-    waitingLabel->hide();
-    timerProgress->setValue(10);
+    pendingSecondsLeft = 10;
+    scheduleUpdate(DIRTY_QUESTION | DIRTY_TIMER);
     
     // S'assurer qu'on est sur la bonne page
-    if (stackedWidget->currentIndex() != GAME_PAGE) {
-        qDebug() << "Switching to game page";
-        showPage(GAME_PAGE);
-    }
+    schedulePage(GAME_PAGE);
     
     qDebug() << "=======================";
 }
 
-void MainWindow::onAnswerSubmitted(const QString& playerName, int answer)
-{
-    // Visual feedback that answer was submitted
-}
-
-void MainWindow::onAllAnswersReceived()
+void MainWindow::onMediaReady(const GameSnapshot& newSnapshot)
 {
-    // All answers received, waiting for results
+    // Média reçu pendant la question : seule l'image change, pas la sélection
+    if (isStale(newSnapshot) || newSnapshot.questionIndex != snapshot.questionIndex) {
+        return;
+    }
+    snapshot.mediaPath = newSnapshot.mediaPath;
+    scheduleUpdate(DIRTY_MEDIA);
 }
 
-void MainWindow::onResultsReady(const QMap<QString, bool>& results)
+void MainWindow::onResultsReady(const GameSnapshot& newSnapshot)
 {
-    updateResults();
-    showPage(RESULTS_PAGE);
-    
-    // Montrer le bouton seulement pour l'hôte
-    if (isHost) {
-        nextQuestionBtn->show();
-        nextQuestionBtn->setEnabled(true);
-    } else {
-        nextQuestionBtn->hide();
+    if (isStale(newSnapshot)) {
+        return;
     }
+    snapshot = newSnapshot;
+    scheduleUpdate(DIRTY_RESULTS);
+    schedulePage(RESULTS_PAGE);
 }
 
-void MainWindow::onGameEnded(const QString& winner)
+void MainWindow::onGameEnded(const GameSnapshot& newSnapshot)
 {
-    updateFinalResults();
-    showPage(FINAL_RESULTS_PAGE);
+    if (isStale(newSnapshot)) {
+        return;
+    }
+    snapshot = newSnapshot;
+    scheduleUpdate(DIRTY_FINAL_RESULTS);
+    schedulePage(FINAL_RESULTS_PAGE);
 }
 
 void MainWindow::onTimeUpdate(int secondsLeft)
 {
-    timerLabel->setText(QString("Temps restant: %1s").arg(secondsLeft));
-    timerProgress->setValue(secondsLeft);
-    
-    if (secondsLeft <= 3) {
-        timerLabel->setStyleSheet("font-size: 18px; color: #e74c3c; font-weight: bold;");
+    if (isLeaving()) {
+        return;
     }
+    pendingSecondsLeft = secondsLeft;
+    scheduleUpdate(DIRTY_TIMER);
 }
 
-// Network event handlers
-void MainWindow::onServerStarted(quint16 port)
-{
-    qDebug() << "Server started on port:" << port;
-}
-
-void MainWindow::onClientConnected(const QString& clientId)
-{
-    qDebug() << "Client connected:" << clientId;
-}
-
-void MainWindow::onClientDisconnected(const QString& clientId)
+void MainWindow::onServerStartFailed()
 {
-    qDebug() << "Client disconnected:" << clientId;
+    QMessageBox::critical(this, "Erreur", "Impossible de démarrer le serveur!");
 }
 
-void MainWindow::onConnectedToHost()
+void MainWindow::onConnectionError(const QString& error)
 {
-    // Join the game
-    QJsonObject data;
-    data["playerName"] = currentPlayerName;
-    data["gameCode"] = gameCodeEdit->text();
-    sendNetworkMessage("join_game", data);
+    QMessageBox::critical(this, "Erreur de connexion", error);
 }
 
-void MainWindow::onMessageReceived(const QJsonObject& message, const QString& senderId)
+void MainWindow::onTookOver(const QString& playerName)
 {
-    handleNetworkMessage(message, senderId);
+    // Secours devenu hôte : la partie continue ici, sous le nom de l'ancien hôte
+    currentPlayerName = playerName;
+    isHost = true;
+    setWindowTitle("QuizzGame (reprise)");
+    show();
+    raise();
+    activateWindow();
 }
 
-void MainWindow::onConnectionError(const QString& error)
+void MainWindow::onHandedOff()
 {
-    QMessageBox::critical(this, "Erreur de connexion", error);
+    // La nouvelle version a repris la partie et sa fenêtre s'affiche
+    close();
 }
 
-// Helper methods
-void MainWindow::updatePlayerList()
+void MainWindow::onHandoffFailed(const QString& error)
 {
-    playerListWidget->clear();
-    QStringList players = game->getPlayers();
-    for (const QString& player : players) {
-        playerListWidget->addItem(player);
+    if (isVisible()) {
+        return;     // l'ancien hôte garde la partie, rien à signaler
     }
+    show();
+    QMessageBox::warning(this, "Reprise impossible", error);
 }
 
+// Helper methods
 void MainWindow::updateGameQuestion()
 {
-    Question currentQ = game->getCurrentQuestion();
-    questionCounter->setText(QString("Question %1/%2").arg(game->getCurrentQuestionIndex() + 1).arg(game->getTotalQuestions()));
+    const Question& currentQ = snapshot.question;
+    questionCounter->setText(QString("Question %1/%2").arg(snapshot.questionIndex + 1).arg(snapshot.totalQuestions));
     questionLabel->setText(currentQ.getQuestionText());
+    updateGameMedia();
     
     QStringList answers = currentQ.getAnswers();
     if (answers.size() >= 4) {
@@ -598,127 +639,288 @@ void MainWindow::updateGameQuestion()
     }
 }
 
-void MainWindow::updateResults()
+void MainWindow::updateGameMedia()
 {
-    QString resultText = "Résultats de la question:\n\n";
-    
-    Question currentQ = game->getCurrentQuestion();
-    QStringList answers = currentQ.getAnswers();
+    const Question::Media& media = snapshot.question.getMedia();
+    mediaLabel->setVisible(!media.isNull());
+    if (media.isNull()) {
+        mediaLabel->clear();
+        stopQuestionAudio();
+        return;
+    }
     
-    resultText += QString("Question: %1\n").arg(currentQ.getQuestionText());
-    resultText += QString("Bonne réponse: %1\n\n").arg(answers[currentQ.getCorrectAnswerIndex()]);
+    if (media.kind == Question::Media::AUDIO) {
+        // Joué dès que le fichier est là, y compris s'il arrive pendant la question
+        mediaLabel->setText(snapshot.mediaPath.isEmpty() ? "🔊 Chargement du son..." : "🔊 Question audio");
+        playQuestionAudio(snapshot.mediaPath);
+        return;
+    }
+    stopQuestionAudio();
+    QPixmap image(snapshot.mediaPath);
+    if (image.isNull()) {
+        mediaLabel->setText("Chargement de l'image...");
+        return;
+    }
+    mediaLabel->setPixmap(image.scaled(MEDIA_MAX_WIDTH, MEDIA_MAX_HEIGHT, Qt::KeepAspectRatio, Qt::SmoothTransformation));
+}
+
+void MainWindow::playQuestionAudio(const QString& path)
+{
+    if (path.isEmpty()) {
+        stopQuestionAudio();
+        return;
+    }
     
-    QMap<QString, int> scores = game->getPlayerScores();
-    for (auto it = scores.begin(); it != scores.end(); ++it) {
-        resultText += QString("%1: %2 points\n").arg(it.key()).arg(it.value());
+    // Pas de backend multimédia au démarrage : seulement au premier son
+    if (!audioPlayer) {
+        audioPlayer = new QMediaPlayer(this);
+        audioPlayer->setAudioOutput(new QAudioOutput(audioPlayer));
+        connect(audioPlayer, &QMediaPlayer::errorOccurred, this, [](QMediaPlayer::Error, const QString& error) {
+            qWarning() << "Question audio playback failed:" << error;
+        });
     }
     
-    resultsText->setText(resultText);
+    // Même question redessinée pendant la lecture : on ne repart pas du début
+    const QUrl source = QUrl::fromLocalFile(path);
+    if (audioPlayer->source() == source && audioPlayer->playbackState() == QMediaPlayer::PlayingState) {
+        return;
+    }
+    audioPlayer->setSource(source);
+    audioPlayer->play();
 }
 
-void MainWindow::updateFinalResults()
+void MainWindow::stopQuestionAudio()
 {
-    QString winner = game->getWinner();
-    winnerLabel->setText(QString("🏆 Gagnant: %1 🏆").arg(winner));
-    
-    QString scoresText = "Scores finaux:\n\n";
-    QMap<QString, int> scores = game->getPlayerScores();
+    if (audioPlayer) {
+        audioPlayer->stop();
+    }
+}
+
+void MainWindow::updateResults()
+{
+    const Question& currentQ = snapshot.question;
+    QStringList answers = currentQ.getAnswers();
     
-    // Sort scores
-    QList<QPair<QString, int>> sortedScores;
-    for (auto it = scores.begin(); it != scores.end(); ++it) {
-        sortedScores.append({it.key(), it.value()});
+    QString summary = QString("Question: %1\n").arg(currentQ.getQuestionText());
+    if (currentQ.getCorrectAnswerIndex() < answers.size()) {
+        summary += QString("Bonne réponse: %1").arg(answers[currentQ.getCorrectAnswerIndex()]);
     }
+    summary += teamSummary(TEAM_SUMMARY_ROWS);
+    resultsSummaryLabel->setText(summary);
     
-    std::sort(sortedScores.begin(), sortedScores.end(), 
-              [](const QPair<QString, int>& a, const QPair<QString, int>& b) {
-                  return a.second > b.second;
-              });
+    // Le modèle ne déplace que les lignes dont le score a changé
+    scoreModel->setScores(snapshot.scores);
+}
+
+QString MainWindow::teamSummary(int rows) const
+{
+    QString text;
+    for (int i = 0; i < snapshot.teams.size() && i < rows; ++i) {
+        const TeamStandings::Standing& team = snapshot.teams.at(i);
+        text += QString("\n%1. %2 — %3 pts, %4 % de bonnes réponses")
+                    .arg(QString::number(team.rank), team.name, QString::number(team.score),
+                         QString::number(qRound(team.accuracy * 100)));
+    }
+    return text.isEmpty() ? text : "\n\nÉquipes:" + text;
+}
+
+void MainWindow::updateFinalResults()
+{
+    QString winnerText = QString("🏆 Gagnant: %1 🏆").arg(snapshot.winner);
+    if (!snapshot.teams.isEmpty()) {
+        winnerText += QString("\nÉquipe gagnante: %1").arg(snapshot.teams.first().name);
+    }
+    winnerLabel->setText(winnerText);
+    
+    scoreModel->setScores(snapshot.scores);
+    finalScoresView->scrollToTop();
+}
+
+QTableView* MainWindow::createScoreView()
+{
+    // Vue virtualisée : seules les lignes visibles sont peintes
+    QTableView* view = new QTableView();
+    view->setModel(scoreModel);
+    view->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    view->setSelectionMode(QAbstractItemView::NoSelection);
+    view->setShowGrid(false);
+    view->setWordWrap(false);
+    view->verticalHeader()->hide();
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(24);
+    view->horizontalHeader()->setSectionResizeMode(ScoreTableModel::RANK_COLUMN, QHeaderView::Fixed);
+    view->horizontalHeader()->resizeSection(ScoreTableModel::RANK_COLUMN, 50);
+    view->horizontalHeader()->setSectionResizeMode(ScoreTableModel::NAME_COLUMN, QHeaderView::Stretch);
+    view->horizontalHeader()->setSectionResizeMode(ScoreTableModel::SCORE_COLUMN, QHeaderView::Fixed);
+    view->horizontalHeader()->resizeSection(ScoreTableModel::SCORE_COLUMN, 120);
+    view->setProperty("role", "scores");
+    return view;
+}
+
+QWidget* MainWindow::ensurePage(int pageIndex)
+{
+    QWidget* page = pageWidget(pageIndex);
+    if (page) {
+        return page;
+    }
     
-    for (int i = 0; i < sortedScores.size(); ++i) {
-        scoresText += QString("%1. %2: %3 points\n")
-                      .arg(i + 1)
-                      .arg(sortedScores[i].first)
-                      .arg(sortedScores[i].second);
+    switch (pageIndex) {
+    case MENU_PAGE:          setupMenuPage(); break;
+    case CREATE_GAME_PAGE:   setupCreateGamePage(); break;
+    case JOIN_GAME_PAGE:     setupJoinGamePage(); break;
+    case LOBBY_PAGE:         setupLobbyPage(); break;
+    case GAME_PAGE:          setupGamePage(); break;
+    case RESULTS_PAGE:       setupResultsPage(); break;
+    case FINAL_RESULTS_PAGE: setupFinalResultsPage(); break;
     }
     
-    finalScoresText->setText(scoresText);
+    StartupTrace::mark(QString("page %1 built").arg(pageIndex));
+    return pageWidget(pageIndex);
+}
+
+QWidget* MainWindow::pageWidget(int pageIndex) const
+{
+    switch (pageIndex) {
+    case MENU_PAGE:          return menuPage;
+    case CREATE_GAME_PAGE:   return createGamePage;
+    case JOIN_GAME_PAGE:     return joinGamePage;
+    case LOBBY_PAGE:         return lobbyPage;
+    case GAME_PAGE:          return gamePage;
+    case RESULTS_PAGE:       return resultsPage;
+    case FINAL_RESULTS_PAGE: return finalResultsPage;
+    }
+    return nullptr;
 }
 
 void MainWindow::showPage(int pageIndex)
 {
-    stackedWidget->setCurrentIndex(pageIndex);
+    QWidget* page = ensurePage(pageIndex);
+    if (page) {
+        stackedWidget->setCurrentWidget(page);
+    }
 }
 
-void MainWindow::sendNetworkMessage(const QString& type, const QJsonObject& data)
+void MainWindow::scheduleUpdate(int flags)
 {
-    QJsonObject message;
-    message["type"] = type;
-    message["data"] = data;
-    message["sender"] = currentPlayerName;
+    dirtyFlags |= flags;
+    if (uiUpdateTimer->isActive()) {
+        return;
+    }
     
-    networkManager->sendMessage(message);
+    // Un flush au plus par rafraîchissement d'écran
+    qreal refreshRate = screen() ? screen()->refreshRate() : 60.0;
+    if (refreshRate < 1.0) {
+        refreshRate = 60.0;
+    }
+    uiUpdateTimer->start(qMax(1, int(1000.0 / refreshRate)));
 }
 
-void MainWindow::debugGameState()
+void MainWindow::schedulePage(int pageIndex)
 {
-    qDebug() << "=== DEBUG GAME STATE ===";
-    qDebug() << "Current question index:" << game->getCurrentQuestionIndex();
-    qDebug() << "Total questions:" << game->getTotalQuestions();
-    qDebug() << "Game state:" << game->getState();
-    qDebug() << "Is host:" << isHost;
-    qDebug() << "Current page:" << stackedWidget->currentIndex();
-    qDebug() << "Next question button visible:" << nextQuestionBtn->isVisible();
-    qDebug() << "Next question button enabled:" << nextQuestionBtn->isEnabled();
-    qDebug() << "========================";
+    pendingPage = pageIndex;
+    scheduleUpdate(DIRTY_PAGE);
 }
 
+void MainWindow::resetPendingUpdates()
+{
+    uiUpdateTimer->stop();
+    dirtyFlags = 0;
+    pendingRoster.clear();
+    pendingPage = -1;
+}
 
-void MainWindow::handleNetworkMessage(const QJsonObject& message, const QString& senderId)
+void MainWindow::flushUpdates()
 {
-    QString type = message["type"].toString();
-    QJsonObject data = message["data"].toObject();
+    const int flags = dirtyFlags;
+    dirtyFlags = 0;
     
-    qDebug() << "Received network message:" << type << "from:" << senderId;
-    
-    if (type == "join_game") {
-        QString playerName = data["playerName"].toString();
-        game->addPlayer(playerName);
-
-        // --- AJOUT : uniquement côté hôte, on diffuse le thème ---
-        if (isHost) {
-            QJsonObject info;
-            info["theme"] = static_cast<int>(game->getSelectedTheme());
-            sendNetworkMessage("setup_game", info);
+    if (flags & DIRTY_ROSTER) {
+        // Les arrivées consécutives deviennent un seul bloc d'insertion
+        QStringList joined;
+        for (const auto& change : std::as_const(pendingRoster)) {
+            if (change.second) {
+                joined.append(change.first);
+                continue;
+            }
+            playerModel->addPlayers(joined);
+            joined.clear();
+            playerModel->removePlayer(change.first);
+            scoreModel->removePlayer(change.first);
         }
+        playerModel->addPlayers(joined);
+        pendingRoster.clear();
     }
-    else if (type == "setup_game" && !isHost) {
-        int themeId = data["theme"].toInt();
-        game->setupClientGame(static_cast<Game::Theme>(themeId));
-        game->addPlayer(currentPlayerName);          // s’ajouter soi-même
+    
+    if (flags & (DIRTY_QUESTION | DIRTY_TIMER | DIRTY_MEDIA)) {
+        ensurePage(GAME_PAGE);
     }
-
-
-    else if (type == "start_game") {
-        if (!isHost) {
-            qDebug() << "Client received start_game message";
-            game->startGame();
-        }
+    
+    if ((flags & DIRTY_MEDIA) && !(flags & DIRTY_QUESTION)) {
+        updateGameMedia();
+    }
+    
+    if (flags & DIRTY_QUESTION) {
+        updateGameQuestion();
+        
+        // Reset UI
+        answer1Btn->setChecked(false);
+        answer2Btn->setChecked(false);
+        answer3Btn->setChecked(false);
+        answer4Btn->setChecked(false);
+        submitAnswerBtn->setEnabled(false);
+        waitingLabel->hide();
     }
-    else if (type == "answer") {
-        QString playerName = data["playerName"].toString();
-        int answer = data["answer"].toInt();
+    
+    if (flags & DIRTY_TIMER) {
+        const bool urgent = pendingSecondsLeft <= 3;
+        const QString text = QString("Temps restant: %1s").arg(pendingSecondsLeft);
+        
+        // Texte riche plutôt qu'un setStyleSheet : pas de recalcul de style
+        timerLabel->setText(urgent ? QString("<b>%1</b>").arg(text) : text);
+        timerProgress->setValue(pendingSecondsLeft);
+    }
+    
+    if (flags & (DIRTY_RESULTS | DIRTY_FINAL_RESULTS)) {
+        stopQuestionAudio();
+    }
+    
+    if (flags & DIRTY_RESULTS) {
+        ensurePage(RESULTS_PAGE);
+        updateResults();
+        
+        // Montrer le bouton seulement pour l'hôte
         if (isHost) {
-            game->submitAnswer(playerName, answer);
+            nextQuestionBtn->show();
+            nextQuestionBtn->setEnabled(true);
+        } else {
+            nextQuestionBtn->hide();
         }
     }
-    else if (type == "next_question") {
-        qDebug() << "Received next_question message, isHost:" << isHost;
-        if (!isHost) {
-            qDebug() << "Client processing next question";
-            game->nextQuestion();
-        } else {
-            qDebug() << "Host ignoring next_question message (already processed)";
+    
+    if (flags & DIRTY_FINAL_RESULTS) {
+        ensurePage(FINAL_RESULTS_PAGE);
+        updateFinalResults();
+    }
+    
+    if ((flags & DIRTY_PAGE) && pendingPage >= 0) {
+        if (stackedWidget->currentWidget() != pageWidget(pendingPage)) {
+            showPage(pendingPage);
         }
+        pendingPage = -1;
     }
 }
+
+void MainWindow::debugGameState()
+{
+    qDebug() << "=== DEBUG GAME STATE ===";
+    qDebug() << "Current question index:" << snapshot.questionIndex;
+    qDebug() << "Total questions:" << snapshot.totalQuestions;
+    qDebug() << "Game state:" << snapshot.state;
+    qDebug() << "Is host:" << isHost;
+    qDebug() << "Current page:" << stackedWidget->currentIndex();
+    if (resultsPage) {
+        qDebug() << "Next question button visible:" << nextQuestionBtn->isVisible();
+        qDebug() << "Next question button enabled:" << nextQuestionBtn->isEnabled();
+    }
+    qDebug() << "========================";
+}
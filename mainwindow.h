@@ -5,10 +5,10 @@
 #include <QLabel>
 #include <QTimer>
 #include <QProgressBar>
-#include <QListWidget>
 #include <QJsonObject>
-#include "game.h"
-#include "networkmanager.h"
+#include "gamesession.h"
+#include "playerlistmodel.h"
+#include "scoretablemodel.h"
 
 QT_BEGIN_NAMESPACE
 class QLineEdit;
@@ -18,7 +18,10 @@ class QVBoxLayout;
 class QHBoxLayout;
 class QStackedWidget;
 class QComboBox;
-class QTextEdit;
+class QListView;
+class QTableView;
+class QThread;
+class QMediaPlayer;
 QT_END_NAMESPACE
 
 class MainWindow : public QMainWindow
@@ -28,6 +31,9 @@ class MainWindow : public QMainWindow
 public:
     MainWindow(QWidget *parent = nullptr);
     ~MainWindow();
+    
+    void startStandby();    // fenêtre cachée jusqu'à la reprise de la partie
+    void startTakeover();   // idem, partie et sockets reçues de l'hôte en cours
 
 private slots:
     // UI Slots
@@ -38,25 +44,25 @@ private slots:
     void onNextQuestionClicked();
     void onBackToMenuClicked();
     
-    // Game Slots
+    // Session Slots (connexions en file depuis le thread du jeu)
     void onGameCreated(const QString& code);
     void onPlayerJoined(const QString& playerName);
     void onPlayerLeft(const QString& playerName);
     void onGameStarted();
-    void onQuestionChanged(const Question& question);
-    void onAnswerSubmitted(const QString& playerName, int answer);
-    void onAllAnswersReceived();
-    void onResultsReady(const QMap<QString, bool>& results);
-    void onGameEnded(const QString& winner);
+    void onQuestionChanged(const GameSnapshot& snapshot);
+    void onMediaReady(const GameSnapshot& snapshot);
+    void onResultsReady(const GameSnapshot& snapshot);
+    void onGameEnded(const GameSnapshot& snapshot);
     void onTimeUpdate(int secondsLeft);
-    
-    // Network Slots
-    void onServerStarted(quint16 port);
-    void onClientConnected(const QString& clientId);
-    void onClientDisconnected(const QString& clientId);
-    void onConnectedToHost();
-    void onMessageReceived(const QJsonObject& message, const QString& senderId);
+    void onServerStartFailed();
     void onConnectionError(const QString& error);
+    void onTookOver(const QString& playerName);
+    void onHandedOff();
+    void onHandoffFailed(const QString& error);
+    void onGameLeft(quint64 epoch);
+    
+    // Frame scheduler
+    void flushUpdates();
 
 private:
     // UI Setup
@@ -71,19 +77,27 @@ private:
     void debugGameState();
     
     // UI Updates
-    void updatePlayerList();
     void updateGameQuestion();
+    void updateGameMedia();
+    void playQuestionAudio(const QString& path);
+    void stopQuestionAudio();
     void updateResults();
     void updateFinalResults();
+    QString teamSummary(int rows) const;
     void showPage(int pageIndex);
+    QWidget* ensurePage(int pageIndex);
+    QWidget* pageWidget(int pageIndex) const;
+    void scheduleUpdate(int flags);
+    void schedulePage(int pageIndex);
+    void resetPendingUpdates();
+    QTableView* createScoreView();
     
-    // Network messaging
-    void sendNetworkMessage(const QString& type, const QJsonObject& data = QJsonObject());
-    void handleNetworkMessage(const QJsonObject& message, const QString& senderId);
-    
-    // Core objects
-    Game* game;
-    NetworkManager* networkManager;
+    // Core objects (GameSession vit sur coreThread)
+    QThread* coreThread;
+    GameSession* session;
+    GameSnapshot snapshot;
+    PlayerListModel* playerModel;
+    ScoreTableModel* scoreModel;
     
     // UI Components
     QStackedWidget* stackedWidget;
@@ -93,6 +107,7 @@ private:
     QPushButton* createGameBtn;
     QPushButton* joinGameBtn;
     QLineEdit* playerNameEdit;
+    QLineEdit* teamEdit;
     
     // Create game page
     QWidget* createGamePage;
@@ -109,7 +124,7 @@ private:
     // Lobby page
     QWidget* lobbyPage;
     QLabel* gameCodeLabel;
-    QListWidget* playerListWidget;
+    QListView* playerListView;
     QPushButton* startGameBtn;
     QPushButton* backToMenuBtn3;
     QLabel* statusLabel;
@@ -117,6 +132,8 @@ private:
     // Game page
     QWidget* gamePage;
     QLabel* questionLabel;
+    QLabel* mediaLabel;
+    QMediaPlayer* audioPlayer;      // créé au premier son de question
     QLabel* questionCounter;
     QLabel* timerLabel;
     QProgressBar* timerProgress;
@@ -129,22 +146,44 @@ private:
     
     // Results page
     QWidget* resultsPage;
-    QTextEdit* resultsText;
+    QLabel* resultsSummaryLabel;
+    QTableView* resultsView;
     QPushButton* nextQuestionBtn;
     QPushButton* backToMenuBtn4;
     
     // Final results page
     QWidget* finalResultsPage;
     QLabel* winnerLabel;
-    QTextEdit* finalScoresText;
+    QTableView* finalScoresView;
     QPushButton* backToMenuBtn5;
     
     // State variables
     QString currentPlayerName;
     bool isHost;
     int selectedAnswer;
+    // Partie en cours côté session : jusqu'à gameLeft(sessionEpoch), ce qui
+    // arrive vient de la partie quittée
+    quint64 sessionEpoch;
+    quint64 leftEpoch;
+    bool isStale(const GameSnapshot& s) const { return s.epoch != sessionEpoch; }
+    bool isLeaving() const { return leftEpoch != sessionEpoch; }
     QTimer* uiUpdateTimer;
     
+    // Changements de vue en attente du prochain frame
+    enum DirtyFlag {
+        DIRTY_ROSTER = 0x01,
+        DIRTY_QUESTION = 0x02,
+        DIRTY_TIMER = 0x04,
+        DIRTY_RESULTS = 0x08,
+        DIRTY_FINAL_RESULTS = 0x10,
+        DIRTY_PAGE = 0x20,
+        DIRTY_MEDIA = 0x40
+    };
+    int dirtyFlags;
+    QList<QPair<QString, bool>> pendingRoster;   // (joueur, arrivé?) dans l'ordre reçu
+    int pendingSecondsLeft;
+    int pendingPage;
+    
     enum PageIndex {
         MENU_PAGE = 0,
         CREATE_GAME_PAGE = 1,
@@ -0,0 +1,113 @@
+#include "mediacache.h"
+#include "questionbank.h"
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QStandardPaths>
+
+static const char PART_SUFFIX[] = ".part";
+static const int PART_LIFETIME_S = 3600;
+
+MediaCache::MediaCache(const QString &directory, qint64 capacity)
+    : directory(directory), capacity(capacity)
+{
+    QDir().mkpath(directory);
+}
+
+QString MediaCache::defaultDirectory()
+{
+    QString path = qEnvironmentVariable("QUIZZ_MEDIA_CACHE");
+    if (path.isEmpty())
+        path = QStandardPaths::writableLocation(QStandardPaths::CacheLocation) + "/media";
+    return path;
+}
+
+QString MediaCache::filePath(const QByteArray &hash) const
+{
+    return directory + '/' + QString::fromLatin1(hash.toHex());
+}
+
+bool MediaCache::contains(const QByteArray &hash) const
+{
+    return hash.size() == 32 && QFileInfo::exists(filePath(hash));
+}
+
+QString MediaCache::path(const QByteArray &hash) const
+{
+    if (!contains(hash))
+        return QString();
+
+    // La date de modification sert d'ordre LRU pour evict()
+    const QString path = filePath(hash);
+    QFile file(path);
+    if (file.open(QIODevice::ReadWrite))
+        file.setFileTime(QDateTime::currentDateTimeUtc(), QFileDevice::FileModificationTime);
+    return path;
+}
+
+qint64 MediaCache::receivedBytes(const QByteArray &hash) const
+{
+    const QFileInfo part(filePath(hash) + PART_SUFFIX);
+    return part.exists() ? part.size() : 0;
+}
+
+MediaCache::WriteResult MediaCache::write(const QByteArray &hash, qint64 offset, const QByteArray &data, qint64 totalSize)
+{
+    if (hash.size() != 32 || totalSize <= 0 || totalSize > QuestionBank::MAX_MEDIA_SIZE
+            || offset < 0 || offset + data.size() > totalSize)
+        return REJECTED;
+    if (contains(hash))
+        return COMPLETE;
+
+    const QString target = filePath(hash);
+    QFile part(target + PART_SUFFIX);
+    if (!part.open(QIODevice::ReadWrite))
+        return REJECTED;
+    if (offset + data.size() <= part.size())
+        return INCOMPLETE;              // déjà reçu (demande répétée)
+    if (offset > part.size())
+        return REJECTED;                // trou : à redemander depuis receivedBytes()
+
+    part.seek(offset);
+    if (part.write(data) != data.size()) {
+        part.resize(offset);
+        return REJECTED;
+    }
+    if (part.size() < totalSize)
+        return INCOMPLETE;
+
+    part.seek(0);
+    QCryptographicHash digest(QCryptographicHash::Sha256);
+    digest.addData(&part);
+    part.close();
+    if (part.size() != totalSize || digest.result() != hash) {
+        part.remove();
+        return REJECTED;
+    }
+    QFile::remove(target);
+    if (!part.rename(target))
+        return REJECTED;
+    evict(target);
+    return COMPLETE;
+}
+
+void MediaCache::evict(const QString &keep)
+{
+    // Plus récents d'abord : on garde tant que la capacité le permet. Un
+    // téléchargement récent (.part) reste, il reprendra à la reconnexion.
+    const QFileInfoList files = QDir(directory).entryInfoList(QDir::Files, QDir::Time);
+    const QDateTime recent = QDateTime::currentDateTimeUtc().addSecs(-PART_LIFETIME_S);
+    const QString kept = QFileInfo(keep).absoluteFilePath();
+    qint64 used = 0;
+    for (const QFileInfo &file : files) {
+        used += file.size();
+        if (used <= capacity || file.absoluteFilePath() == kept)
+            continue;
+        if (file.fileName().endsWith(PART_SUFFIX) && file.lastModified() > recent)
+            continue;
+        if (QFile::remove(file.absoluteFilePath()))
+            used -= file.size();
+    }
+}
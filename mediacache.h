@@ -0,0 +1,43 @@
+#ifndef MEDIACACHE_H
+#define MEDIACACHE_H
+
+#include <QByteArray>
+#include <QString>
+
+// Cache disque des médias reçus de l'hôte, adressé par contenu (SHA-256).
+//
+// Un fichier par média, nommé par son empreinte en hexadécimal : un joueur
+// qui revient (ou qui rejoue une banque déjà vue) ne retélécharge rien. Le
+// téléchargement en cours s'écrit dans "<empreinte>.part" et reprend là où il
+// s'était arrêté. Un média complet est vérifié puis renommé ; au-delà de la
+// capacité, les moins récemment utilisés (date de modification, remise à
+// jour à chaque lecture) sont supprimés.
+class MediaCache
+{
+public:
+    enum WriteResult { INCOMPLETE, COMPLETE, REJECTED };
+
+    static constexpr qint64 DEFAULT_CAPACITY = 256 * 1024 * 1024;
+
+    explicit MediaCache(const QString &directory = defaultDirectory(), qint64 capacity = DEFAULT_CAPACITY);
+
+    static QString defaultDirectory();      // QUIZZ_MEDIA_CACHE, sinon media/ du cache de l'application
+
+    bool contains(const QByteArray &hash) const;
+    QString path(const QByteArray &hash) const;             // vide si absent ; compte comme une utilisation
+    qint64 receivedBytes(const QByteArray &hash) const;     // déjà reçus d'un téléchargement en cours
+
+    // Morceau [offset, offset + data.size()) d'un média de totalSize octets.
+    // REJECTED : morceau hors séquence ou contenu final différent de l'empreinte
+    // (le téléchargement repart de zéro).
+    WriteResult write(const QByteArray &hash, qint64 offset, const QByteArray &data, qint64 totalSize);
+
+private:
+    QString filePath(const QByteArray &hash) const;
+    void evict(const QString &keep);
+
+    QString directory;
+    qint64 capacity;
+};
+
+#endif // MEDIACACHE_H
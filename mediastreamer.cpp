@@ -0,0 +1,197 @@
+#include "mediastreamer.h"
+#include <QCryptographicHash>
+#include <QDebug>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+MediaStreamer::MediaStreamer(Game *game, NetworkManager *networkManager, QObject *parent)
+    : QObject(parent), game(game), networkManager(networkManager), nextClient(0)
+{
+    tickTimer = new QTimer(this);
+    tickTimer->setInterval(TICK_MS);
+    connect(tickTimer, &QTimer::timeout, this, &MediaStreamer::onTick);
+
+    frames.setMaxCost(FRAME_CACHE_COST);
+
+    connect(networkManager, &NetworkManager::clientDisconnected, this, &MediaStreamer::cancel);
+    connect(game, &Game::gameCreated, this, [this]() {
+        transfers.clear();
+    });
+}
+
+void MediaStreamer::request(const QString &clientId, const QJsonArray &assets)
+{
+    // Seuls les médias de la partie en cours, un transfert par média
+    QHash<QByteArray, qint64> sizes;
+    for (const Question &question : game->getQuestions()) {
+        if (!question.getMedia().isNull())
+            sizes.insert(question.getMedia().hash, question.getMedia().size);
+    }
+
+    QVector<Transfer> queue = transfers.value(clientId);
+    for (const QJsonValue &value : assets) {
+        const QJsonObject asset = value.toObject();
+        const QByteArray hash = QByteArray::fromHex(asset["hash"].toString().toLatin1());
+        const qint64 offset = qint64(asset["offset"].toDouble());
+        const auto size = sizes.constFind(hash);
+        if (size == sizes.constEnd() || offset < 0 || offset >= size.value())
+            continue;
+
+        // Reprise au début du morceau qui contient offset
+        const Transfer transfer{hash, size.value(), int(offset / CHUNK_SIZE)};
+        const auto known = std::find_if(queue.begin(), queue.end(), [&hash](const Transfer &t) {
+            return t.hash == hash;
+        });
+        if (known != queue.end())
+            *known = transfer;
+        else
+            queue.append(transfer);
+    }
+    if (queue.isEmpty())
+        return;
+
+    if (!transfers.contains(clientId))
+        order.append(clientId);
+    transfers.insert(clientId, queue);
+    if (!tickTimer->isActive())
+        tickTimer->start();
+}
+
+void MediaStreamer::cancel(const QString &clientId)
+{
+    // order est nettoyé au tick suivant
+    transfers.remove(clientId);
+}
+
+void MediaStreamer::onTick()
+{
+    order.removeIf([this](const QString &clientId) { return !transfers.contains(clientId); });
+    if (order.isEmpty() || !networkManager->isServer()) {
+        transfers.clear();
+        order.clear();
+        tickTimer->stop();
+        return;
+    }
+
+    // Pendant une question, seul son média (éventuel) peut partir
+    QByteArray current;
+    const QByteArray *only = nullptr;
+    if (game->getState() == Game::QUESTION_ACTIVE) {
+        current = game->getCurrentQuestion().getMedia().hash;
+        if (current.isEmpty())
+            return;
+        only = &current;
+    }
+
+    // Un morceau par client et par passe, en reprenant là où le tick précédent s'est arrêté
+    const QStringList clients = order;
+    qint64 budget = BYTES_PER_SECOND * TICK_MS / 1000;
+    bool progress = true;
+    while (budget > 0 && progress) {
+        progress = false;
+        for (int i = 0; i < clients.size() && budget > 0; ++i) {
+            const int index = (nextClient + i) % clients.size();
+            if (sendNext(clients.at(index), only, &budget)) {
+                progress = true;
+                if (budget <= 0)
+                    nextClient = index + 1;
+            }
+        }
+    }
+}
+
+bool MediaStreamer::sendNext(const QString &clientId, const QByteArray *only, qint64 *budget)
+{
+    auto it = transfers.find(clientId);
+    if (it == transfers.end())
+        return false;
+
+    QVector<Transfer> &queue = it.value();
+    int index = 0;
+    if (only) {
+        index = -1;
+        for (int i = 0; i < queue.size() && index < 0; ++i) {
+            if (queue.at(i).hash == *only)
+                index = i;
+        }
+        if (index < 0)
+            return false;
+    }
+
+    const qint64 pending = networkManager->bytesPending(clientId);
+    if (pending < 0) {
+        transfers.erase(it);
+        return false;
+    }
+    if (pending > LOW_WATERMARK)
+        return false;
+
+    const Transfer transfer = queue.at(index);
+    Frame *chunk = frame(transfer.hash, transfer.size, transfer.chunk);
+    const int chunkCount = int((transfer.size + CHUNK_SIZE - 1) / CHUNK_SIZE);
+    if (!chunk || transfer.chunk + 1 >= chunkCount)
+        queue.removeAt(index);      // dernier morceau, ou fichier absent de la banque
+    else
+        ++queue[index].chunk;
+    if (queue.isEmpty())
+        transfers.erase(it);
+    if (!chunk)
+        return false;
+
+    *budget -= chunk->plain.size();
+    networkManager->sendFrameTo(clientId, chunk->plain, chunk->compressed);
+    return true;
+}
+
+MediaStreamer::Frame *MediaStreamer::frame(const QByteArray &hash, qint64 size, int chunk)
+{
+    const QByteArray key = hash + QByteArray::number(chunk);
+    if (Frame *cached = frames.object(key))
+        return cached;
+
+    const QString path = mediaFile(hash, size);
+    QFile file(path);
+    const qint64 offset = qint64(chunk) * CHUNK_SIZE;
+    if (path.isEmpty() || !file.open(QIODevice::ReadOnly) || !file.seek(offset))
+        return nullptr;
+    const QByteArray bytes = file.read(CHUNK_SIZE);
+    if (bytes.isEmpty())
+        return nullptr;
+
+    QJsonObject data;
+    data["hash"] = QString::fromLatin1(hash.toHex());
+    data["offset"] = double(offset);
+    data["size"] = double(size);
+    data["data"] = QString::fromLatin1(bytes.toBase64());
+
+    QJsonObject message;
+    message["type"] = "asset_chunk";
+    message["data"] = data;
+
+    Frame *encoded = new Frame;
+    encoded->plain = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    encoded->plain.append('\n');
+    // Coût doublé : la version compressée s'y ajoute au premier envoi
+    frames.insert(key, encoded, int(encoded->plain.size()) * 2);
+    return frames.object(key);
+}
+
+QString MediaStreamer::mediaFile(const QByteArray &hash, qint64 size)
+{
+    // Banque de la partie en cours : un rechargement ne change pas les médias servis
+    const QString path = game->getQuestionSnapshot().bank().mediaFile(hash);
+    if (path.isEmpty() || verified.value(hash) == path)
+        return path;
+
+    // Relu une fois : le fichier a pu changer depuis le chargement de la banque
+    QFile file(path);
+    QCryptographicHash digest(QCryptographicHash::Sha256);
+    if (!file.open(QIODevice::ReadOnly) || file.size() != size || !digest.addData(&file) || digest.result() != hash) {
+        qWarning() << "Question media changed or unreadable:" << path;
+        return QString();
+    }
+    verified.insert(hash, path);
+    return path;
+}
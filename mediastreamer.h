@@ -0,0 +1,69 @@
+#ifndef MEDIASTREAMER_H
+#define MEDIASTREAMER_H
+
+#include <QObject>
+#include <QTimer>
+#include <QCache>
+#include <QHash>
+#include <QJsonArray>
+#include "game.h"
+#include "networkmanager.h"
+
+// Envoi des médias des questions aux joueurs, par morceaux et en basse
+// priorité.
+//
+// Un joueur demande ce qui manque à son cache ("asset_request", avec ce
+// qu'il en a déjà reçu). À chaque tick, un morceau par joueur et par passe,
+// dans la limite d'un débit global et seulement vers les connexions dont le
+// tampon d'écriture est presque vide : les messages de jeu passent devant.
+// Pendant une question, seul le média de la question en cours part (joueur
+// arrivé en retard). Un morceau est encodé une fois et resservi à tous ceux
+// qui le demandent.
+class MediaStreamer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int CHUNK_SIZE = 16 * 1024;
+    static const int TICK_MS = 20;
+    static constexpr qint64 BYTES_PER_SECOND = 4 * 1024 * 1024;    // part de la liaison montante de l'hôte
+    static constexpr qint64 LOW_WATERMARK = 32 * 1024;             // au-delà, la connexion attend
+    static const int FRAME_CACHE_COST = 32 * 1024 * 1024;         // octets de morceaux encodés gardés
+
+    MediaStreamer(Game *game, NetworkManager *networkManager, QObject *parent = nullptr);
+
+    void request(const QString &clientId, const QJsonArray &assets);    // [{hash, offset}]
+    void cancel(const QString &clientId);
+
+private slots:
+    void onTick();
+
+private:
+    struct Transfer
+    {
+        QByteArray hash;
+        qint64 size;
+        int chunk;                  // prochain morceau à envoyer
+    };
+    struct Frame
+    {
+        QByteArray plain;
+        QByteArray compressed;      // rempli par NetworkManager au premier envoi compressé
+    };
+
+    bool sendNext(const QString &clientId, const QByteArray *only, qint64 *budget);
+    Frame *frame(const QByteArray &hash, qint64 size, int chunk);
+    QString mediaFile(const QByteArray &hash, qint64 size);
+
+    Game *game;
+    NetworkManager *networkManager;
+    QTimer *tickTimer;
+
+    QHash<QString, QVector<Transfer>> transfers;    // par client, dans l'ordre des questions
+    QStringList order;                              // tourniquet entre les clients
+    int nextClient;
+    QCache<QByteArray, Frame> frames;               // empreinte + numéro de morceau
+    QHash<QByteArray, QString> verified;            // empreinte -> fichier relu et vérifié
+};
+
+#endif // MEDIASTREAMER_H
@@ -1,16 +1,99 @@
 
 // ---------- networkmanager.cpp ----------
 #include "networkmanager.h"
+#include "framecodec.h"
+#include "framereader.h"
+#include "uringtransport.h"
 #include <QHostAddress>
-#include <QRandomGenerator>
 #include <QJsonParseError>
 #include <QDebug>
+#include <QtEndian>
+#include <QTimer>
 
 static const char TERMINATOR = '\n'; // delimite chaque message JSON
 
+// Limites côté hôte : un client bogué ou hostile est éjecté avant de
+// ralentir les autres
+static constexpr int MAX_CLIENT_FRAME_SIZE = 16 * 1024;     // JSON client (join, answer...), décompressé compris
+static constexpr qint64 READ_BUFFER_SIZE = 64 * 1024;       // au-delà, le noyau freine l'émetteur
+// Plafonds par défaut, remplacés par QUIZZ_MAX_CONNECTIONS, QUIZZ_MAX_CONNECTIONS_PER_ADDRESS,
+// QUIZZ_MAX_SPECTATORS et QUIZZ_MAX_SPECTATORS_PER_ADDRESS. Les spectateurs ont leur propre
+// budget : une salle qui regarde ne prend pas la place des joueurs.
+static constexpr int MAX_CONNECTIONS = 512;
+static constexpr int MAX_CONNECTIONS_PER_ADDRESS = 32;
+static constexpr int MAX_SPECTATORS = 4096;
+static constexpr int MAX_SPECTATORS_PER_ADDRESS = 256;
+static constexpr int MAX_TRACKED_ADDRESSES = 4096;
+static constexpr double ACCEPT_RATE = 50.0, ACCEPT_BURST = 100.0;
+static constexpr double MESSAGE_RATE = 20.0, MESSAGE_BURST = 40.0;
+// Débits par adresse par défaut, remplacés par QUIZZ_ADDRESS_ACCEPT_RATE, QUIZZ_ADDRESS_ACCEPT_BURST,
+// QUIZZ_ADDRESS_MESSAGE_RATE et QUIZZ_ADDRESS_MESSAGE_BURST. Une salle derrière un NAT, ou tous
+// les clients d'un QuizzProxy local, partagent la même adresse.
+static constexpr int ADDRESS_ACCEPT_RATE = 5, ADDRESS_ACCEPT_BURST = 20;
+static constexpr int ADDRESS_MESSAGE_RATE = 100, ADDRESS_MESSAGE_BURST = 200;
+static constexpr int ACCEPT_RESUME_MS = 20;
+static constexpr int THROTTLE_RESUME_MS = 20;
+static constexpr qint64 SPECTATOR_BACKLOG = 256 * 1024;  // au-delà, seule la dernière trame attend
+
+static int limitFromEnvironment(const char *name, int fallback)
+{
+    bool ok = false;
+    const int value = qEnvironmentVariableIntValue(name, &ok);
+    return ok && value > 0 ? value : fallback;
+}
+
+static void captureFrame(TrafficCapture *capture, TrafficCapture::EventKind kind, quint64 connection,
+                         const QByteArray &frame)
+{
+    if (!capture)
+        return;
+    const int size = frame.endsWith(TERMINATOR) ? int(frame.size()) - 1 : int(frame.size());
+    capture->record(kind, connection, frame.constData(), size);
+}
+
 NetworkManager::NetworkManager(QObject *parent)
-    : QObject(parent), server(nullptr), clientSocket(nullptr), serverMode(false)
+    : QObject(parent), server(nullptr), uring(nullptr), clientSocket(nullptr), serverMode(false), handedOff(false),
+      hostInterned(false), capture(TrafficCapture::shared()), spectatorTotal(0)
 {
+    limitClock.start();
+    maxConnections = limitFromEnvironment("QUIZZ_MAX_CONNECTIONS", MAX_CONNECTIONS);
+    maxConnectionsPerAddress = limitFromEnvironment("QUIZZ_MAX_CONNECTIONS_PER_ADDRESS", MAX_CONNECTIONS_PER_ADDRESS);
+    maxSpectators = limitFromEnvironment("QUIZZ_MAX_SPECTATORS", MAX_SPECTATORS);
+    maxSpectatorsPerAddress = limitFromEnvironment("QUIZZ_MAX_SPECTATORS_PER_ADDRESS", MAX_SPECTATORS_PER_ADDRESS);
+    addressAcceptRate = limitFromEnvironment("QUIZZ_ADDRESS_ACCEPT_RATE", ADDRESS_ACCEPT_RATE);
+    addressAcceptBurst = limitFromEnvironment("QUIZZ_ADDRESS_ACCEPT_BURST", ADDRESS_ACCEPT_BURST);
+    addressMessageRate = limitFromEnvironment("QUIZZ_ADDRESS_MESSAGE_RATE", ADDRESS_MESSAGE_RATE);
+    addressMessageBurst = limitFromEnvironment("QUIZZ_ADDRESS_MESSAGE_BURST", ADDRESS_MESSAGE_BURST);
+
+    // Débit d'acceptation dépassé : les connexions attendent dans la file du noyau
+    acceptResumeTimer = new QTimer(this);
+    acceptResumeTimer->setSingleShot(true);
+    acceptResumeTimer->setInterval(ACCEPT_RESUME_MS);
+    connect(acceptResumeTimer, &QTimer::timeout, this, [this]() {
+        if (uring) {
+            uring->resumeAccepting();
+            onUringConnection();
+            return;
+        }
+        if (!server)
+            return;
+        server->resumeAccepting();
+        onNewConnection();
+    });
+
+    // Seau d'une adresse vide : les trames attendent dans le tampon de leur session
+    throttleTimer = new QTimer(this);
+    throttleTimer->setSingleShot(true);
+    throttleTimer->setInterval(THROTTLE_RESUME_MS);
+    connect(throttleTimer, &QTimer::timeout, this, &NetworkManager::resumeThrottled);
+
+    if (capture) {
+        // Un processus tué ne perd que les derniers instants de sa capture
+        QTimer *captureTimer = new QTimer(this);
+        captureTimer->setInterval(TrafficCapture::FLUSH_INTERVAL_MS);
+        connect(captureTimer, &QTimer::timeout, this, [this]() { capture->flush(); });
+        captureTimer->start();
+    }
 }
 
 NetworkManager::~NetworkManager()
@@ -21,14 +104,37 @@ NetworkManager::~NetworkManager()
 
 bool NetworkManager::startServer(quint16 port)
 {
-    if (server)
+    QString error;
+    if (!listen(port, &error)) {
+        emit connectionError("Cannot start server: " + error);
+        return false;
+    }
+    return true;
+}
+
+bool NetworkManager::tryStartServer(quint16 port)
+{
+    QString error;
+    return listen(port, &error);
+}
+
+bool NetworkManager::listen(quint16 port, QString *error)
+{
+    if (server || uring)
         stopServer();
 
+    // io_uring sur demande ; QTcpServer partout ailleurs et en repli
+    if (qEnvironmentVariableIntValue("QUIZZ_IO_URING") && UringTransport::isSupported()) {
+        if (listenUring(port, error))
+            return true;
+        qWarning() << "io_uring transport unavailable, using QTcpServer:" << *error;
+    }
+
     server = new QTcpServer(this);
     connect(server, &QTcpServer::newConnection, this, &NetworkManager::onNewConnection);
 
     if (!server->listen(QHostAddress::Any, port)) {
-        emit connectionError("Cannot start server: " + server->errorString());
+        *error = server->errorString();
         server->deleteLater();
         server = nullptr;
         return false;
@@ -39,21 +145,63 @@ bool NetworkManager::startServer(quint16 port)
     return true;
 }
 
+bool NetworkManager::listenUring(quint16 port, QString *error)
+{
+    uring = new UringTransport(this);
+    // Rappels directs, sans signal ni readAll() : les données lues arrivent dans les tampons de l'anneau
+    uring->newConnection = [this]() { onUringConnection(); };
+    uring->received = [this](quint64 tag, const char *data, int size) {
+        receiveFromClient(ClientHandle::fromKey(tag), data, size);
+    };
+    uring->sent = [this](quint64 tag) { onClientBytesWritten(ClientHandle::fromKey(tag)); };
+    uring->closed = [this](quint64 tag) { removeClient(ClientHandle::fromKey(tag)); };
+
+    if (!uring->listen(port, error)) {
+        delete uring;
+        uring = nullptr;
+        return false;
+    }
+
+    serverMode = true;
+    emit serverStarted(uring->serverPort());
+    return true;
+}
+
 void NetworkManager::stopServer()
 {
-    if (!server)
+    if (!server && !uring)
         return;
 
-    for (auto it = connectedClients.begin(); it != connectedClients.end(); ++it) {
-        it.key()->disconnectFromHost();
-        it.key()->deleteLater();
-    }
-    connectedClients.clear();
-    buffers.clear();
+    clients.forEach([this](ClientHandle, ClientSlot &slot) {
+        if (!slot.socket)
+            return;     // io_uring : fermées par stop()
+        disconnect(slot.socket, nullptr, this, nullptr);
+        // Après un passage de relais, le successeur tient les mêmes connexions :
+        // on ne fait que lâcher notre descripteur
+        if (handedOff)
+            slot.socket->abort();
+        else
+            slot.socket->disconnectFromHost();
+        slot.socket->deleteLater();
+    });
+    clients.clear();
+    lastSpectatorFrame.clear();
+    lastSpectatorCompressed.clear();
+    addressLimits.clear();
+    spectatorTotal = 0;
+    acceptResumeTimer->stop();
+    throttleTimer->stop();
 
-    server->close();
-    server->deleteLater();
-    server = nullptr;
+    if (uring) {
+        // Peut être appelé depuis un de ses rappels : détruit au retour dans la boucle
+        uring->stop();
+        uring->deleteLater();
+        uring = nullptr;
+    } else {
+        server->close();
+        server->deleteLater();
+        server = nullptr;
+    }
     serverMode = false;
 
     emit serverStopped();
@@ -61,6 +209,8 @@ void NetworkManager::stopServer()
 
 quint16 NetworkManager::getServerPort() const
 {
+    if (uring)
+        return uring->serverPort();
     return (server && server->isListening()) ? server->serverPort() : 0;
 }
 
@@ -70,15 +220,19 @@ void NetworkManager::connectToHost(const QString &hostAddress, quint16 port)
         disconnectFromHost();
 
     clientSocket = new QTcpSocket(this);
-    connect(clientSocket, &QTcpSocket::connected, this, &NetworkManager::connectedToHost);
+    connect(clientSocket, &QTcpSocket::connected, this, [this]() {
+        sendHello();
+        emit connectedToHost();
+    });
     connect(clientSocket, &QTcpSocket::disconnected, this, &NetworkManager::disconnectedFromHost);
-    connect(clientSocket, &QTcpSocket::readyRead, this, &NetworkManager::onDataReceived);
+    connect(clientSocket, &QTcpSocket::readyRead, this, &NetworkManager::onHostData);
     connect(clientSocket, QOverload<QAbstractSocket::SocketError>::of(&QTcpSocket::errorOccurred),
             [this](QAbstractSocket::SocketError) {
                 emit connectionError(clientSocket->errorString());
             });
 
     serverMode = false;
+    hostInterned = false;
     clientSocket->connectToHost(hostAddress, port);
 }
 
@@ -91,6 +245,7 @@ void NetworkManager::disconnectFromHost()
     clientSocket->deleteLater();
     clientSocket = nullptr;
     clientBuffer.clear();
+    hostInterned = false;
 }
 
 void NetworkManager::sendMessage(const QJsonObject &message)
@@ -102,14 +257,70 @@ void NetworkManager::sendMessage(const QJsonObject &message)
     }
 }
 
+void NetworkManager::sendMessageTo(const QString &clientId, const QJsonObject &message)
+{
+    if (!serverMode)
+        return;
+
+    sendToSlot(ClientHandle::fromClientId(clientId), message);
+}
+
 void NetworkManager::broadcastMessage(const QJsonObject &message)
 {
     if (!serverMode)
         return;
 
-    for (auto it = connectedClients.begin(); it != connectedClients.end(); ++it) {
-        sendToClient(it.key(), message);
-    }
+    // Encodé (et compressé au besoin) une seule fois pour tous les joueurs
+    QByteArray plain = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    plain.append(TERMINATOR);
+    QByteArray compressed;
+    captureFrame(capture, TrafficCapture::FRAME_OUT, TrafficCapture::ALL_PLAYERS, plain);
+
+    clients.forEach([&](ClientHandle, ClientSlot &slot) {
+        if (!slot.spectator)
+            writeToSlot(slot, plain, compressed, true);
+    });
+}
+
+void NetworkManager::broadcastToSpectators(const QByteArray &frame)
+{
+    if (!serverMode)
+        return;
+
+    lastSpectatorFrame = frame;
+    lastSpectatorCompressed.clear();
+    captureFrame(capture, TrafficCapture::FRAME_OUT, TrafficCapture::ALL_SPECTATORS, frame);
+
+    // Même QByteArray (partagé) pour tous, pas de flush : la boucle d'événements écrit
+    clients.forEach([this](ClientHandle, ClientSlot &slot) {
+        if (!slot.spectator)
+            return;
+        // Spectateur lent : les états intermédiaires sont périmés, seul le
+        // dernier attend que sa socket se vide
+        if (bytesToWrite(slot) > SPECTATOR_BACKLOG)
+            slot.outbound = lastSpectatorFrame;
+        else
+            writeToSlot(slot, lastSpectatorFrame, lastSpectatorCompressed, false);
+    });
+}
+
+void NetworkManager::sendFrameTo(const QString &clientId, const QByteArray &frame, QByteArray &compressedCache)
+{
+    if (!serverMode)
+        return;
+
+    const ClientHandle handle = ClientHandle::fromClientId(clientId);
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;
+    captureFrame(capture, TrafficCapture::FRAME_OUT, handle.key(), frame);
+    writeToSlot(*slot, frame, compressedCache, false);
+}
+
+qint64 NetworkManager::bytesPending(const QString &clientId) const
+{
+    const ClientSlot *slot = clients.find(ClientHandle::fromClientId(clientId));
+    return slot ? bytesToWrite(*slot) + slot->outbound.size() : -1;
 }
 
 bool NetworkManager::isServer() const
@@ -119,113 +330,800 @@ bool NetworkManager::isServer() const
 
 bool NetworkManager::isConnected() const
 {
-    return serverMode ? (server && server->isListening())
+    return serverMode ? ((server && server->isListening()) || (uring && uring->isListening()))
                       : (clientSocket && clientSocket->state() == QTcpSocket::ConnectedState);
 }
 
 QStringList NetworkManager::getConnectedClients() const
 {
-    return connectedClients.values();
+    QStringList players;
+    clients.forEach([&players](ClientHandle handle, const ClientSlot &slot) {
+        if (!slot.spectator)
+            players.append(handle.clientId());
+    });
+    return players;
+}
+
+int NetworkManager::spectatorCount() const
+{
+    return clients.spectatorCount();
 }
 
 void NetworkManager::onNewConnection()
 {
     while (server->hasPendingConnections()) {
+        const qint64 now = limitClock.elapsed();
+        if (!acceptBucket.take(ACCEPT_RATE, ACCEPT_BURST, now)) {
+            server->pauseAccepting();
+            acceptResumeTimer->start();
+            return;
+        }
+
         QTcpSocket *socket = server->nextPendingConnection();
-        QString clientId = generateClientId();
+        const QString address = socket->peerAddress().toString();
+        if (!admitClient(address, now)) {
+            qDebug() << "Connection refused:" << address;
+            socket->abort();
+            socket->deleteLater();
+            continue;
+        }
+
+        const ClientHandle handle = trackClient(socket, address);
+        watchClient(handle);
+
+        emit clientConnected(handle.clientId());
+    }
+}
+
+void NetworkManager::onUringConnection()
+{
+    // Même admission que onNewConnection(), sur les descripteurs acceptés par l'anneau
+    while (uring->hasPendingConnections()) {
+        const qint64 now = limitClock.elapsed();
+        if (!acceptBucket.take(ACCEPT_RATE, ACCEPT_BURST, now)) {
+            uring->pauseAccepting();
+            acceptResumeTimer->start();
+            return;
+        }
+
+        const UringTransport::Accepted accepted = uring->nextPendingConnection();
+        if (!admitClient(accepted.address, now)) {
+            qDebug() << "Connection refused:" << accepted.address;
+            uring->reject(accepted.descriptor);
+            continue;
+        }
+
+        const ClientHandle handle = trackSlot(clients.insert(accepted.descriptor), accepted.address);
+        uring->attach(accepted.descriptor, handle.key());
+
+        emit clientConnected(handle.clientId());
+    }
+}
 
-        connectedClients[socket] = clientId;
-        buffers[socket] = QByteArray();
+bool NetworkManager::admitClient(const QString &address, qint64 nowMs)
+{
+    // Les spectateurs déjà inscrits sont comptés à part (becomeSpectator)
+    if (clients.size() - spectatorTotal >= maxConnections)
+        return false;
 
-        connect(socket, &QTcpSocket::readyRead, this, &NetworkManager::onDataReceived);
-        connect(socket, &QTcpSocket::disconnected, this, &NetworkManager::onClientDisconnected);
+    if (addressLimits.size() >= MAX_TRACKED_ADDRESSES && !addressLimits.contains(address)) {
+        for (auto it = addressLimits.begin(); it != addressLimits.end();)
+            it = it.value().connections == 0 && it.value().spectators == 0 ? addressLimits.erase(it) : std::next(it);
+    }
+    AddressLimits &limits = addressLimits[address];
+    if (limits.connections >= maxConnectionsPerAddress)
+        return false;
+    // Un QuizzProxy local amène tous ses clients depuis la boucle locale :
+    // seul le débit global s'applique
+    return QHostAddress(address).isLoopback()
+        || limits.accepts.take(addressAcceptRate, addressAcceptBurst, nowMs);
+}
 
-        emit clientConnected(clientId);
+ClientHandle NetworkManager::trackClient(QTcpSocket *socket, const QString &address)
+{
+    socket->setReadBufferSize(READ_BUFFER_SIZE);
+    return trackSlot(clients.insert(socket), address);
+}
+
+ClientHandle NetworkManager::trackSlot(ClientHandle handle, const QString &address)
+{
+    ++addressLimits[address].connections;
+
+    ClientSlot *slot = clients.find(handle);
+    slot->address = address;
+    slot->connectedAtMs = limitClock.elapsed();
+    if (capture) {
+        const QByteArray peer = address.toUtf8();
+        capture->record(TrafficCapture::CONNECTION_OPENED, handle.key(), peer.constData(), int(peer.size()));
     }
+    return handle;
+}
+
+bool NetworkManager::becomeSpectator(ClientSlot &slot, bool enforce)
+{
+    AddressLimits &limits = addressLimits[slot.address];
+    if (enforce && (spectatorTotal >= maxSpectators || limits.spectators >= maxSpectatorsPerAddress))
+        return false;
+
+    // Passe du budget des joueurs à celui des spectateurs
+    --limits.connections;
+    ++limits.spectators;
+    ++spectatorTotal;
+    slot.spectator = true;
+    return true;
 }
 
-void NetworkManager::onClientDisconnected()
+NetworkManager::FrameAdmission NetworkManager::admitFrame(ClientHandle handle)
 {
-    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
-    if (!socket)
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return FRAME_REFUSED;
+
+    // Seul le seau de la connexion éjecte. Celui de l'adresse, partagé par
+    // toute une salle derrière un NAT, ne fait qu'attendre la trame ; il
+    // grandit avec les connexions vivantes de l'adresse, une rafale de
+    // réponses simultanées passe donc sans délai.
+    const qint64 now = limitClock.elapsed();
+    if (!slot->messages.take(MESSAGE_RATE, MESSAGE_BURST, now))
+        return FRAME_REFUSED;
+    auto limits = addressLimits.find(slot->address);
+    if (limits != addressLimits.end()) {
+        const double share = qMax(0, limits->connections + limits->spectators - 1) / 2.0;
+        if (!limits->messages.take(addressMessageRate + share * MESSAGE_RATE,
+                                   addressMessageBurst + share * MESSAGE_BURST, now)) {
+            slot->messages.refund();    // la trame sera reprise : pas débitée deux fois
+            return FRAME_DEFERRED;
+        }
+    }
+    ++slot->framesIn;
+    return FRAME_ACCEPTED;
+}
+
+void NetworkManager::throttle(ClientHandle handle)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
         return;
+    slot->throttled = true;
+    if (!throttleTimer->isActive())
+        throttleTimer->start();
+}
 
-    QString clientId = connectedClients.take(socket);
-    buffers.remove(socket);
+void NetworkManager::resumeThrottled()
+{
+    QVector<ClientHandle> throttled;
+    clients.forEach([&throttled](ClientHandle handle, ClientSlot &slot) {
+        if (slot.throttled) {
+            slot.throttled = false;
+            throttled.append(handle);
+        }
+    });
+    for (ClientHandle handle : std::as_const(throttled)) {
+        const ClientSlot *slot = clients.find(handle);
+        if (!slot)
+            continue;
+        // QTcpSocket : ce qui est arrivé entre-temps est resté dans la socket
+        if (slot->socket)
+            onClientData(handle);
+        else
+            processClientInput(handle);
+    }
+}
 
-    socket->deleteLater();
+void NetworkManager::watchClient(ClientHandle handle)
+{
+    // La poignée capturée suffit : plus de recherche par socket à chaque lecture
+    QTcpSocket *socket = clients.find(handle)->socket;
+    connect(socket, &QTcpSocket::readyRead, this, [this, handle]() { onClientData(handle); });
+    connect(socket, &QTcpSocket::bytesWritten, this, [this, handle]() { onClientBytesWritten(handle); });
+    connect(socket, &QTcpSocket::disconnected, this, [this, handle]() { removeClient(handle); });
+}
 
-    emit clientDisconnected(clientId);
+void NetworkManager::beginHandoff()
+{
+    // Les lectures sont mises de côté pour le successeur, les écritures
+    // continuent de partir au rythme de la boucle d'événements
+    if (uring)
+        uring->pauseAccepting();
+    else if (server)
+        server->pauseAccepting();
+    else
+        return;
+    handedOff = true;
 }
 
-void NetworkManager::onDataReceived()
+bool NetworkManager::outputFlushed() const
 {
-    QTcpSocket *socket = qobject_cast<QTcpSocket *>(sender());
-    if (!socket)
+    bool flushed = true;
+    clients.forEach([this, &flushed](ClientHandle, const ClientSlot &slot) {
+        if (bytesToWrite(slot) + slot.outbound.size() > 0)
+            flushed = false;
+    });
+    return flushed;
+}
+
+SocketHandoff::Bundle NetworkManager::detachForHandoff()
+{
+    SocketHandoff::Bundle bundle;
+    if (uring) {
+        // Réceptions annulées, écritures en file vidées ; ce qui arrive entre-temps reste dans inbound
+        handedOff = true;
+        if (!uring->detach(1000))
+            qWarning() << "io_uring handoff: operations still in flight";
+        bundle.listenerDescriptor = uring->listenerDescriptor();
+        clients.forEach([&bundle](ClientHandle handle, ClientSlot &slot) {
+            SocketHandoff::Connection connection;
+            connection.descriptor = slot.descriptor;
+            connection.clientId = handle.clientId();
+            connection.spectator = slot.spectator;
+            connection.compressed = slot.compressed;
+            connection.interned = slot.interned;
+            connection.strings = slot.strings.names();
+            connection.pendingInput = slot.inbound;
+            bundle.connections.append(connection);
+        });
+        return bundle;
+    }
+    if (!server)
+        return bundle;
+
+    // Les nouvelles connexions attendent dans la file du noyau, partagée avec le successeur
+    server->pauseAccepting();
+    bundle.listenerDescriptor = int(server->socketDescriptor());
+    handedOff = true;
+
+    clients.forEach([this, &bundle](ClientHandle handle, ClientSlot &slot) {
+        QTcpSocket *socket = slot.socket;
+        disconnect(socket, nullptr, this, nullptr);
+        // Sans attente : beginHandoff() a laissé la boucle vider les tampons d'écriture
+        socket->flush();
+        if (bytesToWrite(slot) + slot.outbound.size() > 0)
+            qWarning() << "Handoff: unsent output dropped for" << handle.clientId();
+        // Lu par Qt mais pas encore découpé en trames : transmis au successeur
+        slot.inbound.append(socket->readAll());
+
+        SocketHandoff::Connection connection;
+        connection.descriptor = int(socket->socketDescriptor());
+        connection.clientId = handle.clientId();
+        connection.spectator = slot.spectator;
+        connection.compressed = slot.compressed;
+        connection.interned = slot.interned;
+        connection.strings = slot.strings.names();
+        connection.pendingInput = slot.inbound;
+        bundle.connections.append(connection);
+    });
+    return bundle;
+}
+
+void NetworkManager::cancelHandoff()
+{
+    if (!server && !uring)
         return;
 
-    QByteArray data = socket->readAll();
+    handedOff = false;
+    QVector<ClientHandle> players;
+    clients.forEach([this, &players](ClientHandle handle, ClientSlot &slot) {
+        if (slot.socket) {
+            // Abandon avant detachForHandoff() : les signaux sont encore branchés
+            disconnect(slot.socket, nullptr, this, nullptr);
+            watchClient(handle);
+        }
+        if (!slot.spectator)
+            players.append(handle);
+    });
+    if (uring)
+        uring->resume();
+    else
+        server->resumeAccepting();
 
-    if (serverMode) {
-        QByteArray &buffer = buffers[socket];
-        buffer.append(data);
-        processBuffer(buffer, socket);
+    // Trames arrivées pendant la tentative
+    for (ClientHandle handle : std::as_const(players))
+        processClientInput(handle);
+}
+
+bool NetworkManager::adoptHandoff(const SocketHandoff::Bundle &bundle)
+{
+    // Le successeur reprend toujours sur QTcpServer, quel que soit le transport du prédécesseur
+    if (server || uring)
+        stopServer();
+
+    server = new QTcpServer(this);
+    connect(server, &QTcpServer::newConnection, this, &NetworkManager::onNewConnection);
+    if (!server->setSocketDescriptor(bundle.listenerDescriptor)) {
+        emit connectionError("Cannot adopt server socket: " + server->errorString());
+        server->deleteLater();
+        server = nullptr;
+        SocketHandoff::closeDescriptors(bundle);
+        return false;
+    }
+    serverMode = true;
+
+    QVector<ClientHandle> players;
+    for (const SocketHandoff::Connection &connection : bundle.connections) {
+        QTcpSocket *socket = new QTcpSocket(this);
+        if (!socket->setSocketDescriptor(connection.descriptor)) {
+            qDebug() << "Handed-off connection dropped:" << connection.clientId << socket->errorString();
+            delete socket;
+            continue;
+        }
+        // Déjà admises par le prédécesseur : comptées, sans limite d'acceptation.
+        // Nouvelle case, donc nouvel identifiant : les anciens ne servaient qu'au routage
+        const ClientHandle handle = trackClient(socket, socket->peerAddress().toString());
+        ClientSlot *slot = clients.find(handle);
+        if (connection.spectator)
+            becomeSpectator(*slot, false);
+        slot->compressed = connection.compressed;
+        slot->interned = connection.interned;
+        slot->strings.restore(connection.strings);
+        slot->inbound = connection.pendingInput;
+        watchClient(handle);
+        if (!connection.spectator)
+            players.append(handle);
+        qDebug() << "Adopted" << connection.clientId << "as" << handle.clientId();
+    }
+
+    // Trames en attente traitées une fois la partie restaurée par l'appelant
+    QMetaObject::invokeMethod(this, [this, players]() {
+        for (ClientHandle handle : players)
+            processClientInput(handle);
+    }, Qt::QueuedConnection);
+
+    emit serverStarted(server->serverPort());
+    return true;
+}
+
+void NetworkManager::removeClient(ClientHandle handle)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;     // poignée périmée : déjà retiré
+
+    const QString clientId = handle.clientId();
+    const bool wasSpectator = slot->spectator;
+    auto limits = addressLimits.find(slot->address);
+    if (limits != addressLimits.end()) {
+        if (wasSpectator)
+            --limits->spectators;
+        else
+            --limits->connections;
+    }
+    if (wasSpectator)
+        --spectatorTotal;
+
+    qDebug() << "Session" << clientId << slot->playerName
+             << "closed after" << (limitClock.elapsed() - slot->connectedAtMs) << "ms, in:"
+             << slot->framesIn << "frames" << slot->bytesIn << "bytes, out:"
+             << slot->framesOut << "frames" << slot->bytesOut << "bytes";
+
+    if (slot->socket)
+        slot->socket->deleteLater();
+    else
+        uring->close(slot->descriptor, UringTransport::GRACEFUL);
+    clients.remove(handle);
+    if (capture)
+        capture->record(TrafficCapture::CONNECTION_CLOSED, handle.key());
+
+    if (wasSpectator)
+        emit spectatorLeft(clientId);
+    else
+        emit clientDisconnected(clientId);
+}
+
+void NetworkManager::dropClient(ClientHandle handle, const char *reason)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;
+
+    qDebug() << "Dropping client" << handle.clientId() << slot->address << ":" << reason;
+    if (slot->socket) {
+        disconnect(slot->socket, nullptr, this, nullptr);
+        slot->socket->abort();
     } else {
-        clientBuffer.append(data);
-        processBuffer(clientBuffer, nullptr);
+        uring->close(slot->descriptor, UringTransport::ABORT);
     }
+    removeClient(handle);
+}
+
+void NetworkManager::onClientData(ClientHandle handle)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot || (slot->throttled && !handedOff))
+        return;     // en attente : le noyau freine l'émetteur une fois READ_BUFFER_SIZE atteint
+
+    const QByteArray data = slot->socket->readAll();
+    receiveFromClient(handle, data.constData(), data.size());
 }
 
-void NetworkManager::processBuffer(QByteArray &buffer, QTcpSocket *originSocket)
+void NetworkManager::receiveFromClient(ClientHandle handle, const char *data, qsizetype size)
 {
-    int idx;
-    while ((idx = buffer.indexOf(TERMINATOR)) != -1) {
-        QByteArray line = buffer.left(idx);
-        buffer.remove(0, idx + 1); // supprime y compris le terminator
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;
+
+    slot->bytesIn += quint64(size);
+    if (handedOff) {
+        // Reçu pendant le passage de relais : transmis tel quel au successeur
+        slot->inbound.append(data, size);
+        return;
+    }
+
+    if (slot->spectator) {
+        // un spectateur n'a rien à dire une fois inscrit : ignoré, mais pas à volonté
+        if (admitFrame(handle) == FRAME_REFUSED)
+            dropClient(handle, "spectator flood");
+        return;
+    }
+
+    slot->inbound.append(data, size);
+    if (slot->throttled) {
+        // io_uring : rien ne freine l'émetteur, l'attente est donc bornée
+        if (slot->inbound.size() > READ_BUFFER_SIZE)
+            dropClient(handle, "input backlog");
+        return;
+    }
+    processClientInput(handle);
+}
+
+void NetworkManager::processClientInput(ClientHandle handle)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;
+
+    // Tampon sorti de la case pendant le traitement : un message peut fermer
+    // la session ou déplacer la table
+    QByteArray buffer;
+    buffer.swap(slot->inbound);
+    const bool ok = processBuffer(buffer, handle);
+
+    slot = clients.find(handle);
+    if (!slot)
+        return;
+    if (!ok) {
+        dropClient(handle, "frame too large, invalid or too many messages");
+        return;
+    }
+    slot->inbound.swap(buffer);
+}
+
+void NetworkManager::onClientBytesWritten(ClientHandle handle)
+{
+    ClientSlot *slot = clients.find(handle);
+    if (!slot || slot->outbound.isEmpty() || bytesToWrite(*slot) > SPECTATOR_BACKLOG)
+        return;
+
+    QByteArray frame;
+    frame.swap(slot->outbound);
+    QByteArray compressed;
+    writeToSlot(*slot, frame, compressed, false);
+}
+
+void NetworkManager::onHostData()
+{
+    if (!clientSocket)
+        return;
+
+    // Même précaution que processClientInput() : un message peut couper la
+    // connexion (clientBuffer vidé) pendant que processBuffer() lit le tampon
+    QTcpSocket *socket = clientSocket;
+    QByteArray buffer;
+    buffer.swap(clientBuffer);
+    buffer.append(socket->readAll());
+    processBuffer(buffer, ClientHandle());
+    if (clientSocket == socket)
+        clientBuffer.swap(buffer);
+}
+
+bool NetworkManager::processBuffer(QByteArray &buffer, ClientHandle origin)
+{
+    // Trames venant d'un client (côté hôte) : taille bornée, débit limité
+    const bool fromClient = !origin.isNull();
+
+    // Trames lues sur place ; le tampon n'est décalé qu'une fois, à la fin
+    qsizetype offset = 0;
+    bool ok = true;
+    while (offset < buffer.size()) {
+        if (fromClient) {
+            // Devenu spectateur (ou fermé) par une trame précédente du même
+            // paquet : la suite n'atteint jamais la logique de jeu
+            const ClientSlot *slot = clients.find(origin);
+            if (!slot || slot->spectator) {
+                offset = buffer.size();
+                break;
+            }
+        }
+        const char *frame = buffer.constData() + offset;
+        const qsizetype available = buffer.size() - offset;
 
-        if (line.isEmpty())
+        if (*frame == FrameCodec::COMPRESSED_MARKER) {
+            // Trame compressée : marqueur + longueur + deflate
+            if (available < FrameCodec::HEADER_SIZE)
+                break;
+            const quint32 bodySize = qFromBigEndian<quint32>(frame + 1);
+            if (fromClient && bodySize > quint32(MAX_CLIENT_FRAME_SIZE)) {
+                ok = false;
+                break;
+            }
+            if (qsizetype(bodySize) > available - FrameCodec::HEADER_SIZE)
+                break;
+
+            if (fromClient) {
+                const FrameAdmission admission = admitFrame(origin);
+                if (admission == FRAME_DEFERRED) {
+                    throttle(origin);       // trame laissée en tête du tampon
+                    break;
+                }
+                if (admission == FRAME_REFUSED) {
+                    ok = false;
+                    break;
+                }
+            }
+            const QByteArray body(frame + FrameCodec::HEADER_SIZE, bodySize);
+            offset += FrameCodec::HEADER_SIZE + bodySize;
+
+            QByteArray payload;
+            if (!FrameCodec::decompress(body, &payload, fromClient ? MAX_CLIENT_FRAME_SIZE
+                                                                   : FrameCodec::MAX_DECOMPRESSED_SIZE)) {
+                qDebug() << "Compressed frame rejected";
+                if (fromClient) {
+                    ok = false;
+                    break;
+                }
+                continue;
+            }
+            dispatchFrame(payload, origin);
             continue;
+        }
+
+        const qsizetype idx = FrameReader::findTerminator(frame, available);
+        if (idx == -1) {
+            ok = !fromClient || available <= MAX_CLIENT_FRAME_SIZE;
+            break;
+        }
+        if (fromClient && idx > MAX_CLIENT_FRAME_SIZE) {
+            ok = false;
+            break;
+        }
+        if (idx == 0) {
+            ++offset;
+            continue;
+        }
+        if (fromClient) {
+            const FrameAdmission admission = admitFrame(origin);
+            if (admission == FRAME_DEFERRED) {
+                throttle(origin);
+                break;
+            }
+            if (admission == FRAME_REFUSED) {
+                ok = false;
+                break;
+            }
+        }
+        offset += idx + 1; // y compris le terminator
+
+        dispatchFrame(QByteArrayView(frame, idx), origin);
+    }
+    buffer.remove(0, offset);
+    return ok;
+}
+
+void NetworkManager::dispatchFrame(QByteArrayView payload, ClientHandle origin)
+{
+    // Trame compacte (WireStrings) : seulement d'un client qui l'a négociée
+    ClientSlot *slot = serverMode ? clients.find(origin) : nullptr;
+    const bool compact = slot && slot->interned && payload.startsWith('[');
+
+    // Les captures gardent le JSON complet (enregistré après décodage) : QuizzReplay les relit telles quelles
+    if (capture && !compact) {
+        capture->record(TrafficCapture::FRAME_IN, origin.isNull() ? TrafficCapture::HOST_CONNECTION : origin.key(),
+                        payload.data(), int(payload.size()));
+    }
+    if (serverMode && !slot)
+        return;
 
+    // Réponses des joueurs : champs lus directement dans la trame, sans
+    // QJsonObject ; tout le reste (et tout cas douteux, spectateurs compris)
+    // passe par QJsonDocument puis handleClientMessage()
+    if (serverMode && !slot->spectator && !(compact && capture)) {
+        FrameReader::Fields fields;
+        if (FrameReader::read(payload, &fields) && fields.hasAnswer) {
+            if (!compact && fields.type == QByteArrayView("answer") && fields.hasPlayerName) {
+                emit answerReceived(QString::fromUtf8(fields.playerName), fields.answer, origin.clientId());
+                return;
+            }
+            // Noms déjà définis : aucune chaîne à construire
+            const QString *name = compact ? slot->strings.name(fields.playerNameId) : nullptr;
+            if (name && fields.typeId == WireStrings::ANSWER && !fields.definesName
+                && slot->strings.name(fields.senderId)) {
+                const QString playerName = *name;   // copie partagée : la case peut changer pendant l'émission
+                emit answerReceived(playerName, fields.answer, origin.clientId());
+                return;
+            }
+        }
+    }
+
+    QJsonObject obj;
+    if (compact) {
+        if (!slot->strings.decode(payload.toByteArray(), &obj)) {
+            qDebug() << "Invalid compact frame";
+            return;
+        }
+        if (capture) {
+            const QByteArray json = QJsonDocument(obj).toJson(QJsonDocument::Compact);
+            capture->record(TrafficCapture::FRAME_IN, origin.key(), json.constData(), int(json.size()));
+        }
+    } else {
         QJsonParseError err;
-        QJsonDocument doc = QJsonDocument::fromJson(line, &err);
+        QJsonDocument doc = QJsonDocument::fromJson(payload.toByteArray(), &err);
         if (err.error != QJsonParseError::NoError) {
             qDebug() << "JSON parse error:" << err.errorString();
-            continue;
+            return;
         }
+        obj = doc.object();
+    }
 
-        QJsonObject obj = doc.object();
+    if (serverMode) {
+        if (handleClientMessage(origin, obj))
+            return;
+        emit messageReceived(obj, origin.clientId());
+    } else {
+        if (obj["type"].toString() == "hello_ack") {
+            // Trames compactes vers l'hôte à partir d'ici, dictionnaire vierge
+            hostInterned = quint32(obj["data"].toObject()["strings"].toDouble()) == WireStrings::tableId();
+            hostStrings = WireStrings();
+            return;
+        }
+        emit messageReceived(obj, "server");
+    }
+}
 
-        if (serverMode) {
-            QString clientId = connectedClients.value(originSocket);
-            handleClientMessage(originSocket, obj);
-            emit messageReceived(obj, clientId);
-        } else {
-            emit messageReceived(obj, "server");
+bool NetworkManager::handleClientMessage(ClientHandle handle, const QJsonObject &message)
+{
+    // Ici, l’hôte peut filtrer ou valider les messages entrants si nécessaire.
+    // Retourne true si le message est consommé par la couche réseau.
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return true;
+    const QString type = message["type"].toString();
+
+    if (type == "hello") {
+        // Négociation de la compression : même codec et même dictionnaire
+        const QJsonObject data = message["data"].toObject();
+        const bool accepted = data["compression"].toString() == FrameCodec::codecName()
+                           && quint32(data["dictId"].toDouble()) == FrameCodec::dictionaryId();
+        slot->compressed = accepted;
+        // Dictionnaire de chaînes : même table des deux côtés
+        slot->interned = quint32(data["strings"].toDouble()) == WireStrings::tableId();
+        slot->strings = WireStrings();
+
+        QJsonObject ackData;
+        ackData["compression"] = accepted ? QString(FrameCodec::codecName()) : QString("none");
+        if (slot->interned)
+            ackData["strings"] = double(WireStrings::tableId());
+        QJsonObject ack;
+        ack["type"] = "hello_ack";
+        ack["data"] = ackData;
+        sendToSlot(handle, ack);
+        return true;
+    }
+
+    // Un spectateur ne fait que regarder : rien d'autre n'atteint la partie
+    if (slot->spectator)
+        return true;
+
+    if (type == "spectate") {
+        // Un joueur inscrit resterait dans la partie sans plus rien recevoir :
+        // chaque question attendrait sa réponse jusqu'au bout du chrono
+        if (!slot->playerName.isEmpty()) {
+            qDebug() << "Spectate refused for player" << slot->playerName << handle.clientId();
+            return true;
+        }
+        if (!becomeSpectator(*slot, true)) {
+            dropClient(handle, "spectator limit");
+            return true;
         }
+        if (!lastSpectatorFrame.isEmpty())
+            writeToSlot(*slot, lastSpectatorFrame, lastSpectatorCompressed, false);
+        emit spectatorJoined(handle.clientId());
+        return true;
     }
+
+    // Le joueur de la session, pour les journaux ; le message suit son cours
+    if (type == "join_game" || type == "rejoin_game")
+        slot->playerName = message["data"].toObject()["playerName"].toString();
+    return false;
 }
 
-void NetworkManager::handleClientMessage(QTcpSocket *socket, const QJsonObject &message)
+void NetworkManager::sendToClient(QTcpSocket *socket, const QJsonObject &message)
 {
-    Q_UNUSED(socket)
-    Q_UNUSED(message)
-    // Ici, l’hôte peut filtrer ou valider les messages entrants si nécessaire
+    if (!socket || socket->state() != QTcpSocket::ConnectedState)
+        return;
+
+    // Après hello_ack, trame compacte si le message s'y prête
+    QByteArray payload = hostInterned ? hostStrings.encode(message) : QByteArray();
+    if (payload.isEmpty())
+        payload = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    payload.append(TERMINATOR);
+    captureFrame(capture, TrafficCapture::FRAME_OUT, TrafficCapture::HOST_CONNECTION, payload);
+
+    QByteArray compressed;
+    writeFrame(socket, false, payload, compressed, true);
 }
 
-QString NetworkManager::generateClientId()
+void NetworkManager::sendToSlot(ClientHandle handle, const QJsonObject &message)
 {
-    return QString("client_%1").arg(QRandomGenerator::global()->bounded(1000, 9999));
+    ClientSlot *slot = clients.find(handle);
+    if (!slot)
+        return;
+
+    QByteArray payload = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    payload.append(TERMINATOR);
+    captureFrame(capture, TrafficCapture::FRAME_OUT, handle.key(), payload);
+
+    QByteArray compressed;
+    writeToSlot(*slot, payload, compressed, true);
 }
 
-void NetworkManager::sendToClient(QTcpSocket *socket, const QJsonObject &message)
+static const QByteArray &encodedFrame(bool compress, const QByteArray &plain, QByteArray &compressedCache)
+{
+    if (compress && plain.size() > FrameCodec::COMPRESSION_THRESHOLD) {
+        // Compressé au premier destinataire qui l'accepte, réutilisé pour les suivants
+        if (compressedCache.isEmpty())
+            compressedCache = FrameCodec::compressFrame(plain.left(plain.size() - 1));
+        if (!compressedCache.isEmpty() && compressedCache.size() < plain.size())
+            return compressedCache;
+    }
+    return plain;
+}
+
+qint64 NetworkManager::writeFrame(QTcpSocket *socket, bool compress, const QByteArray &plain,
+                                  QByteArray &compressedCache, bool flush)
 {
     if (!socket || socket->state() != QTcpSocket::ConnectedState)
+        return 0;
+
+    const qint64 written = socket->write(encodedFrame(compress, plain, compressedCache));
+    if (flush)
+        socket->flush();
+    return written;
+}
+
+void NetworkManager::writeToSlot(ClientSlot &slot, const QByteArray &plain, QByteArray &compressedCache, bool flush)
+{
+    if (!slot.socket) {
+        // io_uring : mise en file, envoyée avec les autres en fin de tour de boucle
+        const QByteArray &frame = encodedFrame(slot.compressed, plain, compressedCache);
+        if (uring->send(slot.descriptor, frame)) {
+            ++slot.framesOut;
+            slot.bytesOut += quint64(frame.size());
+        }
         return;
+    }
 
-    QJsonDocument doc(message);
-    QByteArray payload = doc.toJson(QJsonDocument::Compact);
-    payload.append(TERMINATOR);
+    // La socket est relue après l'écriture : un flush peut fermer la session
+    QTcpSocket *socket = slot.socket;
+    const qint64 written = writeFrame(socket, slot.compressed, plain, compressedCache, flush);
+    if (written > 0 && slot.socket == socket) {
+        ++slot.framesOut;
+        slot.bytesOut += quint64(written);
+    }
+}
+
+qint64 NetworkManager::bytesToWrite(const ClientSlot &slot) const
+{
+    return slot.socket ? slot.socket->bytesToWrite() : uring->bytesToWrite(slot.descriptor);
+}
+
+void NetworkManager::sendHello()
+{
+    QJsonObject data;
+    data["compression"] = FrameCodec::codecName();
+    data["dictId"] = double(FrameCodec::dictionaryId());
+    data["strings"] = double(WireStrings::tableId());
 
-    socket->write(payload);
-    socket->flush();
+    QJsonObject hello;
+    hello["type"] = "hello";
+    hello["data"] = data;
+    sendToClient(clientSocket, hello);
 }
@@ -11,7 +11,14 @@
 #include <QTcpSocket>
 #include <QJsonObject>
 #include <QJsonDocument>
-#include <QMap>
+#include <QHash>
+#include <QElapsedTimer>
+#include "clienttable.h"
+#include "sockethandoff.h"
+#include "trafficcapture.h"
+
+class QTimer;
+class UringTransport;
 
 class NetworkManager : public QObject
 {
@@ -22,6 +29,7 @@ public:
 
     // --- Host side ---
     bool startServer(quint16 port = 12345);   // démarre l’hôte (12345 par défaut)
+    bool tryStartServer(quint16 port);        // idem sans connectionError (port encore tenu)
     void stopServer();
     quint16 getServerPort() const;
 
@@ -31,44 +39,110 @@ public:
 
     // --- Messaging ---
     void sendMessage(const QJsonObject &message);   // automatique (broadcast côté hôte)
-    void broadcastMessage(const QJsonObject &message);
+    void sendMessageTo(const QString &clientId, const QJsonObject &message);
+    void broadcastMessage(const QJsonObject &message);          // joueurs uniquement
+    void broadcastToSpectators(const QByteArray &frame);         // trame déjà encodée, partagée
+    // Trame déjà encodée, sans flush ; compressedCache la garde compressée pour les envois suivants
+    void sendFrameTo(const QString &clientId, const QByteArray &frame, QByteArray &compressedCache);
+    qint64 bytesPending(const QString &clientId) const;         // en attente d'écriture, -1 si inconnu
+
+    // --- Handoff (mise à jour sans coupure) ---
+    void beginHandoff();                            // plus d'accept, lectures gardées pour le successeur
+    bool outputFlushed() const;                     // tout est parti vers les clients
+    SocketHandoff::Bundle detachForHandoff();       // plus aucune lecture, sans attendre les écritures
+    void cancelHandoff();
+    bool adoptHandoff(const SocketHandoff::Bundle &bundle);
 
     // --- State helpers ---
     bool isServer() const;
     bool isConnected() const;
     QStringList getConnectedClients() const;
+    int spectatorCount() const;
 
 signals:
     void serverStarted(quint16 port);
     void serverStopped();
     void clientConnected(const QString &clientId);
     void clientDisconnected(const QString &clientId);
+    void spectatorJoined(const QString &clientId);
+    void spectatorLeft(const QString &clientId);
     void connectedToHost();
     void disconnectedFromHost();
     void messageReceived(const QJsonObject &message, const QString &senderId);
+    void answerReceived(const QString &playerName, int answer, const QString &senderId);    // "answer" d'un client, sans QJsonObject
     void connectionError(const QString &error);
 
 private slots:
     void onNewConnection();
-    void onClientDisconnected();
-    void onDataReceived();
 
 private:
     // Core sockets
     QTcpServer *server;
+    UringTransport *uring;                  // à la place de server avec QUIZZ_IO_URING=1 (Linux)
     QTcpSocket *clientSocket;
-    QMap<QTcpSocket *, QString> connectedClients;
+    ClientTable clients;                    // sessions côté hôte, indexées par ClientHandle
+    QByteArray lastSpectatorFrame;          // renvoyée telle quelle aux nouveaux spectateurs
+    QByteArray lastSpectatorCompressed;
     bool serverMode;
+    bool handedOff;                         // sockets passées au successeur : ne rien fermer proprement
+    bool hostInterned;                      // client : l'hôte a accepté WireStrings (hello_ack)
+    WireStrings hostStrings;                // client : noms déjà envoyés à l'hôte
+    TrafficCapture *capture;                // null hors QUIZZ_CAPTURE
+
+    // --- Contrôle d'admission (côté hôte) ---
+    struct AddressLimits {
+        int connections = 0;        // joueurs et connexions pas encore identifiées
+        int spectators = 0;
+        TokenBucket accepts;
+        TokenBucket messages;       // toutes les connexions de l'adresse
+    };
+    enum FrameAdmission { FRAME_ACCEPTED, FRAME_DEFERRED, FRAME_REFUSED };
+    QElapsedTimer limitClock;
+    TokenBucket acceptBucket;               // débit d'acceptation global
+    QTimer *acceptResumeTimer;
+    QTimer *throttleTimer;                  // reprise des sessions en attente du seau de leur adresse
+    QHash<QString, AddressLimits> addressLimits;
+    int spectatorTotal;
+    int maxConnections;                     // hors spectateurs
+    int maxConnectionsPerAddress;
+    int maxSpectators;
+    int maxSpectatorsPerAddress;
+    double addressAcceptRate;
+    double addressAcceptBurst;
+    double addressMessageRate;              // pour une connexion ; augmente avec celles de l'adresse
+    double addressMessageBurst;
 
     // --- Message framing helpers ---
-    QMap<QTcpSocket *, QByteArray> buffers; // accumulate data per‑client (server mode)
     QByteArray clientBuffer;               // accumulate data when we are the client
 
     // Internal helpers
-    void handleClientMessage(QTcpSocket *socket, const QJsonObject &message);
-    QString generateClientId();
+    bool listen(quint16 port, QString *error);
+    bool listenUring(quint16 port, QString *error);
+    void onUringConnection();
+    void watchClient(ClientHandle handle);
+    bool admitClient(const QString &address, qint64 nowMs);
+    ClientHandle trackClient(QTcpSocket *socket, const QString &address);
+    ClientHandle trackSlot(ClientHandle handle, const QString &address);
+    bool becomeSpectator(ClientSlot &slot, bool enforce);   // false : budget des spectateurs épuisé
+    FrameAdmission admitFrame(ClientHandle handle);
+    void throttle(ClientHandle handle);
+    void resumeThrottled();
+    void removeClient(ClientHandle handle);
+    void dropClient(ClientHandle handle, const char *reason);
+    void onClientData(ClientHandle handle);
+    void receiveFromClient(ClientHandle handle, const char *data, qsizetype size);
+    qint64 bytesToWrite(const ClientSlot &slot) const;
+    void onClientBytesWritten(ClientHandle handle);
+    void processClientInput(ClientHandle handle);
+    void onHostData();
+    bool handleClientMessage(ClientHandle handle, const QJsonObject &message);
     void sendToClient(QTcpSocket *socket, const QJsonObject &message);
-    void processBuffer(QByteArray &buffer, QTcpSocket *originSocket);
+    void sendToSlot(ClientHandle handle, const QJsonObject &message);
+    qint64 writeFrame(QTcpSocket *socket, bool compress, const QByteArray &plain, QByteArray &compressedCache, bool flush);
+    void writeToSlot(ClientSlot &slot, const QByteArray &plain, QByteArray &compressedCache, bool flush);
+    void sendHello();
+    bool processBuffer(QByteArray &buffer, ClientHandle origin);   // false : client à éjecter
+    void dispatchFrame(QByteArrayView payload, ClientHandle origin);
 };
 
 #endif // NETWORKMANAGER_H
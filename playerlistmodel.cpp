@@ -0,0 +1,104 @@
+#include "playerlistmodel.h"
+#include <QSet>
+
+PlayerListModel::PlayerListModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+int PlayerListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : players.size();
+}
+
+QVariant PlayerListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= players.size())
+        return QVariant();
+
+    if (role == Qt::DisplayRole)
+        return players.at(index.row());
+
+    return QVariant();
+}
+
+void PlayerListModel::addPlayer(const QString &playerName)
+{
+    if (rowOf.contains(playerName))
+        return;
+
+    const int row = players.size();
+    beginInsertRows(QModelIndex(), row, row);
+    players.append(playerName);
+    rowOf.insert(playerName, row);
+    endInsertRows();
+}
+
+void PlayerListModel::addPlayers(const QStringList &playerNames)
+{
+    QStringList fresh;
+    QSet<QString> seen;
+    fresh.reserve(playerNames.size());
+    for (const QString &name : playerNames) {
+        if (!rowOf.contains(name) && !seen.contains(name)) {
+            seen.insert(name);
+            fresh.append(name);
+        }
+    }
+    if (fresh.isEmpty())
+        return;
+
+    // Un seul bloc d'insertion pour toute une rafale de connexions
+    const int first = players.size();
+    beginInsertRows(QModelIndex(), first, first + fresh.size() - 1);
+    for (const QString &name : fresh) {
+        rowOf.insert(name, players.size());
+        players.append(name);
+    }
+    endInsertRows();
+}
+
+void PlayerListModel::removePlayer(const QString &playerName)
+{
+    auto it = rowOf.find(playerName);
+    if (it == rowOf.end())
+        return;
+
+    const int row = it.value();
+    beginRemoveRows(QModelIndex(), row, row);
+    players.removeAt(row);
+    rowOf.erase(it);
+    for (int i = row; i < players.size(); ++i)
+        rowOf[players.at(i)] = i;
+    endRemoveRows();
+}
+
+void PlayerListModel::setPlayers(const QStringList &playerNames)
+{
+    beginResetModel();
+    players.clear();
+    rowOf.clear();
+    for (const QString &name : playerNames) {
+        if (rowOf.contains(name))
+            continue;
+        rowOf.insert(name, players.size());
+        players.append(name);
+    }
+    endResetModel();
+}
+
+void PlayerListModel::clear()
+{
+    if (players.isEmpty())
+        return;
+
+    beginResetModel();
+    players.clear();
+    rowOf.clear();
+    endResetModel();
+}
+
+bool PlayerListModel::contains(const QString &playerName) const
+{
+    return rowOf.contains(playerName);
+}
@@ -0,0 +1,33 @@
+#ifndef PLAYERLISTMODEL_H
+#define PLAYERLISTMODEL_H
+
+#include <QAbstractListModel>
+#include <QStringList>
+#include <QHash>
+
+// Lobby roster. Rows are kept in join order and every change is reported
+// as a row insert/remove so the view never rebuilds the whole list.
+class PlayerListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit PlayerListModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    void addPlayer(const QString &playerName);
+    void addPlayers(const QStringList &playerNames);
+    void removePlayer(const QString &playerName);
+    void setPlayers(const QStringList &playerNames);
+    void clear();
+
+    bool contains(const QString &playerName) const;
+
+private:
+    QStringList players;
+    QHash<QString, int> rowOf;   // nom -> ligne, pour des retraits en O(1) + décalage
+};
+
+#endif // PLAYERLISTMODEL_H
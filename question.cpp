@@ -1,5 +1,7 @@
 // question.cpp - Corrections
 #include "question.h"
+#include <QCryptographicHash>
+#include <QtEndian>
 
 Question::Question() 
     : correctAnswerIndex(0)
@@ -41,7 +43,24 @@ void Question::setCorrectAnswerIndex(int index)
     correctAnswerIndex = index;
 }
 
+const Question::Media &Question::getMedia() const
+{
+    return media;
+}
+
+void Question::setMedia(const Media &value)
+{
+    media = value;
+}
+
 bool Question::isCorrect(int answerIndex) const
 {
     return answerIndex == correctAnswerIndex;
-}
\ No newline at end of file
+}
+
+quint64 Question::getId() const
+{
+    // 64 bits : aucune collision attendue même sur une banque de millions de questions
+    const QByteArray digest = QCryptographicHash::hash(questionText.toUtf8(), QCryptographicHash::Sha256);
+    return qFromBigEndian<quint64>(digest.constData());
+}
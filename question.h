@@ -1,15 +1,31 @@
 #ifndef QUESTION_H
 #define QUESTION_H
 
+#include <QByteArray>
 #include <QString>
 #include <QStringList>
 
 class Question
 {
+public:
+    // Image ou son joint à la question, désigné par son contenu (SHA-256) :
+    // seule l'empreinte voyage avec la question, les octets suivent à part
+    struct Media
+    {
+        enum Kind { NONE, IMAGE, AUDIO };
+
+        Kind kind = NONE;
+        QByteArray hash;            // SHA-256 brut (32 octets)
+        qint64 size = 0;
+
+        bool isNull() const { return kind == NONE; }
+    };
+
 private:
     QString questionText;
     QStringList answers;  // Utiliser QStringList partout
     int correctAnswerIndex;
+    Media media;
 
 public:
     Question();
@@ -22,8 +38,11 @@ public:
     void setQuestionText(const QString& text);
     void setAnswers(const QStringList& answerList);
     void setCorrectAnswerIndex(int index);
+    const Media &getMedia() const;
+    void setMedia(const Media &value);
     
     bool isCorrect(int answerIndex) const;
+    quint64 getId() const;   // empreinte stable du texte (SHA-256 tronqué), pour le journal et les stats
 };
 
 #endif // QUESTION_H
\ No newline at end of file
@@ -0,0 +1,520 @@
+#include "questionbank.h"
+#include "game.h"
+#include <QCryptographicHash>
+#include <QDir>
+#include <QFile>
+#include <QFileInfo>
+#include <QDataStream>
+#include <QSaveFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <iterator>
+
+static const int ANSWER_COUNT = 4;
+
+static bool setError(QString *error, const QString &message)
+{
+    if (error)
+        *error = message;
+    return false;
+}
+
+// Média d'une question de banque : type d'après l'extension, empreinte du contenu
+static bool loadMedia(const QString &path, Question::Media *media, QString *error)
+{
+    static const QStringList images = {"png", "jpg", "jpeg", "gif", "webp"};
+    static const QStringList sounds = {"mp3", "ogg", "oga", "opus", "wav", "m4a"};
+    const QString suffix = QFileInfo(path).suffix().toLower();
+    if (images.contains(suffix))
+        media->kind = Question::Media::IMAGE;
+    else if (sounds.contains(suffix))
+        media->kind = Question::Media::AUDIO;
+    else
+        return setError(error, QString("%1 : type de média non pris en charge").arg(path));
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(error, QString("%1 : %2").arg(path, file.errorString()));
+    if (file.size() == 0 || file.size() > QuestionBank::MAX_MEDIA_SIZE)
+        return setError(error, QString("%1 : média vide ou de plus de %2 Mo").arg(path).arg(QuestionBank::MAX_MEDIA_SIZE >> 20));
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    if (!hash.addData(&file))
+        return setError(error, QString("%1 : lecture impossible").arg(path));
+    media->hash = hash.result();
+    media->size = file.size();
+    return true;
+}
+
+QuestionBank::QuestionBank()
+    : indexedCount(0), sortedTermsStale(false)
+{
+}
+
+const QuestionBank &QuestionBank::builtin()
+{
+    static const QuestionBank bank = []() {
+        QuestionBank b;
+        b.addBuiltinPacks();
+        b.buildIndex();
+        return b;
+    }();
+    return bank;
+}
+
+const QStringList &QuestionBank::builtinThemes()
+{
+    static const QStringList names = {"science", "sport", "culture"};
+    return names;
+}
+
+void QuestionBank::addBuiltinPacks()
+{
+    const QStringList &names = builtinThemes();
+    for (int theme = 0; theme < names.size(); ++theme) {
+        for (const Question &question : Game::getQuestionsForTheme(static_cast<Game::Theme>(theme)))
+            add(question, names.at(theme));
+    }
+}
+
+bool QuestionBank::loadFile(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(error, QString("%1 : %2").arg(path, file.errorString()));
+
+    const QFileInfo info(path);
+    const QString defaultTheme = info.completeBaseName();
+    const QString suffix = info.suffix().toLower();
+    QVector<Entry> loaded;
+
+    if (suffix == "qzb") {
+        file.close();
+        return loadBinary(path, error);
+    }
+
+    auto validate = [&](const QString &where, const Entry &entry) {
+        if (entry.question.getQuestionText().trimmed().isEmpty())
+            return setError(error, where + " : question vide");
+        if (entry.question.getAnswers().size() != ANSWER_COUNT)
+            return setError(error, where + " : 4 réponses attendues");
+        const int correct = entry.question.getCorrectAnswerIndex();
+        if (correct < 0 || correct >= ANSWER_COUNT)
+            return setError(error, where + " : indice de bonne réponse invalide");
+        return true;
+    };
+
+    if (suffix == "json") {
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (!document.isArray())
+            return setError(error, QString("%1 : %2").arg(path, parseError.errorString()));
+
+        const QJsonArray array = document.array();
+        loaded.reserve(array.size());
+        for (int i = 0; i < array.size(); ++i) {
+            const QJsonObject object = array.at(i).toObject();
+            QStringList answers;
+            for (const QJsonValue &answer : object["answers"].toArray())
+                answers.append(answer.toString());
+
+            Entry entry;
+            entry.question = Question(object["question"].toString(), answers, object["correct"].toInt(-1));
+            entry.theme = object["theme"].toString(defaultTheme);
+            entry.difficulty = object["difficulty"].toInt(-1);
+            if (!validate(QString("%1 : entrée %2").arg(path).arg(i + 1), entry))
+                return false;
+            if (object.contains("media")) {
+                Question::Media media;
+                entry.mediaFile = QDir::cleanPath(info.absoluteDir().filePath(object["media"].toString()));
+                if (!loadMedia(entry.mediaFile, &media, error))
+                    return false;
+                entry.question.setMedia(media);
+            }
+            loaded.append(entry);
+        }
+    } else if (suffix == "csv") {
+        QTextStream in(&file);
+        bool header = true;
+        int lineNumber = 0;
+        while (!in.atEnd()) {
+            const QString line = in.readLine();
+            ++lineNumber;
+            if (line.trimmed().isEmpty() || line.startsWith('#'))
+                continue;
+            if (header) {
+                header = false;
+                continue;
+            }
+
+            const QStringList fields = line.split(';');
+            const QString where = QString("%1 : ligne %2").arg(path).arg(lineNumber);
+            if (fields.size() < 6 || fields.size() > 8)
+                return setError(error, where + " : 6 à 8 champs attendus");
+
+            bool ok = false;
+            const int correct = fields.at(5).trimmed().toInt(&ok);
+            Entry entry;
+            entry.question = Question(fields.at(0).trimmed(),
+                                      {fields.at(1).trimmed(), fields.at(2).trimmed(),
+                                       fields.at(3).trimmed(), fields.at(4).trimmed()},
+                                      ok ? correct : -1);
+            entry.theme = fields.size() > 6 && !fields.at(6).trimmed().isEmpty() ? fields.at(6).trimmed() : defaultTheme;
+            entry.difficulty = fields.size() > 7 ? fields.at(7).trimmed().toInt(&ok) : -1;
+            if (!ok)
+                entry.difficulty = -1;
+            if (!validate(where, entry))
+                return false;
+            loaded.append(entry);
+        }
+    } else {
+        return setError(error, path + " : format non pris en charge (.json ou .csv)");
+    }
+
+    // Tout ou rien : la banque n'est modifiée que si le fichier est valide
+    entries.reserve(entries.size() + loaded.size());
+    for (const Entry &entry : loaded)
+        entries.append(entry);
+    buildIndex();
+    return true;
+}
+
+bool QuestionBank::loadDifficulties(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(error, QString("%1 : %2").arg(path, file.errorString()));
+
+    const QJsonDocument document = QJsonDocument::fromJson(file.readAll());
+    if (!document.isObject())
+        return setError(error, path + " : objet JSON attendu");
+
+    const QJsonObject scores = document.object();
+    for (Entry &entry : entries) {
+        const QJsonValue score = scores.value(QString::number(entry.question.getId()));
+        if (score.isDouble())
+            entry.difficulty = score.toInt();
+    }
+    return true;
+}
+
+static const char BANK_MAGIC[4] = {'Q', 'Z', 'B', '1'};
+static const quint32 BANK_VERSION = 2;     // 2 : médias
+
+static QDataStream &operator<<(QDataStream &out, const QuestionBank::Entry &entry)
+{
+    const Question::Media &media = entry.question.getMedia();
+    return out << entry.question.getQuestionText() << entry.question.getAnswers()
+               << qint8(entry.question.getCorrectAnswerIndex()) << entry.theme << qint8(entry.difficulty)
+               << qint8(media.kind) << media.hash << media.size << entry.mediaFile;
+}
+
+static void readEntry(QDataStream &in, QuestionBank::Entry &entry, quint32 version)
+{
+    QString text;
+    QStringList answers;
+    qint8 correct = 0;
+    qint8 difficulty = -1;
+    in >> text >> answers >> correct >> entry.theme >> difficulty;
+    entry.question = Question(text, answers, correct);
+    entry.difficulty = difficulty;
+
+    if (version >= 2) {
+        qint8 kind = 0;
+        Question::Media media;
+        in >> kind >> media.hash >> media.size >> entry.mediaFile;
+        if (kind > Question::Media::NONE && kind <= Question::Media::AUDIO) {
+            media.kind = static_cast<Question::Media::Kind>(kind);
+            entry.question.setMedia(media);
+        }
+    }
+}
+
+bool QuestionBank::save(const QString &path, QString *error) const
+{
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+        return setError(error, QString("%1 : %2").arg(path, file.errorString()));
+
+    file.write(BANK_MAGIC, sizeof(BANK_MAGIC));
+    QDataStream out(&file);
+    out.setVersion(QDataStream::Qt_6_0);
+    out << BANK_VERSION << entries << index << themeIndex;
+
+    if (out.status() != QDataStream::Ok || !file.commit())
+        return setError(error, QString("%1 : écriture impossible").arg(path));
+    return true;
+}
+
+bool QuestionBank::loadBinary(const QString &path, QString *error)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+        return setError(error, QString("%1 : %2").arg(path, file.errorString()));
+    if (file.read(sizeof(BANK_MAGIC)) != QByteArray(BANK_MAGIC, sizeof(BANK_MAGIC)))
+        return setError(error, path + " : ce n'est pas une banque QuizzGame");
+
+    QDataStream in(&file);
+    in.setVersion(QDataStream::Qt_6_0);
+    quint32 version = 0;
+    in >> version;
+    if (version < 1 || version > BANK_VERSION)
+        return setError(error, QString("%1 : version %2 non prise en charge").arg(path).arg(version));
+
+    // Même disposition que QVector<Entry>, entrées lues selon la version
+    quint32 count = 0;
+    in >> count;
+    QVector<Entry> loadedEntries;
+    for (quint32 i = 0; i < count && in.status() == QDataStream::Ok; ++i) {
+        Entry entry;
+        readEntry(in, entry, version);
+        loadedEntries.append(entry);
+    }
+    QHash<QString, Postings> loadedIndex;
+    QHash<QString, Postings> loadedThemes;
+    in >> loadedIndex >> loadedThemes;
+    if (in.status() != QDataStream::Ok)
+        return setError(error, path + " : fichier tronqué ou corrompu");
+
+    // Index repris sans retokeniser : les ids du fichier sont décalés après
+    // ceux déjà chargés (paquets intégrés, autres fichiers), les listes
+    // restent croissantes. Seul le vocabulaire trié est recalculé.
+    indexPending();
+    const int offset = entries.size();
+    entries += loadedEntries;
+    const auto merge = [offset](QHash<QString, Postings> &target, const QHash<QString, Postings> &loaded) {
+        for (auto it = loaded.cbegin(); it != loaded.cend(); ++it) {
+            Postings &postings = target[it.key()];
+            if (offset == 0 && postings.isEmpty()) {
+                postings = it.value();
+                continue;
+            }
+            postings.reserve(postings.size() + it.value().size());
+            for (int id : it.value())
+                postings.append(id + offset);
+        }
+    };
+    merge(index, loadedIndex);
+    merge(themeIndex, loadedThemes);
+    for (int id = offset; id < entries.size(); ++id) {
+        if (!entries.at(id).mediaFile.isEmpty())
+            mediaIndex.insert(entries.at(id).question.getMedia().hash, id);
+    }
+    indexedCount = entries.size();
+    sortedTermsStale = true;
+    buildIndex();
+    return true;
+}
+
+int QuestionBank::addTokenized(const Entry &entry, const QStringList &terms)
+{
+    indexPending();   // les ids déjà ajoutés doivent être indexés avant
+    entries.append(entry);
+    indexEntry(entries.size() - 1, terms);
+    indexedCount = entries.size();
+    return entries.size() - 1;
+}
+
+int QuestionBank::add(const Question &question, const QString &theme, int difficulty)
+{
+    Entry entry;
+    entry.question = question;
+    entry.theme = theme;
+    entry.difficulty = difficulty;
+    entries.append(entry);
+    return entries.size() - 1;
+}
+
+void QuestionBank::buildIndex()
+{
+    indexPending();
+    if (!sortedTermsStale)
+        return;
+
+    sortedTerms = index.keys();
+    std::sort(sortedTerms.begin(), sortedTerms.end());
+    sortedTermsStale = false;
+}
+
+void QuestionBank::indexPending()
+{
+    // Les ids croissent avec l'ajout : les listes restent triées sans tri
+    for (int id = indexedCount; id < entries.size(); ++id)
+        indexEntry(id, entryTerms(entries.at(id).question));
+    indexedCount = entries.size();
+}
+
+QStringList QuestionBank::entryTerms(const Question &question)
+{
+    QStringList terms = tokenize(question.getQuestionText());
+    for (const QString &answer : question.getAnswers())
+        terms += tokenize(answer);
+
+    // Un id au plus une fois par terme
+    std::sort(terms.begin(), terms.end());
+    terms.erase(std::unique(terms.begin(), terms.end()), terms.end());
+    return terms;
+}
+
+void QuestionBank::indexEntry(int id, const QStringList &terms)
+{
+    for (const QString &term : terms)
+        index[term].append(id);
+    sortedTermsStale = true;
+
+    themeIndex[normalize(entries.at(id).theme)].append(id);
+    if (!entries.at(id).mediaFile.isEmpty())
+        mediaIndex.insert(entries.at(id).question.getMedia().hash, id);
+}
+
+int QuestionBank::size() const
+{
+    return entries.size();
+}
+
+const QuestionBank::Entry &QuestionBank::entry(int id) const
+{
+    return entries.at(id);
+}
+
+QStringList QuestionBank::themes() const
+{
+    QStringList names;
+    for (const Entry &e : entries) {
+        if (!names.contains(e.theme))
+            names.append(e.theme);
+    }
+    return names;
+}
+
+QString QuestionBank::mediaFile(const QByteArray &hash) const
+{
+    const auto it = mediaIndex.constFind(hash);
+    return it != mediaIndex.constEnd() ? entries.at(it.value()).mediaFile : QString();
+}
+
+QString QuestionBank::normalize(const QString &text)
+{
+    // Décomposition (é -> e + accent) puis suppression des diacritiques
+    const QString decomposed = text.normalized(QString::NormalizationForm_KD);
+    QString result;
+    result.reserve(decomposed.size());
+    for (const QChar c : decomposed) {
+        if (c.category() == QChar::Mark_NonSpacing)
+            continue;
+        if (c == QChar(0x0153)) {           // œ
+            result += QLatin1String("oe");
+            continue;
+        }
+        if (c == QChar(0x00E6)) {           // æ
+            result += QLatin1String("ae");
+            continue;
+        }
+        result += c.toCaseFolded();
+    }
+    return result;
+}
+
+QStringList QuestionBank::tokenize(const QString &text)
+{
+    const QString normalized = normalize(text);
+    QStringList tokens;
+    int start = -1;
+    for (int i = 0; i <= normalized.size(); ++i) {
+        const bool word = i < normalized.size() && normalized.at(i).isLetterOrNumber();
+        if (word && start < 0) {
+            start = i;
+        } else if (!word && start >= 0) {
+            tokens.append(normalized.mid(start, i - start));
+            start = -1;
+        }
+    }
+    return tokens;
+}
+
+QuestionBank::Postings QuestionBank::postingsFor(const QString &term, bool prefix) const
+{
+    if (!prefix)
+        return index.value(term);
+
+    // Les termes qui commencent par `term` se suivent dans le vocabulaire trié
+    auto first = std::lower_bound(sortedTerms.cbegin(), sortedTerms.cend(), term);
+    auto last = first;
+    while (last != sortedTerms.cend() && last->startsWith(term))
+        ++last;
+
+    if (last - first == 1)
+        return index.value(*first);
+
+    Postings merged;
+    for (auto it = first; it != last; ++it)
+        merged += index.value(*it);
+    std::sort(merged.begin(), merged.end());
+    merged.erase(std::unique(merged.begin(), merged.end()), merged.end());
+    return merged;
+}
+
+bool QuestionBank::matches(const Entry &entry, const Filter &filter) const
+{
+    if (filter.minDifficulty >= 0 && (entry.difficulty < 0 || entry.difficulty < filter.minDifficulty))
+        return false;
+    if (filter.maxDifficulty >= 0 && (entry.difficulty < 0 || entry.difficulty > filter.maxDifficulty))
+        return false;
+    return true;
+}
+
+QVector<int> QuestionBank::search(const QString &query, const Filter &filter, int limit) const
+{
+    // Listes à intersecter : une par terme, plus le thème s'il est filtré
+    QVector<Postings> lists;
+    const QStringList words = query.split(' ', Qt::SkipEmptyParts);
+    for (const QString &word : words) {
+        const bool prefix = word.endsWith('*');
+        const QStringList terms = tokenize(prefix ? word.chopped(1) : word);
+        for (int i = 0; i < terms.size(); ++i) {
+            // "l'eau*" : seul le dernier morceau est un préfixe
+            lists.append(postingsFor(terms.at(i), prefix && i == terms.size() - 1));
+            if (lists.last().isEmpty())
+                return QVector<int>();
+        }
+    }
+    if (!filter.theme.isEmpty()) {
+        lists.append(themeIndex.value(normalize(filter.theme)));
+        if (lists.last().isEmpty())
+            return QVector<int>();
+    }
+
+    QVector<int> results;
+    if (lists.isEmpty()) {
+        // Filtre de difficulté seul : parcours complet
+        for (int id = 0; id < indexedCount && (limit < 0 || results.size() < limit); ++id) {
+            if (matches(entries.at(id), filter))
+                results.append(id);
+        }
+        return results;
+    }
+
+    // Intersection en partant de la liste la plus courte
+    std::sort(lists.begin(), lists.end(), [](const Postings &a, const Postings &b) {
+        return a.size() < b.size();
+    });
+    Postings candidates = lists.first();
+    for (int i = 1; i < lists.size() && !candidates.isEmpty(); ++i) {
+        Postings next;
+        next.reserve(candidates.size());
+        std::set_intersection(candidates.cbegin(), candidates.cend(),
+                              lists.at(i).cbegin(), lists.at(i).cend(), std::back_inserter(next));
+        candidates.swap(next);
+    }
+
+    for (int id : std::as_const(candidates)) {
+        if (limit >= 0 && results.size() >= limit)
+            break;
+        if (matches(entries.at(id), filter))
+            results.append(id);
+    }
+    return results;
+}
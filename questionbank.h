@@ -0,0 +1,87 @@
+#ifndef QUESTIONBANK_H
+#define QUESTIONBANK_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QHash>
+#include "question.h"
+
+// Banque de questions consultable (thème, difficulté, texte).
+//
+// Un index inversé (terme normalisé -> identifiants triés) est construit au
+// chargement : recherche sans accents ni casse, termes préfixes ("plan*") et
+// filtres par thème / difficulté. Une fois buildIndex() appelé, la banque
+// n'est plus modifiée et peut être lue depuis plusieurs threads.
+class QuestionBank
+{
+public:
+    struct Entry {
+        Question question;
+        QString theme;
+        int difficulty = -1;        // 0..100 (QuizzStats), -1 si inconnue
+        QString mediaFile;          // fichier du média de la question (côté hôte)
+    };
+
+    static constexpr qint64 MAX_MEDIA_SIZE = 8 * 1024 * 1024;
+
+    struct Filter {
+        QString theme;              // vide = tous les thèmes
+        int minDifficulty = -1;     // -1 = pas de borne
+        int maxDifficulty = -1;
+    };
+
+    QuestionBank();
+
+    // Banque des packs intégrés (Game::Theme), construite une fois
+    static const QuestionBank &builtin();
+
+    void addBuiltinPacks();
+    static const QStringList &builtinThemes();   // noms des thèmes, dans l'ordre de Game::Theme
+    // .json (tableau de {question, answers, correct[, theme, difficulty, media]},
+    // media : image ou son, chemin relatif au fichier),
+    // .csv (question;r1;r2;r3;r4;correct[;theme;difficulty]) ou .qzb (format
+    // binaire indexé, voir save()). Le thème par défaut est le nom du fichier.
+    bool loadFile(const QString &path, QString *error = nullptr);
+    // Écrit la banque et son index : le rechargement ne refait aucune analyse
+    bool save(const QString &path, QString *error = nullptr) const;
+    // Scores de difficulté de QuizzStats (JSON Question::getId() -> score)
+    bool loadDifficulties(const QString &path, QString *error = nullptr);
+    int add(const Question &question, const QString &theme, int difficulty = -1);
+    // Ajout avec termes déjà calculés (entryTerms()), pour les imports qui
+    // normalisent en parallèle ; buildIndex() reste à appeler à la fin
+    int addTokenized(const Entry &entry, const QStringList &terms);
+    void buildIndex();
+
+    int size() const;
+    const Entry &entry(int id) const;
+    QStringList themes() const;
+    QString mediaFile(const QByteArray &hash) const;     // vide si aucun média de la banque n'a ce contenu
+
+    // Tous les termes doivent correspondre ; un terme suivi de '*' est un préfixe.
+    // Renvoie les identifiants par ordre croissant, au plus `limit` (-1 = tous).
+    QVector<int> search(const QString &query, const Filter &filter = Filter(), int limit = -1) const;
+
+    static QString normalize(const QString &text);
+    static QStringList tokenize(const QString &text);
+    static QStringList entryTerms(const Question &question);
+
+private:
+    using Postings = QVector<int>;
+
+    bool loadBinary(const QString &path, QString *error);
+    void indexPending();
+    void indexEntry(int id, const QStringList &terms);
+    Postings postingsFor(const QString &term, bool prefix) const;
+    bool matches(const Entry &entry, const Filter &filter) const;
+
+    QVector<Entry> entries;
+    QHash<QString, Postings> index;         // terme -> ids croissants
+    QStringList sortedTerms;                // pour les recherches par préfixe
+    QHash<QString, Postings> themeIndex;    // thème -> ids croissants
+    QHash<QByteArray, int> mediaIndex;      // SHA-256 du média -> id
+    int indexedCount;
+    bool sortedTermsStale;
+};
+
+#endif // QUESTIONBANK_H
@@ -0,0 +1,431 @@
+#include "questionimporter.h"
+#include <QElapsedTimer>
+#include <QFile>
+#include <QFileInfo>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <climits>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// 16 bits par valeur : deux fois moins de mémoire, collisions négligeables
+// pour une estimation de similarité
+using Signature = std::array<quint16, QuestionImporter::SIGNATURE_SIZE>;
+
+static constexpr int ANSWER_COUNT = 4;
+static constexpr int SHINGLE_SIZE = 4;              // 4-grammes de caractères
+static constexpr int MAX_BUCKET_CANDIDATES = 8;     // comparaisons par seau LSH
+static constexpr qint64 MIN_CHUNK_SIZE = 1024 * 1024;
+
+enum class Format { Csv, JsonLines, JsonArray };
+
+struct ParsedRow
+{
+    int line = 0;
+    QuestionBank::Entry entry;
+    QStringList terms;
+    Signature signature;
+};
+
+struct ParsedChunk
+{
+    QVector<ParsedRow> rows;
+    QVector<QuestionImporter::Issue> errors;
+    int lineCount = 0;
+};
+
+template <typename Function>
+static void parallelFor(int threadCount, Function function)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int t = 0; t < threadCount; ++t)
+        threads.emplace_back(function, t);
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+static const std::array<quint64, 2 * QuestionImporter::SIGNATURE_SIZE> &hashSeeds()
+{
+    // Coefficients fixes (splitmix64) : signatures comparables d'un import à l'autre
+    static const auto seeds = []() {
+        std::array<quint64, 2 * QuestionImporter::SIGNATURE_SIZE> values;
+        quint64 state = 0x5155495A5A47414DULL;
+        for (quint64 &value : values) {
+            quint64 z = (state += 0x9E3779B97F4A7C15ULL);
+            z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+            z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+            value = (z ^ (z >> 31)) | 1;
+        }
+        return values;
+    }();
+    return seeds;
+}
+
+static Signature minHash(const QStringList &questionTokens)
+{
+    const auto &seeds = hashSeeds();
+    const QString text = questionTokens.join(' ');
+    const int shingleCount = qMax(1, int(text.size()) - SHINGLE_SIZE + 1);
+
+    Signature signature;
+    signature.fill(0xFFFF);
+    for (int i = 0; i < shingleCount; ++i) {
+        // FNV-1a 64 bits du 4-gramme, puis une permutation par valeur de signature
+        quint64 hash = 14695981039346656037ULL;
+        const int end = qMin<int>(i + SHINGLE_SIZE, text.size());
+        for (int c = i; c < end; ++c) {
+            hash ^= text.at(c).unicode();
+            hash *= 1099511628211ULL;
+        }
+        for (int k = 0; k < QuestionImporter::SIGNATURE_SIZE; ++k) {
+            const quint16 value = quint16((hash * seeds[2 * k] + seeds[2 * k + 1]) >> 48);
+            signature[k] = qMin(signature[k], value);
+        }
+    }
+    return signature;
+}
+
+static double similarity(const Signature &a, const Signature &b)
+{
+    int equal = 0;
+    for (int k = 0; k < QuestionImporter::SIGNATURE_SIZE; ++k)
+        equal += a[k] == b[k];
+    return double(equal) / QuestionImporter::SIGNATURE_SIZE;
+}
+
+static bool validateEntry(const QuestionBank::Entry &entry, QString *message)
+{
+    if (entry.question.getQuestionText().trimmed().isEmpty()) {
+        *message = "question vide";
+        return false;
+    }
+    const QStringList answers = entry.question.getAnswers();
+    if (answers.size() != ANSWER_COUNT) {
+        *message = QString("4 réponses attendues, %1 trouvées").arg(answers.size());
+        return false;
+    }
+    for (const QString &answer : answers) {
+        if (answer.trimmed().isEmpty()) {
+            *message = "réponse vide";
+            return false;
+        }
+    }
+    const int correct = entry.question.getCorrectAnswerIndex();
+    if (correct < 0 || correct >= ANSWER_COUNT) {
+        *message = "indice de bonne réponse hors de 0..3";
+        return false;
+    }
+    return true;
+}
+
+static bool entryFromCsv(const QString &line, const QString &defaultTheme, QuestionBank::Entry *entry, QString *message)
+{
+    const QStringList fields = line.split(';');
+    if (fields.size() < 6 || fields.size() > 8) {
+        *message = QString("6 à 8 champs attendus, %1 trouvés").arg(fields.size());
+        return false;
+    }
+
+    bool ok = false;
+    const int correct = fields.at(5).trimmed().toInt(&ok);
+    entry->question = Question(fields.at(0).trimmed(),
+                               {fields.at(1).trimmed(), fields.at(2).trimmed(),
+                                fields.at(3).trimmed(), fields.at(4).trimmed()},
+                               ok ? correct : -1);
+    entry->theme = fields.size() > 6 && !fields.at(6).trimmed().isEmpty() ? fields.at(6).trimmed() : defaultTheme;
+    entry->difficulty = -1;
+    if (fields.size() > 7) {
+        const int difficulty = fields.at(7).trimmed().toInt(&ok);
+        if (ok)
+            entry->difficulty = qBound(0, difficulty, 100);
+    }
+    return validateEntry(*entry, message);
+}
+
+static bool entryFromJson(const QJsonObject &object, const QString &defaultTheme, QuestionBank::Entry *entry, QString *message)
+{
+    if (!object["question"].isString() || !object["answers"].isArray() || !object["correct"].isDouble()) {
+        *message = "champs \"question\", \"answers\" et \"correct\" requis";
+        return false;
+    }
+
+    QStringList answers;
+    for (const QJsonValue &answer : object["answers"].toArray())
+        answers.append(answer.toString());
+    entry->question = Question(object["question"].toString(), answers, object["correct"].toInt());
+    entry->theme = object["theme"].toString(defaultTheme);
+    entry->difficulty = object["difficulty"].isDouble() ? qBound(0, object["difficulty"].toInt(), 100) : -1;
+    return validateEntry(*entry, message);
+}
+
+static void addRow(ParsedChunk *chunk, int line, const QuestionBank::Entry &entry)
+{
+    ParsedRow row;
+    row.line = line;
+    row.entry = entry;
+
+    // Normalisation faite ici, en parallèle : sert à la fois à la signature
+    // et à l'index de la banque
+    const QStringList questionTokens = QuestionBank::tokenize(entry.question.getQuestionText());
+    row.signature = minHash(questionTokens);
+    row.terms = questionTokens;
+    for (const QString &answer : entry.question.getAnswers())
+        row.terms += QuestionBank::tokenize(answer);
+    std::sort(row.terms.begin(), row.terms.end());
+    row.terms.erase(std::unique(row.terms.begin(), row.terms.end()), row.terms.end());
+
+    chunk->rows.append(row);
+}
+
+static void parseLines(const char *begin, const char *end, Format format, bool skipHeader,
+                       const QString &defaultTheme, ParsedChunk *chunk)
+{
+    bool header = skipHeader;
+    int line = 0;
+    for (const char *p = begin; p < end;) {
+        const char *eol = static_cast<const char *>(std::memchr(p, '\n', size_t(end - p)));
+        if (!eol)
+            eol = end;
+        ++line;
+
+        const QByteArray raw = QByteArray::fromRawData(p, int(eol - p)).trimmed();
+        p = eol + 1;
+        if (raw.isEmpty() || (format == Format::Csv && raw.startsWith('#')))
+            continue;
+        if (header) {
+            header = false;
+            continue;
+        }
+
+        QuestionBank::Entry entry;
+        QString message;
+        bool valid = false;
+        if (format == Format::Csv) {
+            valid = entryFromCsv(QString::fromUtf8(raw), defaultTheme, &entry, &message);
+        } else {
+            QJsonParseError parseError;
+            const QJsonDocument document = QJsonDocument::fromJson(raw, &parseError);
+            if (!document.isObject())
+                message = parseError.error != QJsonParseError::NoError ? parseError.errorString() : "objet JSON attendu";
+            else
+                valid = entryFromJson(document.object(), defaultTheme, &entry, &message);
+        }
+
+        if (valid)
+            addRow(chunk, line, entry);
+        else
+            chunk->errors.append({line, message});
+    }
+    chunk->lineCount = line;
+}
+
+QuestionImporter::QuestionImporter(const Options &options)
+    : options(options)
+{
+}
+
+bool QuestionImporter::importFile(const QString &path, QuestionBank *bank, Report *report, QString *error)
+{
+    QElapsedTimer clock;
+    clock.start();
+    *report = Report();
+
+    const QFileInfo info(path);
+    const QString suffix = info.suffix().toLower();
+    const QString defaultTheme = info.completeBaseName();
+    Format format;
+    if (suffix == "csv") {
+        format = Format::Csv;
+    } else if (suffix == "jsonl") {
+        format = Format::JsonLines;
+    } else if (suffix == "json") {
+        format = Format::JsonArray;
+    } else {
+        if (error)
+            *error = path + " : format non pris en charge (.csv, .jsonl ou .json)";
+        return false;
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = QString("%1 : %2").arg(path, file.errorString());
+        return false;
+    }
+    report->bytes = file.size();
+
+    const int threadCount = options.threadCount > 0 ? options.threadCount
+                                                    : qMax(1, int(std::thread::hardware_concurrency()));
+    QVector<ParsedChunk> chunks;
+
+    if (format == Format::JsonArray) {
+        // Un tableau JSON ne se découpe pas : analyse d'un bloc, puis
+        // validation et signatures en parallèle
+        QJsonParseError parseError;
+        const QJsonDocument document = QJsonDocument::fromJson(file.readAll(), &parseError);
+        if (!document.isArray()) {
+            if (error)
+                *error = QString("%1 : %2").arg(path, parseError.errorString());
+            return false;
+        }
+        const QJsonArray array = document.array();
+        chunks.resize(threadCount);
+        ParsedChunk *chunkData = chunks.data();
+        parallelFor(threadCount, [&](int t) {
+            const int first = int(qint64(array.size()) * t / threadCount);
+            const int last = int(qint64(array.size()) * (t + 1) / threadCount);
+            ParsedChunk &chunk = chunkData[t];
+            for (int i = first; i < last; ++i) {
+                QuestionBank::Entry entry;
+                QString message;
+                if (entryFromJson(array.at(i).toObject(), defaultTheme, &entry, &message))
+                    addRow(&chunk, i + 1, entry);
+                else
+                    chunk.errors.append({i + 1, message});
+            }
+        });
+    } else {
+        const qint64 size = file.size();
+        const uchar *mapped = size > 0 ? file.map(0, size) : nullptr;
+        if (size > 0 && !mapped) {
+            if (error)
+                *error = QString("%1 : %2").arg(path, file.errorString());
+            return false;
+        }
+        const char *data = reinterpret_cast<const char *>(mapped);
+
+        // Tranches coupées juste après un saut de ligne
+        QVector<qint64> bounds{0};
+        const qint64 chunkSize = qMax(MIN_CHUNK_SIZE, size / (threadCount * 8));
+        while (bounds.last() < size) {
+            qint64 next = qMin(bounds.last() + chunkSize, size);
+            if (next < size) {
+                const void *eol = std::memchr(data + next, '\n', size_t(size - next));
+                next = eol ? static_cast<const char *>(eol) - data + 1 : size;
+            }
+            bounds.append(next);
+        }
+
+        chunks.resize(bounds.size() - 1);
+        ParsedChunk *chunkData = chunks.data();
+        const int chunkCount = chunks.size();
+        std::atomic<int> nextChunk(0);
+        parallelFor(qMin(threadCount, chunkCount), [&](int) {
+            for (int c = nextChunk++; c < chunkCount; c = nextChunk++) {
+                parseLines(data + bounds.at(c), data + bounds.at(c + 1), format,
+                           format == Format::Csv && c == 0, defaultTheme, &chunkData[c]);
+            }
+        });
+
+        // Numéros de ligne relatifs à la tranche -> absolus
+        int lineOffset = 0;
+        for (ParsedChunk &chunk : chunks) {
+            for (ParsedRow &row : chunk.rows)
+                row.line += lineOffset;
+            for (Issue &issue : chunk.errors)
+                issue.line += lineOffset;
+            lineOffset += chunk.lineCount;
+        }
+        if (mapped)
+            file.unmap(const_cast<uchar *>(mapped));
+    }
+
+    QVector<const ParsedRow *> rows;
+    for (const ParsedChunk &chunk : chunks) {
+        for (const ParsedRow &row : chunk.rows)
+            rows.append(&row);
+        report->errors += chunk.errors;
+    }
+
+    // Signatures de la banque existante, puis LSH sur l'ensemble :
+    // ids [0, existing) = banque, [existing, total) = lignes importées
+    const int existing = bank->size();
+    const int total = existing + rows.size();
+    std::vector<Signature> existingSignatures(existing);
+    parallelFor(threadCount, [&](int t) {
+        const int first = int(qint64(existing) * t / threadCount);
+        const int last = int(qint64(existing) * (t + 1) / threadCount);
+        for (int id = first; id < last; ++id)
+            existingSignatures[id] = minHash(QuestionBank::tokenize(bank->entry(id).question.getQuestionText()));
+    });
+    auto signatureOf = [&](int id) -> const Signature & {
+        return id < existing ? existingSignatures[id] : rows.at(id - existing)->signature;
+    };
+
+    std::vector<std::atomic<int>> matchOf(rows.size());
+    for (std::atomic<int> &match : matchOf)
+        match.store(INT_MAX, std::memory_order_relaxed);
+
+    std::atomic<int> nextBand(0);
+    parallelFor(qMin(threadCount, int(LSH_BANDS)), [&](int) {
+        std::vector<std::pair<quint64, int>> keys(total);
+        for (int band = nextBand++; band < LSH_BANDS; band = nextBand++) {
+            for (int id = 0; id < total; ++id) {
+                const Signature &signature = signatureOf(id);
+                quint64 key = 14695981039346656037ULL;
+                for (int r = 0; r < LSH_ROWS; ++r) {
+                    key ^= signature[band * LSH_ROWS + r];
+                    key *= 1099511628211ULL;
+                }
+                keys[id] = {key, id};
+            }
+            // Tri par seau puis par id : chaque ligne n'est comparée qu'aux
+            // premiers éléments plus anciens de son seau
+            std::sort(keys.begin(), keys.end());
+
+            for (int start = 0; start < total;) {
+                int end = start + 1;
+                while (end < total && keys[end].first == keys[start].first)
+                    ++end;
+                for (int j = start + 1; j < end; ++j) {
+                    const int id = keys[j].second;
+                    if (id < existing)
+                        continue;
+                    std::atomic<int> &match = matchOf[id - existing];
+                    const int candidates = qMin(j, start + MAX_BUCKET_CANDIDATES);
+                    for (int c = start; c < candidates; ++c) {
+                        const int other = keys[c].second;
+                        if (other >= match.load(std::memory_order_relaxed))
+                            break;
+                        if (similarity(signatureOf(id), signatureOf(other)) >= options.duplicateThreshold) {
+                            int current = match.load(std::memory_order_relaxed);
+                            while (other < current && !match.compare_exchange_weak(current, other)) {}
+                            break;
+                        }
+                    }
+                }
+                start = end;
+            }
+        }
+    });
+
+    auto textOf = [&](int id) {
+        return id < existing ? bank->entry(id).question.getQuestionText()
+                             : rows.at(id - existing)->entry.question.getQuestionText();
+    };
+    for (int i = 0; i < rows.size(); ++i) {
+        const ParsedRow &row = *rows.at(i);
+        const int match = matchOf[i].load(std::memory_order_relaxed);
+        if (match != INT_MAX) {
+            report->duplicates.append({row.line, row.entry.question.getQuestionText(), textOf(match),
+                                       similarity(row.signature, signatureOf(match))});
+            if (!options.keepDuplicates)
+                continue;
+        }
+        bank->addTokenized(row.entry, row.terms);
+        ++report->accepted;
+    }
+    bank->buildIndex();
+
+    std::sort(report->errors.begin(), report->errors.end(), [](const Issue &a, const Issue &b) {
+        return a.line < b.line;
+    });
+    report->elapsedMs = clock.elapsed();
+    return true;
+}
@@ -0,0 +1,60 @@
+#ifndef QUESTIONIMPORTER_H
+#define QUESTIONIMPORTER_H
+
+#include <QString>
+#include <QVector>
+#include "questionbank.h"
+
+// Import en masse de fichiers de questions dans une QuestionBank.
+//
+// Le fichier est projeté en mémoire et découpé en tranches de lignes
+// analysées, validées et normalisées sur tous les coeurs. Les questions
+// quasi identiques (à la banque ou entre elles) sont repérées par signatures
+// MinHash regroupées par LSH, puis écartées sauf si keepDuplicates.
+//
+// Formats : .csv (question;r1;r2;r3;r4;correct[;theme;difficulty], en-tête),
+// .jsonl (un objet par ligne) et .json (tableau, analysé d'un bloc).
+class QuestionImporter
+{
+public:
+    struct Options {
+        int threadCount = 0;                // 0 = un par coeur
+        double duplicateThreshold = 0.8;    // similarité de Jaccard estimée
+        bool keepDuplicates = false;
+    };
+
+    struct Issue {
+        int line = 0;                       // ligne (CSV, JSONL) ou entrée (JSON)
+        QString message;
+    };
+
+    struct Duplicate {
+        int line = 0;
+        QString text;
+        QString matchedText;
+        double similarity = 0.0;
+    };
+
+    struct Report {
+        int accepted = 0;
+        QVector<Issue> errors;
+        QVector<Duplicate> duplicates;
+        qint64 bytes = 0;
+        qint64 elapsedMs = 0;
+    };
+
+    static constexpr int SIGNATURE_SIZE = 64;
+    static constexpr int LSH_BANDS = 16;                            // 16 bandes de 4 valeurs
+    static constexpr int LSH_ROWS = SIGNATURE_SIZE / LSH_BANDS;
+
+    explicit QuestionImporter(const Options &options = Options());
+
+    // Ajoute les entrées valides à `bank` (index compris). Les lignes invalides
+    // sont listées dans le rapport ; false seulement si le fichier est illisible.
+    bool importFile(const QString &path, QuestionBank *bank, Report *report, QString *error = nullptr);
+
+private:
+    Options options;
+};
+
+#endif // QUESTIONIMPORTER_H
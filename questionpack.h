@@ -0,0 +1,35 @@
+#ifndef QUESTIONPACK_H
+#define QUESTIONPACK_H
+
+#include <cstddef>
+
+// Tables statiques des packs de questions intégrés. Les données sont
+// générées à la compilation (cmake/questionpacks.cmake -> questionpacks_data.h)
+// à partir de questions/*.json : aucune analyse ni allocation au chargement.
+
+struct QuestionPackString
+{
+    const char16_t *data;
+    int size;
+};
+
+template <std::size_t N>
+constexpr QuestionPackString packString(const char16_t (&text)[N])
+{
+    return {text, int(N - 1)};
+}
+
+struct QuestionPackEntry
+{
+    QuestionPackString text;
+    QuestionPackString answers[4];
+    int correctAnswerIndex;
+};
+
+struct QuestionPack
+{
+    const QuestionPackEntry *entries;
+    int size;
+};
+
+#endif // QUESTIONPACK_H
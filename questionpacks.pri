@@ -0,0 +1,19 @@
+# Packs de questions intégrés, un fichier par Game::Theme (dans l'ordre),
+# compilés en tables constexpr par cmake/questionpacks.cmake ;
+# une entrée invalide fait échouer la compilation.
+QUESTION_PACKS = \
+    $$PWD/questions/science.json \
+    $$PWD/questions/sport.json \
+    $$PWD/questions/culture.json
+
+questionpacks.target = $$OUT_PWD/questionpacks_data.h
+questionpacks.commands = cmake -DOUTPUT=$$shell_quote($$OUT_PWD/questionpacks_data.h) \
+    $$shell_quote(-DPACKS=$$join(QUESTION_PACKS, ";")) -P $$shell_quote($$PWD/cmake/questionpacks.cmake)
+questionpacks.depends = $$QUESTION_PACKS $$PWD/cmake/questionpacks.cmake
+
+QMAKE_EXTRA_TARGETS += questionpacks
+PRE_TARGETDEPS += $$OUT_PWD/questionpacks_data.h
+INCLUDEPATH += $$OUT_PWD
+
+HEADERS += $$PWD/questionpack.h
+DISTFILES += $$QUESTION_PACKS
@@ -0,0 +1,236 @@
+#include "questionstore.h"
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QThread>
+#include <QTimer>
+#include <QDebug>
+
+static const int RELOAD_DELAY_MS = 250;
+static const int RECLAIM_INTERVAL_MS = 2000;
+
+struct QuestionStore::Data
+{
+    QuestionBank bank;
+    QVector<QVector<Question>> themeQuestions;   // précalculées, par Game::Theme
+    quint64 version = 0;
+    std::atomic<int> refs{0};
+};
+
+QuestionStore::Snapshot::Snapshot()
+    : d(nullptr)
+{
+}
+
+QuestionStore::Snapshot::Snapshot(Data *data)
+    : d(data)
+{
+}
+
+QuestionStore::Snapshot::Snapshot(const Snapshot &other)
+    : d(other.d)
+{
+    if (d)
+        d->refs.fetch_add(1, std::memory_order_relaxed);
+}
+
+QuestionStore::Snapshot &QuestionStore::Snapshot::operator=(const Snapshot &other)
+{
+    if (other.d)
+        other.d->refs.fetch_add(1, std::memory_order_relaxed);
+    if (d)
+        d->refs.fetch_sub(1, std::memory_order_release);
+    d = other.d;
+    return *this;
+}
+
+QuestionStore::Snapshot::~Snapshot()
+{
+    // La libération elle-même est faite par le store (reclaim)
+    if (d)
+        d->refs.fetch_sub(1, std::memory_order_release);
+}
+
+bool QuestionStore::Snapshot::isNull() const
+{
+    return d == nullptr;
+}
+
+quint64 QuestionStore::Snapshot::version() const
+{
+    return d ? d->version : 0;
+}
+
+const QuestionBank &QuestionStore::Snapshot::bank() const
+{
+    static const QuestionBank empty;
+    return d ? d->bank : empty;
+}
+
+QVector<Question> QuestionStore::Snapshot::questionsForTheme(int theme) const
+{
+    if (!d || theme < 0 || theme >= d->themeQuestions.size())
+        return QVector<Question>();
+    return d->themeQuestions.at(theme);
+}
+
+QuestionStore::QuestionStore(const QStringList &bankFiles, QObject *parent)
+    : QObject(parent), files(bankFiles), watcher(nullptr), rebuildThread(nullptr),
+      reloadPending(false), nextVersion(1), current(nullptr), readers(0)
+{
+    for (QString &file : files)
+        file = QFileInfo(file).absoluteFilePath();
+
+    // Première version construite tout de suite : snapshot() ne renvoie jamais rien de vide
+    QString error;
+    Data *initial = build(files, nextVersion++, &error);
+    if (!initial) {
+        qWarning() << "Question banks not loaded, using built-in packs:" << error;
+        initial = build(QStringList(), nextVersion - 1, &error);
+    }
+    current.store(initial);
+
+    reloadTimer = new QTimer(this);
+    reloadTimer->setSingleShot(true);
+    reloadTimer->setInterval(RELOAD_DELAY_MS);
+    connect(reloadTimer, &QTimer::timeout, this, &QuestionStore::reload);
+
+    reclaimTimer = new QTimer(this);
+    reclaimTimer->setInterval(RECLAIM_INTERVAL_MS);
+    connect(reclaimTimer, &QTimer::timeout, this, &QuestionStore::reclaim);
+
+    watcher = new QFileSystemWatcher(this);
+    connect(watcher, &QFileSystemWatcher::fileChanged, reloadTimer, qOverload<>(&QTimer::start));
+    watchFiles();
+}
+
+QuestionStore::~QuestionStore()
+{
+    if (rebuildThread) {
+        rebuildThread->wait();
+    }
+    // Les parties (qui tiennent des Snapshot) sont détruites avant le store
+    delete current.load();
+    qDeleteAll(retired);
+}
+
+QuestionStore::Snapshot QuestionStore::snapshot() const
+{
+    readers.fetch_add(1);
+    Data *data = current.load();
+    data->refs.fetch_add(1, std::memory_order_relaxed);
+    readers.fetch_sub(1, std::memory_order_release);
+    return Snapshot(data);
+}
+
+QStringList QuestionStore::bankFiles() const
+{
+    return files;
+}
+
+void QuestionStore::reload()
+{
+    if (rebuildThread) {
+        reloadPending = true;   // relancé dès la fin de la construction en cours
+        return;
+    }
+    startRebuild();
+}
+
+void QuestionStore::startRebuild()
+{
+    const QStringList paths = files;
+    const quint64 version = nextVersion++;
+
+    rebuildThread = QThread::create([this, paths, version]() {
+        QString error;
+        Data *data = build(paths, version, &error);
+        QMetaObject::invokeMethod(this, [this, data, error]() {
+            if (data) {
+                publish(data);
+            } else {
+                qWarning() << "Question bank reload failed:" << error;
+                emit reloadFailed(error);
+            }
+        }, Qt::QueuedConnection);
+    });
+    connect(rebuildThread, &QThread::finished, this, [this]() {
+        rebuildThread->deleteLater();
+        rebuildThread = nullptr;
+        watchFiles();
+        if (reloadPending) {
+            reloadPending = false;
+            startRebuild();
+        }
+    });
+    rebuildThread->start(QThread::LowPriority);
+}
+
+QuestionStore::Data *QuestionStore::build(const QStringList &files, quint64 version, QString *error)
+{
+    Data *data = new Data;
+    data->version = version;
+    data->bank.addBuiltinPacks();
+    for (const QString &file : files) {
+        if (!data->bank.loadFile(file, error)) {
+            delete data;
+            return nullptr;
+        }
+    }
+    data->bank.buildIndex();
+
+    // Listes par thème préparées ici : le chemin de service ne fait que copier
+    // un QVector partagé
+    const QStringList &themes = QuestionBank::builtinThemes();
+    data->themeQuestions.resize(themes.size());
+    for (int theme = 0; theme < themes.size(); ++theme) {
+        QuestionBank::Filter filter;
+        filter.theme = themes.at(theme);
+        for (int id : data->bank.search(QString(), filter))
+            data->themeQuestions[theme].append(data->bank.entry(id).question);
+    }
+    return data;
+}
+
+void QuestionStore::publish(Data *data)
+{
+    Data *previous = current.exchange(data);
+    retired.append(previous);
+    reclaim();
+    if (!retired.isEmpty()) {
+        reclaimTimer->start();
+    }
+
+    qDebug() << "Question bank version" << data->version << "published:" << data->bank.size() << "questions";
+    emit snapshotPublished(data->version, data->bank.size());
+}
+
+void QuestionStore::reclaim()
+{
+    // Un lecteur peut encore être entre current.load() et refs++ : on attend
+    // qu'il n'y en ait plus aucun. Les nouveaux lecteurs ne voient plus que
+    // la version courante.
+    if (readers.load() != 0) {
+        return;
+    }
+
+    for (int i = retired.size() - 1; i >= 0; --i) {
+        if (retired.at(i)->refs.load(std::memory_order_acquire) == 0) {
+            delete retired.at(i);
+            retired.remove(i);
+        }
+    }
+    if (retired.isEmpty()) {
+        reclaimTimer->stop();
+    }
+}
+
+void QuestionStore::watchFiles()
+{
+    // Un éditeur qui remplace le fichier (écriture + renommage) le fait
+    // disparaître de la surveillance : on le réajoute
+    for (const QString &file : std::as_const(files)) {
+        if (!watcher->files().contains(file) && QFileInfo::exists(file)) {
+            watcher->addPath(file);
+        }
+    }
+}
@@ -0,0 +1,83 @@
+#ifndef QUESTIONSTORE_H
+#define QUESTIONSTORE_H
+
+#include <QObject>
+#include <QStringList>
+#include <QVector>
+#include <atomic>
+#include "questionbank.h"
+
+class QFileSystemWatcher;
+class QThread;
+class QTimer;
+
+// Questions servies aux parties, rechargées à chaud.
+//
+// Les fichiers de banque sont surveillés ; à chaque modification une
+// nouvelle banque est construite sur un thread d'arrière-plan puis publiée
+// par échange atomique de pointeur (style RCU). snapshot() ne prend aucun
+// verrou : un compteur de lecteurs couvre le court instant entre la lecture
+// du pointeur et la prise de référence, et les anciennes versions ne sont
+// libérées qu'une fois plus personne ne les tient.
+class QuestionStore : public QObject
+{
+    Q_OBJECT
+
+    struct Data;
+
+public:
+    // Version figée de la banque ; une partie garde la sienne jusqu'à endGame()
+    class Snapshot
+    {
+    public:
+        Snapshot();
+        Snapshot(const Snapshot &other);
+        Snapshot &operator=(const Snapshot &other);
+        ~Snapshot();
+
+        bool isNull() const;
+        quint64 version() const;
+        const QuestionBank &bank() const;
+        QVector<Question> questionsForTheme(int theme) const;   // Game::Theme
+
+    private:
+        friend class QuestionStore;
+        explicit Snapshot(Data *data);   // référence déjà prise
+
+        Data *d;
+    };
+
+    explicit QuestionStore(const QStringList &bankFiles, QObject *parent = nullptr);
+    ~QuestionStore();
+
+    Snapshot snapshot() const;          // sans verrou, depuis n'importe quel thread
+    QStringList bankFiles() const;
+
+public slots:
+    void reload();
+
+signals:
+    void snapshotPublished(quint64 version, int questionCount);
+    void reloadFailed(const QString &error);
+
+private:
+    static Data *build(const QStringList &files, quint64 version, QString *error);
+    void startRebuild();
+    void publish(Data *data);
+    void reclaim();
+    void watchFiles();
+
+    QStringList files;
+    QFileSystemWatcher *watcher;
+    QTimer *reloadTimer;                // regroupe les notifications d'un même enregistrement
+    QTimer *reclaimTimer;
+    QThread *rebuildThread;
+    bool reloadPending;
+    quint64 nextVersion;
+
+    std::atomic<Data *> current;
+    mutable std::atomic<int> readers;   // lecteurs entre load() et prise de référence
+    QVector<Data *> retired;            // remplacées, encore tenues par des parties
+};
+
+#endif // QUESTIONSTORE_H
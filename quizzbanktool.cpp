@@ -0,0 +1,140 @@
+// QuizzBankTool : recherche dans une banque de questions.
+//
+//   QuizzBankTool [--bank fichier]... [--theme t] [--min-difficulty n]
+//                 [--max-difficulty n] [--difficulties stats.json] [requête]
+//   QuizzBankTool [--bank fichier]... --import fichier... --output banque.qzb
+//
+// Sans --bank, interroge les packs intégrés. Un terme suivi de '*' est un
+// préfixe ; la recherche ignore accents et casse. --import ajoute des
+// fichiers .csv/.jsonl/.json en écartant les quasi-doublons.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QTextStream>
+#include "questionbank.h"
+#include "questionimporter.h"
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizzBankTool");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Recherche dans une banque de questions");
+    parser.addHelpOption();
+    parser.addPositionalArgument("query", "Termes recherchés (préfixe : terme*)", "[query...]");
+    QCommandLineOption bankOption({"b", "bank"}, "Fichier de banque .json ou .csv (répétable)", "file");
+    QCommandLineOption themeOption({"t", "theme"}, "Ne garder qu'un thème", "theme");
+    QCommandLineOption minOption("min-difficulty", "Difficulté minimale (0-100)", "n");
+    QCommandLineOption maxOption("max-difficulty", "Difficulté maximale (0-100)", "n");
+    QCommandLineOption difficultiesOption("difficulties", "Scores de difficulté produits par QuizzStats", "file");
+    QCommandLineOption limitOption({"n", "limit"}, "Nombre maximal de résultats", "n", "50");
+    QCommandLineOption importOption({"i", "import"}, "Importe un fichier .csv, .jsonl ou .json (répétable)", "file");
+    QCommandLineOption outputOption({"o", "output"}, "Écrit la banque indexée (.qzb)", "file");
+    QCommandLineOption keepDuplicatesOption("keep-duplicates", "Importe aussi les quasi-doublons");
+    QCommandLineOption thresholdOption("duplicate-threshold", "Similarité à partir de laquelle deux questions sont des doublons", "0-1", "0.8");
+    QCommandLineOption threadsOption({"j", "threads"}, "Nombre de threads d'import", "n", "0");
+    parser.addOption(bankOption);
+    parser.addOption(themeOption);
+    parser.addOption(minOption);
+    parser.addOption(maxOption);
+    parser.addOption(difficultiesOption);
+    parser.addOption(limitOption);
+    parser.addOption(importOption);
+    parser.addOption(outputOption);
+    parser.addOption(keepDuplicatesOption);
+    parser.addOption(thresholdOption);
+    parser.addOption(threadsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+    QElapsedTimer clock;
+    clock.start();
+
+    QuestionBank bank;
+    const QStringList bankFiles = parser.values(bankOption);
+    const QStringList importFiles = parser.values(importOption);
+    if (bankFiles.isEmpty() && importFiles.isEmpty())
+        bank.addBuiltinPacks();
+    for (const QString &path : bankFiles) {
+        QString error;
+        if (!bank.loadFile(path, &error)) {
+            err << error << '\n';
+            return 1;
+        }
+    }
+    bank.buildIndex();
+
+    if (parser.isSet(difficultiesOption)) {
+        QString error;
+        if (!bank.loadDifficulties(parser.value(difficultiesOption), &error)) {
+            err << error << '\n';
+            return 1;
+        }
+    }
+    err << bank.size() << " questions indexées en " << clock.restart() << " ms\n";
+
+    if (!importFiles.isEmpty()) {
+        QuestionImporter::Options options;
+        options.threadCount = parser.value(threadsOption).toInt();
+        options.duplicateThreshold = parser.value(thresholdOption).toDouble();
+        options.keepDuplicates = parser.isSet(keepDuplicatesOption);
+        QuestionImporter importer(options);
+
+        for (const QString &path : importFiles) {
+            QuestionImporter::Report report;
+            QString error;
+            if (!importer.importFile(path, &bank, &report, &error)) {
+                err << error << '\n';
+                return 1;
+            }
+            for (const QuestionImporter::Issue &issue : report.errors)
+                err << path << ':' << issue.line << " : " << issue.message << '\n';
+            for (const QuestionImporter::Duplicate &duplicate : report.duplicates) {
+                err << path << ':' << duplicate.line << " : quasi-doublon ("
+                    << qRound(duplicate.similarity * 100) << " %) de \"" << duplicate.matchedText << "\"\n";
+            }
+            const double megabytes = double(report.bytes) / (1024 * 1024);
+            err << path << " : " << report.accepted << " importées, " << report.errors.size() << " invalides, "
+                << report.duplicates.size() << " quasi-doublons en " << report.elapsedMs << " ms ("
+                << QString::number(megabytes * 1000.0 / qMax<qint64>(report.elapsedMs, 1), 'f', 1) << " Mo/s)\n";
+        }
+    }
+
+    if (parser.isSet(outputOption)) {
+        QString error;
+        if (!bank.save(parser.value(outputOption), &error)) {
+            err << error << '\n';
+            return 1;
+        }
+        err << bank.size() << " questions écrites dans " << parser.value(outputOption) << '\n';
+        if (parser.positionalArguments().isEmpty())
+            return 0;
+    }
+
+    QuestionBank::Filter filter;
+    filter.theme = parser.value(themeOption);
+    if (parser.isSet(minOption))
+        filter.minDifficulty = parser.value(minOption).toInt();
+    if (parser.isSet(maxOption))
+        filter.maxDifficulty = parser.value(maxOption).toInt();
+
+    const QVector<int> results = bank.search(parser.positionalArguments().join(' '), filter,
+                                             parser.value(limitOption).toInt());
+    const qint64 elapsedUs = clock.nsecsElapsed() / 1000;
+
+    for (int id : results) {
+        const QuestionBank::Entry &entry = bank.entry(id);
+        const QStringList answers = entry.question.getAnswers();
+        out << '[' << entry.theme;
+        if (entry.difficulty >= 0)
+            out << ' ' << entry.difficulty;
+        out << "] " << entry.question.getQuestionText() << '\n';
+        for (int i = 0; i < answers.size(); ++i)
+            out << (i == entry.question.getCorrectAnswerIndex() ? "  * " : "    ") << answers.at(i) << '\n';
+    }
+    err << results.size() << " résultat(s) en " << elapsedUs << " µs\n";
+    return 0;
+}
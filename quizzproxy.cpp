@@ -0,0 +1,141 @@
+// QuizzProxy : proxy TCP qui dégrade le lien vers un hôte QuizzGame
+// (impairmentproxy.h). Les clients rejoignent "127.0.0.1:<port du proxy>".
+//
+// Le profil se règle au lancement puis à chaud, une commande par ligne sur
+// l'entrée standard (id facultatif : sans lui, profil par défaut ou toutes
+// les connexions) :
+//   list | latency <ms> [id] | jitter <ms> [id] | bandwidth <kbit/s> [id]
+//   stalls <par minute> <ms> [id] | resets <par minute> [id]
+//   stall <ms> [id] | reset [id]
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QSocketNotifier>
+#include <QTextStream>
+#include <cstdio>
+#include "impairmentproxy.h"
+
+static void applyCommand(ImpairmentProxy &proxy, const QStringList &words, QTextStream &out)
+{
+    const QString command = words.value(0);
+    auto argument = [&words](int index) { return words.value(index).toDouble(); };
+
+    if (command == "list") {
+        for (const ImpairmentProxy::ConnectionInfo &info : proxy.connections())
+            out << info.id << "  " << info.peer << "  montant " << info.bytesUp << " o, descendant "
+                << info.bytesDown << " o, en attente " << info.queuedBytes << " o\n";
+        out.flush();
+        return;
+    }
+    if (command == "stall") {
+        proxy.stall(words.value(2).toUInt(), int(argument(1)));
+        return;
+    }
+    if (command == "reset") {
+        proxy.reset(words.value(1).toUInt());
+        return;
+    }
+
+    // Réglages de profil : l'id vient après les valeurs
+    const quint32 id = words.value(command == "stalls" ? 3 : 2).toUInt();
+    ImpairmentProxy::Profile profile = id ? proxy.profile(id) : proxy.defaultProfile();
+
+    if (command == "latency") {
+        profile.latencyMs = int(argument(1));
+    } else if (command == "jitter") {
+        profile.jitterMs = int(argument(1));
+    } else if (command == "bandwidth") {
+        profile.bandwidth = qint64(argument(1) * 1000.0 / 8.0);
+    } else if (command == "stalls") {
+        profile.stallsPerMinute = argument(1);
+        profile.stallMs = int(argument(2));
+    } else if (command == "resets") {
+        profile.resetsPerMinute = argument(1);
+    } else {
+        out << "Commande inconnue : " << command << '\n';
+        out.flush();
+        return;
+    }
+
+    if (id == 0)
+        proxy.setDefaultProfile(profile);
+    else if (!proxy.setProfile(id, profile))
+        out << "Connexion inconnue : " << id << '\n';
+    out.flush();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizzProxy");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Proxy de dégradation réseau (latence, gigue, débit, gels, coupures)");
+    parser.addHelpOption();
+    QCommandLineOption listenOption({"l", "listen"}, "Port d'écoute du proxy", "port", "12346");
+    QCommandLineOption targetOption({"t", "target"}, "Hôte QuizzGame", "host:port", "127.0.0.1:12345");
+    QCommandLineOption latencyOption("latency", "Latence par sens", "ms", "0");
+    QCommandLineOption jitterOption("jitter", "Gigue (±)", "ms", "0");
+    QCommandLineOption bandwidthOption("bandwidth", "Débit par sens, 0 : illimité", "kbit/s", "0");
+    QCommandLineOption stallsOption("stalls", "Gels aléatoires par minute", "n", "0");
+    QCommandLineOption stallMsOption("stall-ms", "Durée d'un gel", "ms", "2000");
+    QCommandLineOption resetsOption("resets", "Coupures aléatoires par minute", "n", "0");
+    parser.addOption(listenOption);
+    parser.addOption(targetOption);
+    parser.addOption(latencyOption);
+    parser.addOption(jitterOption);
+    parser.addOption(bandwidthOption);
+    parser.addOption(stallsOption);
+    parser.addOption(stallMsOption);
+    parser.addOption(resetsOption);
+    parser.process(app);
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    const QString target = parser.value(targetOption);
+    const int colon = target.lastIndexOf(':');
+    const QString targetHost = colon > 0 ? target.left(colon) : target;
+    const quint16 targetPort = colon > 0 ? target.mid(colon + 1).toUShort() : 12345;
+
+    ImpairmentProxy::Profile profile;
+    profile.latencyMs = parser.value(latencyOption).toInt();
+    profile.jitterMs = parser.value(jitterOption).toInt();
+    profile.bandwidth = qint64(parser.value(bandwidthOption).toDouble() * 1000.0 / 8.0);
+    profile.stallsPerMinute = parser.value(stallsOption).toDouble();
+    profile.stallMs = parser.value(stallMsOption).toInt();
+    profile.resetsPerMinute = parser.value(resetsOption).toDouble();
+
+    ImpairmentProxy proxy;
+    proxy.setDefaultProfile(profile);
+    QString error;
+    if (!proxy.listen(parser.value(listenOption).toUShort(), targetHost, targetPort, &error)) {
+        err << "Impossible d'écouter : " << error << '\n';
+        return 1;
+    }
+    QObject::connect(&proxy, &ImpairmentProxy::connectionOpened, [&out](quint32 id, const QString &peer) {
+        out << "+ " << id << "  " << peer << '\n';
+        out.flush();
+    });
+    QObject::connect(&proxy, &ImpairmentProxy::connectionClosed, [&out](quint32 id) {
+        out << "- " << id << '\n';
+        out.flush();
+    });
+    err << "Proxy " << proxy.port() << " -> " << targetHost << ':' << targetPort << '\n';
+
+    // Commandes à chaud sur l'entrée standard
+    QTextStream in(stdin);
+    QSocketNotifier commands(fileno(stdin), QSocketNotifier::Read);
+    QObject::connect(&commands, &QSocketNotifier::activated, [&]() {
+        const QString line = in.readLine();
+        if (line.isNull()) {
+            commands.setEnabled(false);     // fin de l'entrée : le proxy continue
+            return;
+        }
+        const QStringList words = line.simplified().split(' ', Qt::SkipEmptyParts);
+        if (!words.isEmpty())
+            applyCommand(proxy, words, out);
+    });
+
+    return app.exec();
+}
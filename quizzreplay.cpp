@@ -0,0 +1,399 @@
+// QuizzReplay : rejoue une capture de trafic (trafficcapture.h, produite avec
+// QUIZZ_CAPTURE) dans une GameSession sans interface ni serveur. Les trames
+// des joueurs passent par le traitement de l'hôte (GameSession) tel quel :
+// équipes, jetons de reconnexion et futurs messages compris ; les mesures
+// portent sur ce traitement, pas sur le réseau (hello et spectate, consommés
+// par NetworkManager, sont ignorés).
+//
+// Les actions de l'hôte (setup_game, start_game, next_question, ses propres
+// réponses) sont reprises de ses trames sortantes ; son équipe n'apparaît pas
+// dans la capture. Les reconnexions acceptées pendant la capture (suivies
+// d'un resume_game) le sont aussi au rejeu, avec un jeton du nouveau secret.
+// L'horloge est virtuelle, avancée à l'horodatage de chaque trame : les fins
+// de question tombent au même instant relatif que pendant la capture.
+// --speed 1 respecte les délais capturés, --speed 0 enchaîne au plus vite.
+// --parse ne rejoue rien : il compare le débit d'analyse des trames
+// capturées, QJsonDocument contre FrameReader.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QLoggingCategory>
+#include <QSet>
+#include <QTextStream>
+#include <QTimer>
+#include <algorithm>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "gamesession.h"
+#include "gameclock.h"
+#include "clienttable.h"
+#include "framereader.h"
+#include "trafficcapture.h"
+
+// Ce que le rejeu doit savoir avant la première trame : la partie de l'hôte
+// et les reconnexions qu'il a acceptées
+struct CaptureSetup
+{
+    QString hostName;
+    Game::Theme theme = Game::SCIENCE;
+    QVector<Question> questions;
+    QSet<quint64> resumedConnections;
+};
+
+static CaptureSetup scanCapture(const QString &path)
+{
+    CaptureSetup setup;
+    bool configured = false;
+    TrafficCapture::Reader reader(path);
+    TrafficCapture::Event event;
+    while (reader.next(&event)) {
+        if (event.kind != TrafficCapture::FRAME_OUT || event.connection == TrafficCapture::HOST_CONNECTION)
+            continue;
+        const QJsonObject message = QJsonDocument::fromJson(event.payload).object();
+        const QString type = message["type"].toString();
+        if (event.connection != TrafficCapture::ALL_PLAYERS) {
+            if (type == "resume_game")
+                setup.resumedConnections.insert(event.connection);
+            continue;
+        }
+        if (setup.hostName.isEmpty())
+            setup.hostName = message["sender"].toString();
+        if (type == "setup_game" && !configured) {
+            // Les questions tirées par l'hôte, pour des scores identiques
+            const QJsonObject data = message["data"].toObject();
+            setup.theme = static_cast<Game::Theme>(data["theme"].toInt());
+            setup.questions = GameSession::questionsFromJson(data["questions"].toArray());
+            configured = true;
+        }
+    }
+    return setup;
+}
+
+// Hôte rejoué : chaque trame passe par sa GameSession, mesurée par type
+class ReplayHost
+{
+public:
+    ReplayHost(const CaptureSetup &setup, GameClock *clock)
+        : setup(setup), session(nullptr, clock)
+    {
+        session.replayHost(setup.hostName, setup.theme, setup.questions);
+    }
+
+    QHash<QString, std::vector<qint64>> latencies;  // ns par type de message
+    quint64 frames = 0;
+    quint64 invalidFrames = 0;
+    quint64 ignoredEvents = 0;
+    int connections = 0;
+
+    void apply(const TrafficCapture::Event &event)
+    {
+        if (event.kind == TrafficCapture::CONNECTION_OPENED) {
+            ++connections;
+            return;
+        }
+        // Côté joueurs : seules les trames reçues ; côté hôte : ses diffusions
+        const bool fromPlayer = event.kind == TrafficCapture::FRAME_IN
+                             && event.connection != TrafficCapture::HOST_CONNECTION;
+        const bool fromHost = event.kind == TrafficCapture::FRAME_OUT
+                           && event.connection == TrafficCapture::ALL_PLAYERS;
+        if (!fromPlayer && !fromHost) {
+            ++ignoredEvents;
+            return;
+        }
+
+        QElapsedTimer timer;
+        timer.start();
+
+        QJsonParseError error;
+        QJsonObject message = QJsonDocument::fromJson(event.payload, &error).object();
+        if (error.error != QJsonParseError::NoError) {
+            ++invalidFrames;
+            return;
+        }
+        const QString type = message["type"].toString();
+        if (fromPlayer) {
+            if (type == "hello" || type == "spectate") {
+                ++ignoredEvents;
+                return;
+            }
+            if (type == "rejoin_game" && setup.resumedConnections.contains(event.connection)) {
+                // Le jeton capturé vient de l'ancien secret
+                QJsonObject data = message["data"].toObject();
+                data["token"] = session.rejoinTokenFor(data["playerName"].toString());
+                message["data"] = data;
+            }
+            session.replayMessage(message, ClientHandle::fromKey(event.connection).clientId());
+        } else if (!handleHostMessage(type, message["data"].toObject())) {
+            ++ignoredEvents;
+            return;
+        }
+
+        latencies[type].push_back(timer.nsecsElapsed());
+        ++frames;
+    }
+
+    GameSnapshot result() const { return session.snapshot(); }
+
+private:
+    // false : diffusion qui n'est qu'un effet des messages déjà rejoués
+    bool handleHostMessage(const QString &type, const QJsonObject &data)
+    {
+        if (type == "start_game") {
+            session.startGame();
+        } else if (type == "next_question") {
+            session.nextQuestion();
+        } else if (type == "answer" && data["playerName"].toString() == setup.hostName) {
+            session.submitAnswer(data["answer"].toInt());
+        } else {
+            return false;
+        }
+        return true;
+    }
+
+    const CaptureSetup &setup;
+    GameSession session;
+};
+
+// --parse : débit d'analyse des trames de la capture, QJsonDocument contre
+// FrameReader (les deux extraient type, data.playerName et data.answer)
+static int compareParsers(const QString &path, int repeat, QTextStream &out)
+{
+    std::vector<QByteArray> payloads;
+    qint64 bytes = 0;
+    TrafficCapture::Reader reader(path);
+    TrafficCapture::Event event;
+    while (reader.next(&event)) {
+        if (event.kind == TrafficCapture::FRAME_IN || event.kind == TrafficCapture::FRAME_OUT) {
+            bytes += event.payload.size();
+            payloads.push_back(event.payload);
+        }
+    }
+    if (payloads.empty()) {
+        out << "Aucune trame dans la capture\n";
+        return 1;
+    }
+
+    quint64 checksum = 0;       // empêche le compilateur d'écarter les lectures
+    QElapsedTimer timer;
+    timer.start();
+    for (int pass = 0; pass < repeat; ++pass) {
+        for (const QByteArray &payload : payloads) {
+            const QJsonObject message = QJsonDocument::fromJson(payload).object();
+            const QJsonObject data = message["data"].toObject();
+            checksum += message["type"].toString().size() + data["playerName"].toString().size()
+                      + data["answer"].toInt();
+        }
+    }
+    const qint64 domNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    quint64 direct = 0;
+    timer.restart();
+    for (int pass = 0; pass < repeat; ++pass) {
+        for (const QByteArray &payload : payloads) {
+            FrameReader::Fields fields;
+            if (FrameReader::read(payload, &fields)) {
+                ++direct;
+                checksum += fields.type.size() + fields.playerName.size() + fields.answer;
+            }
+        }
+    }
+    const qint64 readerNs = qMax<qint64>(1, timer.nsecsElapsed());
+
+    const double frames = double(payloads.size()) * repeat;
+    const double megabytes = double(bytes) * repeat / (1024.0 * 1024.0);
+    out << payloads.size() << " trames, " << bytes << " octets, " << repeat << " passe(s)\n";
+    out << "QJsonDocument : " << qRound64(frames * 1e9 / double(domNs)) << " trames/s, "
+        << megabytes * 1e9 / double(domNs) << " Mo/s\n";
+    out << "FrameReader   : " << qRound64(frames * 1e9 / double(readerNs)) << " trames/s, "
+        << megabytes * 1e9 / double(readerNs) << " Mo/s (x" << double(domNs) / double(readerNs) << ")\n";
+    if (direct < quint64(frames))
+        out << quint64(frames) - direct << " trames laissées à QJsonDocument (échappements, JSON invalide)\n";
+    out << "(contrôle " << (checksum & 0xff) << ")\n";
+    return 0;
+}
+
+static qint64 percentile(std::vector<qint64> &values, double p)
+{
+    if (values.empty())
+        return 0;
+    const std::size_t rank = std::min(values.size() - 1, std::size_t(p * double(values.size())));
+    std::nth_element(values.begin(), values.begin() + rank, values.end());
+    return values[rank];
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizzReplay");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Rejoue une capture de trafic dans une partie sans interface");
+    parser.addHelpOption();
+    parser.addPositionalArgument("capture", "Fichier produit avec QUIZZ_CAPTURE");
+    QCommandLineOption speedOption({"s", "speed"}, "Facteur de vitesse (1 : temps réel, 0 : au plus vite)", "x", "0");
+    QCommandLineOption repeatOption({"r", "repeat"}, "Nombre de passes (au plus vite uniquement)", "n", "1");
+    QCommandLineOption jsonOption("json", "Écrit les mesures en JSON (suivi de performance)", "file");
+    QCommandLineOption parseOption("parse", "Mesure seulement l'analyse des trames (QJsonDocument contre FrameReader)");
+    parser.addOption(speedOption);
+    parser.addOption(repeatOption);
+    parser.addOption(jsonOption);
+    parser.addOption(parseOption);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    const QString path = parser.positionalArguments().first();
+    const double speed = qMax(0.0, parser.value(speedOption).toDouble());
+    const int repeat = speed > 0 ? 1 : qMax(1, parser.value(repeatOption).toInt());
+
+    QTextStream out(stdout);
+    QTextStream err(stderr);
+
+    {
+        TrafficCapture::Reader probe(path);
+        if (!probe.isValid()) {
+            err << "Capture illisible : " << path << '\n';
+            return 1;
+        }
+    }
+
+    if (parser.isSet(parseOption))
+        return compareParsers(path, qMax(1, parser.value(repeatOption).toInt()), out);
+
+    // Le rejeu n'écrit pas dans la capture qu'il lit ; les traces de chaque
+    // message fausseraient les mesures
+    qunsetenv("QUIZZ_CAPTURE");
+    QLoggingCategory::setFilterRules("default.debug=false");
+    const CaptureSetup setup = scanCapture(path);
+
+    QHash<QString, std::vector<qint64>> latencies;
+    std::unique_ptr<VirtualClock> virtualClock;     // déclarée avant l'hôte : détruite après lui
+    std::unique_ptr<ReplayHost> host;
+    quint64 frames = 0;
+    qint64 wallNs = 0;
+
+    for (int pass = 0; pass < repeat; ++pass) {
+        host.reset();
+        virtualClock = std::make_unique<VirtualClock>();
+        host = std::make_unique<ReplayHost>(setup, virtualClock.get());
+        TrafficCapture::Reader reader(path);
+        TrafficCapture::Event event;
+        QElapsedTimer clock;
+        clock.start();
+
+        if (speed == 0) {
+            while (reader.next(&event)) {
+                virtualClock->advanceTo(event.timestampNs / 1000000);
+                host->apply(event);
+            }
+        } else {
+            // Temps réel (ou accéléré) : la boucle d'événements espace les trames
+            bool pending = false;
+            std::function<void()> step = [&]() {
+                if (pending) {
+                    virtualClock->advanceTo(event.timestampNs / 1000000);
+                    host->apply(event);
+                    pending = false;
+                }
+                while (reader.next(&event)) {
+                    const qint64 waitMs = qint64(double(event.timestampNs) / speed / 1e6) - clock.elapsed();
+                    if (waitMs > 0) {
+                        pending = true;
+                        QTimer::singleShot(int(waitMs), Qt::PreciseTimer, step);
+                        return;
+                    }
+                    virtualClock->advanceTo(event.timestampNs / 1000000);
+                    host->apply(event);
+                }
+                app.quit();
+            };
+            QTimer::singleShot(0, step);
+            app.exec();
+        }
+
+        wallNs += clock.nsecsElapsed();
+        frames += host->frames;
+        for (auto it = host->latencies.begin(); it != host->latencies.end(); ++it) {
+            std::vector<qint64> &all = latencies[it.key()];
+            all.insert(all.end(), it.value().begin(), it.value().end());
+        }
+    }
+
+    const GameSnapshot game = host->result();
+    out << host->connections << " connexions, " << host->frames << " trames rejouées";
+    if (host->invalidFrames)
+        out << ", " << host->invalidFrames << " invalides";
+    if (host->ignoredEvents)
+        out << ", " << host->ignoredEvents << " événements ignorés";
+    out << '\n';
+    out << repeat << " passe(s) en " << wallNs / 1000000 << " ms";
+    if (speed == 0 && wallNs > 0)
+        out << " (" << qRound64(double(frames) * 1e9 / double(wallNs)) << " trames/s)";
+    out << "\n\n";
+
+    QJsonObject types;
+    QStringList names = latencies.keys();
+    names.sort();
+    out << "type                  nombre    p50 µs    p99 µs    max µs\n";
+    for (const QString &name : std::as_const(names)) {
+        std::vector<qint64> &values = latencies[name];
+        const qint64 p50 = percentile(values, 0.50);
+        const qint64 p99 = percentile(values, 0.99);
+        const qint64 max = *std::max_element(values.begin(), values.end());
+        out << name.leftJustified(20) << qSetFieldWidth(8) << values.size()
+            << qSetFieldWidth(10) << p50 / 1000.0 << p99 / 1000.0 << max / 1000.0 << qSetFieldWidth(0) << '\n';
+
+        QJsonObject entry;
+        entry["count"] = double(values.size());
+        entry["p50Ns"] = double(p50);
+        entry["p99Ns"] = double(p99);
+        entry["maxNs"] = double(max);
+        types[name] = entry;
+    }
+
+    QJsonObject scores;
+    out << "\nQuestion " << qMin(game.questionIndex + 1, game.totalQuestions)
+        << "/" << game.totalQuestions << ", scores :\n";
+    for (auto it = game.scores.cbegin(); it != game.scores.cend(); ++it) {
+        out << "  " << it.key() << " : " << it.value() << '\n';
+        scores[it.key()] = it.value();
+    }
+
+    QJsonArray teams;
+    if (!game.teams.isEmpty())
+        out << "Équipes :\n";
+    for (const TeamStandings::Standing &team : game.teams) {
+        out << "  " << team.name << " : " << team.score << '\n';
+        QJsonObject entry;
+        entry["name"] = team.name;
+        entry["score"] = team.score;
+        teams.append(entry);
+    }
+
+    if (parser.isSet(jsonOption)) {
+        QJsonObject report;
+        report["capture"] = path;
+        report["passes"] = repeat;
+        report["frames"] = double(frames);
+        report["wallNs"] = double(wallNs);
+        report["types"] = types;
+        report["scores"] = scores;
+        report["teams"] = teams;
+        QFile file(parser.value(jsonOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Impossible d'écrire " << file.fileName() << '\n';
+            return 1;
+        }
+        file.write(QJsonDocument(report).toJson());
+    }
+
+    return 0;
+}
@@ -0,0 +1,126 @@
+// QuizzSim : parties complètes simulées sur une horloge virtuelle
+// (gameclock.h), pour mesurer la logique de Game sans attendre ses chronos.
+//
+// Chaque joueur répond à un instant tiré au hasard, parfois après la fin du
+// compte à rebours ; la question suivante part RESULTS_PAUSE_MS après les
+// résultats, comme un hôte pressé. Toute la logique de partie est celle du
+// jeu : seul le temps est simulé.
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QTextStream>
+#include "game.h"
+#include "gameclock.h"
+
+static constexpr int ANSWER_WINDOW_MS = 12000;      // au-delà des 10 s : réponses en retard
+static constexpr int RESULTS_PAUSE_MS = 3000;
+
+struct SimOptions
+{
+    int players = 8;
+    double accuracy = 0.6;
+};
+
+struct SimTotals
+{
+    quint64 games = 0;
+    quint64 questions = 0;
+    quint64 answers = 0;
+    quint64 lateAnswers = 0;
+    quint64 winnerPoints = 0;
+    qint64 virtualMs = 0;
+};
+
+static void runGame(QRandomGenerator &rng, const SimOptions &options, Game::Theme theme, SimTotals &totals)
+{
+    // Horloge propre à la partie, déclarée avant elle : les réponses encore
+    // programmées à la fin disparaissent avec elle sans jamais s'exécuter
+    VirtualClock clock;
+    Game game(nullptr, &clock);
+    game.createGame(theme);
+
+    QStringList players;
+    for (int i = 0; i < options.players; ++i) {
+        players.append(QString("joueur%1").arg(i + 1));
+        game.addPlayer(players.last());
+    }
+
+    bool finished = false;
+    QObject::connect(&game, &Game::questionChanged, [&](const Question &question) {
+        ++totals.questions;
+        const int index = game.getCurrentQuestionIndex();
+        const int answerCount = int(question.getAnswers().size());
+        for (const QString &player : std::as_const(players)) {
+            const int answer = rng.generateDouble() < options.accuracy ? question.getCorrectAnswerIndex()
+                                                                       : int(rng.bounded(answerCount));
+            clock.schedule(rng.bounded(ANSWER_WINDOW_MS), [&game, &totals, index, player, answer]() {
+                if (game.getState() != Game::QUESTION_ACTIVE || game.getCurrentQuestionIndex() != index) {
+                    ++totals.lateAnswers;
+                    return;
+                }
+                game.submitAnswer(player, answer);
+                ++totals.answers;
+            });
+        }
+    });
+    QObject::connect(&game, &Game::resultsReady, [&]() {
+        clock.schedule(RESULTS_PAUSE_MS, [&game]() { game.nextQuestion(); });
+    });
+    QObject::connect(&game, &Game::gameEnded, [&](const QString &winner) {
+        finished = true;
+        totals.winnerPoints += quint64(game.getPlayerScores().value(winner));
+    });
+
+    game.startGame();
+    while (!finished && clock.advance()) {
+    }
+
+    ++totals.games;
+    totals.virtualMs += clock.nowMs();
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizzSim");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Parties simulées en temps virtuel (banc d'essai de Game)");
+    parser.addHelpOption();
+    QCommandLineOption gamesOption({"g", "games"}, "Nombre de parties", "n", "1000");
+    QCommandLineOption playersOption({"p", "players"}, "Joueurs par partie", "n", "8");
+    QCommandLineOption accuracyOption("accuracy", "Probabilité de bonne réponse", "0-1", "0.6");
+    QCommandLineOption seedOption("seed", "Graine du tirage (parties reproductibles)", "n", "1");
+    parser.addOption(gamesOption);
+    parser.addOption(playersOption);
+    parser.addOption(accuracyOption);
+    parser.addOption(seedOption);
+    parser.process(app);
+
+    const int games = qMax(1, parser.value(gamesOption).toInt());
+    SimOptions options;
+    options.players = qMax(1, parser.value(playersOption).toInt());
+    options.accuracy = qBound(0.0, parser.value(accuracyOption).toDouble(), 1.0);
+    QRandomGenerator rng(parser.value(seedOption).toUInt());
+
+    QTextStream out(stdout);
+    SimTotals totals;
+    QElapsedTimer wall;
+    wall.start();
+
+    const Game::Theme themes[] = {Game::SCIENCE, Game::SPORT, Game::CULTURE};
+    for (int i = 0; i < games; ++i)
+        runGame(rng, options, themes[i % 3], totals);
+
+    const qint64 wallNs = qMax<qint64>(1, wall.nsecsElapsed());
+    out << totals.games << " parties, " << totals.questions << " questions, " << totals.answers
+        << " réponses (" << totals.lateAnswers << " hors délai)\n";
+    out << "Temps réel : " << wallNs / 1000000 << " ms, soit "
+        << qRound64(double(totals.games) * 1e9 / double(wallNs)) << " parties/s\n";
+    out << "Temps simulé : " << totals.virtualMs / 1000 << " s (x"
+        << qRound64(double(totals.virtualMs) * 1e6 / double(wallNs)) << ")\n";
+    out << "Score moyen du gagnant : " << double(totals.winnerPoints) / double(totals.games) << '\n';
+    return 0;
+}
@@ -0,0 +1,398 @@
+// QuizzStats : statistiques par question calculées hors ligne à partir du
+// journal des parties (gamejournal.h).
+//
+// Les réponses sont chargées en colonnes (question, joueur, réponse, correct,
+// latence), segment par segment sur plusieurs threads, puis agrégées par
+// question : précision, répartition des mauvaises réponses, percentiles de
+// latence et score de difficulté. Le texte des questions vient des packs
+// intégrés et des banques de l'hôte (--bank, sinon QUIZZ_BANKS).
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDir>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QHash>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTextStream>
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <thread>
+#include <vector>
+#include "gamejournal.h"
+#include "questionbank.h"
+
+static constexpr int ANSWER_SLOTS = 4;
+static constexpr double QUESTION_DURATION_MS = 10000.0;   // voir Game::startGame()
+static constexpr double PRIOR_WEIGHT = 20.0;              // lissage des questions peu jouées
+
+struct AnswerColumns
+{
+    std::vector<quint64> questionId;
+    std::vector<quint32> player;
+    std::vector<qint8> answer;
+    std::vector<quint8> correct;
+    std::vector<quint32> latencyMs;
+
+    std::size_t size() const { return questionId.size(); }
+
+    void push(quint64 q, quint32 p, qint8 a, quint8 c, quint32 l)
+    {
+        questionId.push_back(q);
+        player.push_back(p);
+        answer.push_back(a);
+        correct.push_back(c);
+        latencyMs.push_back(l);
+    }
+};
+
+struct QuestionStats
+{
+    quint64 questionId = 0;
+    quint64 answers = 0;
+    quint64 correct = 0;
+    quint64 answerCounts[ANSWER_SLOTS] = {};
+    quint32 p50 = 0;
+    quint32 p90 = 0;
+    quint32 p99 = 0;
+    double accuracy = 0.0;
+    int difficulty = 0;
+};
+
+static quint32 playerKey(quint64 gameId, const GameJournal::Record &record)
+{
+    // Identifiant de joueur propre à la partie (FNV-1a sur gameId + nom)
+    quint32 hash = 2166136261u;
+    for (int i = 0; i < 8; ++i) {
+        hash ^= quint8(gameId >> (i * 8));
+        hash *= 16777619u;
+    }
+    for (int i = 0; i < record.textLength; ++i) {
+        hash ^= quint8(record.text[i]);
+        hash *= 16777619u;
+    }
+    return hash;
+}
+
+// Charge les ANSWER_SUBMITTED d'un segment. Un joueur qui change d'avis
+// remplace sa réponse précédente : seule la dernière compte, comme dans Game.
+static AnswerColumns loadSegment(const QString &segmentPath)
+{
+    AnswerColumns columns;
+    QHash<quint64, QHash<quint32, std::size_t>> openAnswers;   // gameId -> joueur -> ligne
+
+    GameJournal::Reader reader(QStringList{segmentPath});
+    GameJournal::Record record;
+    while (reader.next(&record)) {
+        if (record.type == GameJournal::QUESTION_SHOWN || record.type == GameJournal::QUESTION_RESULTS
+            || record.type == GameJournal::GAME_ENDED) {
+            openAnswers.remove(record.gameId);
+            continue;
+        }
+        if (record.type != GameJournal::ANSWER_SUBMITTED)
+            continue;
+
+        const quint32 player = playerKey(record.gameId, record);
+        const qint8 answer = qint8(qBound<int>(-1, record.answerIndex, ANSWER_SLOTS - 1));
+        const quint8 correct = (record.flags & GameJournal::FLAG_CORRECT) ? 1 : 0;
+        const quint32 latency = quint32(qMax<qint32>(record.value, 0));
+
+        auto &game = openAnswers[record.gameId];
+        auto previous = game.constFind(player);
+        if (previous != game.constEnd()) {
+            const std::size_t row = previous.value();
+            columns.answer[row] = answer;
+            columns.correct[row] = correct;
+            columns.latencyMs[row] = latency;
+        } else {
+            game.insert(player, columns.size());
+            columns.push(record.questionId, player, answer, correct, latency);
+        }
+    }
+    return columns;
+}
+
+template <typename Function>
+static void parallelFor(int threadCount, Function function)
+{
+    std::vector<std::thread> threads;
+    threads.reserve(threadCount);
+    for (int t = 0; t < threadCount; ++t)
+        threads.emplace_back(function, t);
+    for (std::thread &thread : threads)
+        thread.join();
+}
+
+static AnswerColumns loadJournal(const QString &directory, int threadCount)
+{
+    const QStringList segments = GameJournal::segmentPaths(directory);
+    std::vector<AnswerColumns> parts(segments.size());
+    std::atomic<int> nextSegment(0);
+
+    parallelFor(threadCount, [&](int) {
+        for (int i = nextSegment++; i < segments.size(); i = nextSegment++)
+            parts[i] = loadSegment(segments.at(i));
+    });
+
+    AnswerColumns columns;
+    std::size_t total = 0;
+    for (const AnswerColumns &part : parts)
+        total += part.size();
+    columns.questionId.reserve(total);
+    columns.player.reserve(total);
+    columns.answer.reserve(total);
+    columns.correct.reserve(total);
+    columns.latencyMs.reserve(total);
+
+    for (AnswerColumns &part : parts) {
+        columns.questionId.insert(columns.questionId.end(), part.questionId.begin(), part.questionId.end());
+        columns.player.insert(columns.player.end(), part.player.begin(), part.player.end());
+        columns.answer.insert(columns.answer.end(), part.answer.begin(), part.answer.end());
+        columns.correct.insert(columns.correct.end(), part.correct.begin(), part.correct.end());
+        columns.latencyMs.insert(columns.latencyMs.end(), part.latencyMs.begin(), part.latencyMs.end());
+        part = AnswerColumns();
+    }
+    return columns;
+}
+
+static std::size_t percentileRank(std::size_t count, double p)
+{
+    const std::size_t rank = std::size_t(std::ceil(p * double(count)));
+    return rank > 0 ? rank - 1 : 0;
+}
+
+static std::vector<QuestionStats> aggregate(const AnswerColumns &columns, int threadCount)
+{
+    const std::size_t rowCount = columns.size();
+
+    // Identifiants de question -> indices denses. Les réponses à une même
+    // question se suivent dans le journal : la dernière recherche sert souvent.
+    QHash<quint64, quint32> groupOf;
+    std::vector<quint64> groupIds;
+    std::vector<quint32> group(rowCount);
+    quint64 lastId = 0;
+    quint32 lastGroup = 0;
+    for (std::size_t i = 0; i < rowCount; ++i) {
+        const quint64 id = columns.questionId[i];
+        if (i == 0 || id != lastId) {
+            auto it = groupOf.constFind(id);
+            if (it == groupOf.constEnd()) {
+                it = groupOf.insert(id, quint32(groupIds.size()));
+                groupIds.push_back(id);
+            }
+            lastId = id;
+            lastGroup = it.value();
+        }
+        group[i] = lastGroup;
+    }
+    const std::size_t groupCount = groupIds.size();
+
+    // Passe 1 : compteurs par thread sur des tranches contiguës
+    auto sliceBegin = [&](int t) { return rowCount * std::size_t(t) / std::size_t(threadCount); };
+    std::vector<std::vector<quint64>> counts(threadCount, std::vector<quint64>(groupCount, 0));
+    std::vector<std::vector<quint64>> corrects(threadCount, std::vector<quint64>(groupCount, 0));
+    std::vector<std::vector<quint64>> answers(threadCount, std::vector<quint64>(groupCount * ANSWER_SLOTS, 0));
+
+    parallelFor(threadCount, [&](int t) {
+        quint64 *count = counts[t].data();
+        quint64 *correct = corrects[t].data();
+        quint64 *answer = answers[t].data();
+        const std::size_t end = sliceBegin(t + 1);
+        for (std::size_t i = sliceBegin(t); i < end; ++i) {
+            const quint32 g = group[i];
+            count[g]++;
+            correct[g] += columns.correct[i];
+            if (columns.answer[i] >= 0)
+                answer[g * ANSWER_SLOTS + columns.answer[i]]++;
+        }
+    });
+
+    // Décalages : latences regroupées par question, puis par thread
+    std::vector<std::vector<std::size_t>> offsets(threadCount, std::vector<std::size_t>(groupCount));
+    std::vector<std::size_t> groupStart(groupCount + 1, 0);
+    std::size_t offset = 0;
+    for (std::size_t g = 0; g < groupCount; ++g) {
+        groupStart[g] = offset;
+        for (int t = 0; t < threadCount; ++t) {
+            offsets[t][g] = offset;
+            offset += counts[t][g];
+        }
+    }
+    groupStart[groupCount] = offset;
+
+    // Passe 2 : répartition des latences, sans synchronisation
+    std::vector<quint32> latencies(rowCount);
+    parallelFor(threadCount, [&](int t) {
+        std::size_t *cursor = offsets[t].data();
+        const std::size_t end = sliceBegin(t + 1);
+        for (std::size_t i = sliceBegin(t); i < end; ++i)
+            latencies[cursor[group[i]]++] = columns.latencyMs[i];
+    });
+
+    // Passe 3 : réduction et percentiles, une question à la fois par thread
+    std::vector<QuestionStats> stats(groupCount);
+    std::atomic<std::size_t> nextGroup(0);
+    parallelFor(threadCount, [&](int) {
+        for (std::size_t g = nextGroup++; g < groupCount; g = nextGroup++) {
+            QuestionStats &s = stats[g];
+            s.questionId = groupIds[g];
+            for (int t = 0; t < threadCount; ++t) {
+                s.answers += counts[t][g];
+                s.correct += corrects[t][g];
+                for (int a = 0; a < ANSWER_SLOTS; ++a)
+                    s.answerCounts[a] += answers[t][g * ANSWER_SLOTS + a];
+            }
+            quint32 *first = latencies.data() + groupStart[g];
+            quint32 *last = latencies.data() + groupStart[g + 1];
+            const std::size_t count = std::size_t(last - first);
+            if (count == 0)
+                continue;
+            // Rangs croissants : chaque nth_element ne travaille que sur la plage restante
+            quint32 *p50 = first + percentileRank(count, 0.50);
+            quint32 *p90 = first + percentileRank(count, 0.90);
+            quint32 *p99 = first + percentileRank(count, 0.99);
+            std::nth_element(first, p50, last);
+            std::nth_element(p50, p90, last);
+            std::nth_element(p90, p99, last);
+            s.p50 = *p50;
+            s.p90 = *p90;
+            s.p99 = *p99;
+        }
+    });
+
+    // Score de difficulté 0..100 : précision lissée vers la moyenne globale
+    // (les questions peu jouées restent proches de la moyenne) + temps médian
+    quint64 totalAnswers = 0;
+    quint64 totalCorrect = 0;
+    for (const QuestionStats &s : stats) {
+        totalAnswers += s.answers;
+        totalCorrect += s.correct;
+    }
+    const double globalAccuracy = totalAnswers ? double(totalCorrect) / double(totalAnswers) : 0.5;
+    for (QuestionStats &s : stats) {
+        s.accuracy = s.answers ? double(s.correct) / double(s.answers) : 0.0;
+        const double smoothed = (double(s.correct) + PRIOR_WEIGHT * globalAccuracy) / (double(s.answers) + PRIOR_WEIGHT);
+        const double slowness = qMin(1.0, double(s.p50) / QUESTION_DURATION_MS);
+        s.difficulty = qRound(100.0 * (0.75 * (1.0 - smoothed) + 0.25 * slowness));
+    }
+
+    std::sort(stats.begin(), stats.end(), [](const QuestionStats &a, const QuestionStats &b) {
+        return a.difficulty != b.difficulty ? a.difficulty > b.difficulty : a.questionId < b.questionId;
+    });
+    return stats;
+}
+
+static QString csvField(const QString &value)
+{
+    QString escaped = value;
+    escaped.replace('"', "\"\"");
+    return '"' + escaped + '"';
+}
+
+static void writeCsv(QTextStream &out, const std::vector<QuestionStats> &stats,
+                     const QHash<quint64, Question> &questions)
+{
+    out << "question_id,question,answers,accuracy,wrong_0,wrong_1,wrong_2,wrong_3,"
+           "p50_ms,p90_ms,p99_ms,difficulty\n";
+    for (const QuestionStats &s : stats) {
+        const Question question = questions.value(s.questionId);
+        const int correctIndex = question.getCorrectAnswerIndex();
+        out << s.questionId << ',' << csvField(question.getQuestionText()) << ',' << s.answers << ','
+            << QString::number(s.accuracy, 'f', 4);
+        // Mauvaises réponses seulement : la bonne colonne reste vide
+        for (int a = 0; a < ANSWER_SLOTS; ++a) {
+            out << ',';
+            if (a != correctIndex)
+                out << s.answerCounts[a];
+        }
+        out << ',' << s.p50 << ',' << s.p90 << ',' << s.p99 << ',' << s.difficulty << '\n';
+    }
+}
+
+int main(int argc, char *argv[])
+{
+    QCoreApplication app(argc, argv);
+    QCoreApplication::setApplicationName("QuizzStats");
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription("Statistiques par question à partir du journal des parties");
+    parser.addHelpOption();
+    parser.addPositionalArgument("journal", "Dossier du journal (journal-*.qjl)");
+    QCommandLineOption csvOption({"o", "output"}, "Fichier CSV de sortie (défaut : sortie standard)", "file");
+    QCommandLineOption difficultyOption("difficulty", "Écrit les scores de difficulté (JSON id -> score)", "file");
+    QCommandLineOption threadsOption({"j", "threads"}, "Nombre de threads", "n");
+    QCommandLineOption bankOption({"b", "bank"}, "Banque jouée en plus des packs intégrés (répétable ; défaut : QUIZZ_BANKS)", "file");
+    parser.addOption(csvOption);
+    parser.addOption(difficultyOption);
+    parser.addOption(threadsOption);
+    parser.addOption(bankOption);
+    parser.process(app);
+
+    if (parser.positionalArguments().size() != 1)
+        parser.showHelp(1);
+
+    int threadCount = int(std::thread::hardware_concurrency());
+    if (parser.isSet(threadsOption))
+        threadCount = parser.value(threadsOption).toInt();
+    threadCount = qMax(1, threadCount);
+
+    QTextStream err(stderr);
+    QElapsedTimer clock;
+    clock.start();
+
+    // Mêmes banques que l'hôte (QuestionStore) : les questions jouées en viennent
+    QuestionBank bank;
+    bank.addBuiltinPacks();
+    QStringList bankFiles = parser.values(bankOption);
+    if (bankFiles.isEmpty())
+        bankFiles = qEnvironmentVariable("QUIZZ_BANKS").split(QDir::listSeparator(), Qt::SkipEmptyParts);
+    for (const QString &path : std::as_const(bankFiles)) {
+        QString error;
+        if (!bank.loadFile(path, &error)) {
+            err << error << '\n';
+            return 1;
+        }
+    }
+
+    const AnswerColumns columns = loadJournal(parser.positionalArguments().first(), threadCount);
+    const qint64 loadMs = clock.restart();
+    const std::vector<QuestionStats> stats = aggregate(columns, threadCount);
+    err << columns.size() << " réponses chargées en " << loadMs << " ms, "
+        << stats.size() << " questions agrégées en " << clock.elapsed() << " ms\n";
+
+    QHash<quint64, Question> questions;
+    questions.reserve(bank.size());
+    for (int id = 0; id < bank.size(); ++id) {
+        const Question &question = bank.entry(id).question;
+        questions.insert(question.getId(), question);
+    }
+
+    if (parser.isSet(csvOption)) {
+        QFile file(parser.value(csvOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+            err << "Impossible d'écrire " << file.fileName() << '\n';
+            return 1;
+        }
+        QTextStream out(&file);
+        writeCsv(out, stats, questions);
+    } else {
+        QTextStream out(stdout);
+        writeCsv(out, stats, questions);
+    }
+
+    if (parser.isSet(difficultyOption)) {
+        QJsonObject difficulties;
+        for (const QuestionStats &s : stats)
+            difficulties[QString::number(s.questionId)] = s.difficulty;
+        QFile file(parser.value(difficultyOption));
+        if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate)) {
+            err << "Impossible d'écrire " << file.fileName() << '\n';
+            return 1;
+        }
+        file.write(QJsonDocument(difficulties).toJson());
+    }
+
+    return 0;
+}
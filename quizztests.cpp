@@ -0,0 +1,326 @@
+// QuizzTests : structures de données de l'hôte, vérifiées contre un calcul
+// naïf (classement des équipes) ou contre leur contrat (sessions, seaux à
+// jetons, lecture des trames, dictionnaire de chaînes). Sans réseau ni
+// interface ; lancé par ctest.
+
+#include <QJsonDocument>
+#include <QRandomGenerator>
+#include <QTest>
+#include <algorithm>
+#include "clienttable.h"
+#include "framereader.h"
+#include "teamstandings.h"
+#include "wirestrings.h"
+
+// Rang attendu : 1 + équipes strictement devant ; ordre : score puis nom
+static void checkAgainstBruteForce(const TeamStandings &standings)
+{
+    QVector<TeamStandings::Standing> expected;
+    for (int id = 0; id < standings.size(); ++id) {
+        const TeamStandings::Team &team = standings.team(id);
+        int rank = 1;
+        for (int other = 0; other < standings.size(); ++other)
+            rank += standings.team(other).score > team.score;
+        QCOMPARE(standings.rank(id), rank);
+
+        TeamStandings::Standing row;
+        row.name = team.name;
+        row.score = team.score;
+        row.rank = rank;
+        expected.append(row);
+    }
+    std::sort(expected.begin(), expected.end(), [](const TeamStandings::Standing &a, const TeamStandings::Standing &b) {
+        return a.score != b.score ? a.score > b.score : a.name < b.name;
+    });
+
+    const QVector<TeamStandings::Standing> rows = standings.standings();
+    QCOMPARE(rows.size(), expected.size());
+    for (int i = 0; i < rows.size(); ++i) {
+        QCOMPARE(rows.at(i).name, expected.at(i).name);
+        QCOMPARE(rows.at(i).score, expected.at(i).score);
+        QCOMPARE(rows.at(i).rank, expected.at(i).rank);
+    }
+
+    const int limit = qMin(3, int(expected.size()));
+    QCOMPARE(int(standings.standings(limit).size()), limit);
+}
+
+class QuizzTests : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void teamStandingsMatchBruteForce();
+    void teamStandingsDeltas();
+    void teamStandingsRejectsInvalidDelta();
+    void tokenBucket();
+    void clientTableHandles();
+    void frameReaderTerminator();
+    void frameReaderFields();
+    void frameReaderCompact();
+    void wireStringsRoundTrip();
+};
+
+void QuizzTests::teamStandingsMatchBruteForce()
+{
+    QRandomGenerator random(26);
+    for (int trial = 0; trial < 40; ++trial) {
+        TeamStandings standings;
+        QHash<QString, QString> teamOf;         // joueur -> équipe, tenu à côté
+        QHash<QString, int> scores;             // équipe -> score attendu
+
+        for (int step = 0; step < 400; ++step) {
+            const QString player = QString("p%1").arg(random.bounded(40));
+            const int action = random.bounded(10);
+            if (action == 0 || !teamOf.contains(player)) {
+                const QString team = QString("T%1").arg(random.bounded(12));
+                QVERIFY(standings.addMember(player, team) >= 0);
+                teamOf.insert(player, team);
+                scores.insert(team, scores.value(team));
+            } else if (action == 1) {
+                standings.removeMember(player);
+                teamOf.remove(player);
+            } else {
+                const bool correct = random.bounded(3) != 0;
+                standings.credit(player, correct);
+                if (correct)
+                    ++scores[teamOf.value(player)];
+            }
+
+            QCOMPARE(standings.size(), int(scores.size()));
+            for (int id = 0; id < standings.size(); ++id)
+                QCOMPARE(standings.team(id).score, scores.value(standings.team(id).name));
+            checkAgainstBruteForce(standings);
+            if (QTest::currentTestFailed())
+                return;
+        }
+    }
+}
+
+void QuizzTests::teamStandingsDeltas()
+{
+    QRandomGenerator random(50);
+    TeamStandings host;
+    TeamStandings client;
+
+    for (int round = 0; round < 200; ++round) {
+        const QString player = QString("p%1").arg(random.bounded(30));
+        if (host.teamOf(player) < 0)
+            host.addMember(player, QString("T%1").arg(random.bounded(8)));
+        host.credit(player, random.bounded(2) == 0);
+        QVERIFY(client.applyDelta(host.takeDelta()));
+    }
+    for (int id = 0; id < host.size(); ++id)
+        QCOMPARE(client.team(id).score, host.team(id).score);
+    checkAgainstBruteForce(client);
+
+    // Saut trop grand pour monter point par point : paliers reconstruits
+    host.addMember("boost", host.team(0).name);
+    for (int i = 0; i < 5000; ++i)
+        host.credit("boost", true);
+    QVERIFY(client.applyDelta(host.takeDelta()));
+    QCOMPARE(client.team(0).score, host.team(0).score);
+    QCOMPARE(client.rank(0), 1);
+    checkAgainstBruteForce(client);
+
+    // Scores en baisse (autre partie reprise) : reconstruit aussi
+    TeamStandings::State lowered = host.state();
+    for (int &score : lowered.scores)
+        score /= 2;
+    lowered.scores[0] = 0;
+    TeamStandings restored;
+    restored.restore(lowered);
+    QVERIFY(client.applyDelta(restored.toJson()));
+    for (int id = 0; id < restored.size(); ++id)
+        QCOMPARE(client.team(id).score, restored.team(id).score);
+    checkAgainstBruteForce(client);
+
+    // Et les points suivants repartent du classement reconstruit
+    for (int i = 0; i < 50; ++i) {
+        const int id = random.bounded(restored.size());
+        const QString member = QString("m%1").arg(id);
+        restored.addMember(member, restored.team(id).name);
+        restored.credit(member, true);
+    }
+    QVERIFY(client.applyDelta(restored.takeDelta()));
+    checkAgainstBruteForce(client);
+}
+
+void QuizzTests::teamStandingsRejectsInvalidDelta()
+{
+    TeamStandings standings;
+    standings.addMember("a", "Rouge");
+    standings.credit("a", true);
+
+    // Id non contigu, nom manquant, nom en double : rien n'est appliqué
+    QVERIFY(!standings.applyDelta(QJsonArray{QJsonArray{0, 5, 5, 1}, QJsonArray{2, 0, 0, 0, "Bleu"}}));
+    QVERIFY(!standings.applyDelta(QJsonArray{QJsonArray{1, 0, 0, 0}}));
+    QVERIFY(!standings.applyDelta(QJsonArray{QJsonArray{1, 0, 0, 0, "Vert"}, QJsonArray{2, 0, 0, 0, "Vert"}}));
+    QVERIFY(!standings.applyDelta(QJsonArray{QJsonArray{0, -1, 0, 0}}));
+    QCOMPARE(standings.size(), 1);
+    QCOMPARE(standings.team(0).score, 1);
+}
+
+void QuizzTests::tokenBucket()
+{
+    TokenBucket bucket;
+    // Plein au premier usage : la rafale passe, puis plus rien
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(bucket.take(10.0, 3.0, 0));
+    QVERIFY(!bucket.take(10.0, 3.0, 0));
+
+    // 10 par seconde : un jeton toutes les 100 ms
+    QVERIFY(!bucket.take(10.0, 3.0, 50));
+    QVERIFY(bucket.take(10.0, 3.0, 150));
+    QVERIFY(!bucket.take(10.0, 3.0, 150));
+
+    // Jamais plus que la rafale, même après une longue pause
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(bucket.take(10.0, 3.0, 60000));
+    QVERIFY(!bucket.take(10.0, 3.0, 60000));
+}
+
+void QuizzTests::clientTableHandles()
+{
+    ClientTable table;
+    const ClientHandle first = table.insert(10);
+    const ClientHandle second = table.insert(11);
+    QCOMPARE(table.size(), 2);
+    QVERIFY(!first.isNull());
+    QCOMPARE(table.find(first)->descriptor, 10);
+    QCOMPARE(ClientHandle::fromClientId(second.clientId()).key(), second.key());
+    QCOMPARE(ClientHandle::fromKey(second.key()).key(), second.key());
+    QVERIFY(ClientHandle::fromClientId("client_x").isNull());
+    QVERIFY(ClientHandle::fromClientId("other_1").isNull());
+
+    // Case réutilisée : l'ancienne poignée ne la retrouve plus
+    table.remove(first);
+    QCOMPARE(table.size(), 1);
+    QVERIFY(!table.find(first));
+    const ClientHandle reused = table.insert(12);
+    QCOMPARE(reused.index, first.index);
+    QVERIFY(reused.generation != first.generation);
+    QVERIFY(!table.find(first));
+    QCOMPARE(table.find(reused)->descriptor, 12);
+    table.remove(first);                    // périmée : sans effet
+    QCOMPARE(table.size(), 2);
+
+    table.find(second)->spectator = true;
+    QCOMPARE(table.spectatorCount(), 1);
+    int visited = 0;
+    table.forEach([&visited](ClientHandle, const ClientSlot &slot) {
+        visited += slot.isLive();
+    });
+    QCOMPARE(visited, 2);
+
+    // clear() garde les générations : aucune poignée ne redevient valable
+    table.clear();
+    QCOMPARE(table.size(), 0);
+    const ClientHandle afterClear = table.insert(13);
+    QVERIFY(!table.find(reused));
+    QVERIFY(!table.find(second));
+    QVERIFY(table.find(afterClear));
+}
+
+void QuizzTests::frameReaderTerminator()
+{
+    // Toutes les positions autour des blocs de 16 octets, avec un second '\n' derrière
+    for (int size = 0; size <= 80; ++size) {
+        for (int position = -1; position < size; ++position) {
+            QByteArray buffer(size, 'a');
+            if (position >= 0) {
+                buffer[position] = '\n';
+                if (position + 3 < size)
+                    buffer[position + 3] = '\n';
+            }
+            QCOMPARE(FrameReader::findTerminator(buffer.constData(), buffer.size()), qsizetype(position));
+        }
+    }
+}
+
+void QuizzTests::frameReaderFields()
+{
+    FrameReader::Fields fields;
+    QVERIFY(FrameReader::read(R"({"type":"answer","data":{"playerName":"Ana","answer":2}})", &fields));
+    QCOMPARE(fields.type.toByteArray(), QByteArray("answer"));
+    QVERIFY(fields.hasPlayerName);
+    QCOMPARE(fields.playerName.toByteArray(), QByteArray("Ana"));
+    QVERIFY(fields.hasAnswer);
+    QCOMPARE(fields.answer, 2);
+
+    // Nom échappé ou réponse non entière : laissés à QJsonDocument
+    fields = FrameReader::Fields();
+    QVERIFY(FrameReader::read(R"({"type":"answer","data":{"playerName":"An\u0061","answer":1.5}})", &fields));
+    QVERIFY(!fields.hasPlayerName);
+    QVERIFY(!fields.hasAnswer);
+
+    fields = FrameReader::Fields();
+    QVERIFY(!FrameReader::read(R"({"type":"answer","data":{)", &fields));
+    fields = FrameReader::Fields();
+    QVERIFY(!FrameReader::read("42", &fields));
+}
+
+void QuizzTests::frameReaderCompact()
+{
+    FrameReader::Fields fields;
+    QVERIFY(FrameReader::read(R"({"type":"answer","data":{"playerName":"Ana","answer":2}})", &fields));
+    QVERIFY(!fields.compact);
+
+    // Trame compacte : le nom passe en clair la première fois, puis par son numéro
+    WireStrings sender;
+    const QJsonObject answer{{"type", "answer"}, {"sender", "Ana"},
+                             {"data", QJsonObject{{"playerName", "Ana"}, {"answer", 3}}}};
+    const QByteArray firstFrame = sender.encode(answer);
+    QVERIFY(!firstFrame.isEmpty());
+    fields = FrameReader::Fields();
+    QVERIFY(FrameReader::read(firstFrame, &fields));
+    QVERIFY(fields.compact);
+    QCOMPARE(fields.typeId, int(WireStrings::ANSWER));
+    QVERIFY(fields.definesName);
+
+    fields = FrameReader::Fields();
+    QVERIFY(FrameReader::read(sender.encode(answer), &fields));
+    QVERIFY(fields.compact);
+    QVERIFY(!fields.definesName);
+    QCOMPARE(fields.senderId, 0);
+    QCOMPARE(fields.playerNameId, 0);
+    QVERIFY(fields.hasAnswer);
+    QCOMPARE(fields.answer, 3);
+}
+
+void QuizzTests::wireStringsRoundTrip()
+{
+    WireStrings sender;
+    WireStrings receiver;
+    const QJsonObject join{{"type", "join_game"}, {"sender", "Ana"},
+                           {"data", QJsonObject{{"playerName", "Ana"}, {"gameCode", "123456"}, {"7x", 1}}}};
+    const QJsonObject custom{{"type", "asset_request"}, {"sender", "Ana"},
+                             {"data", QJsonObject{{"~key", true}, {"assets", QJsonArray{1, 2}}}}};
+
+    for (const QJsonObject &message : {join, custom, join}) {
+        const QByteArray frame = sender.encode(message);
+        QVERIFY(!frame.isEmpty());
+        QJsonObject decoded;
+        QVERIFY(receiver.decode(frame, &decoded));
+        QCOMPARE(decoded, message);
+    }
+    QCOMPARE(receiver.names(), QStringList{"Ana"});
+
+    // Hors du format de GameSession : pas de trame compacte
+    QVERIFY(sender.encode(QJsonObject{{"type", "hello"}, {"extra", 1}}).isEmpty());
+
+    // Numéro de nom jamais défini sur cette connexion
+    QJsonObject decoded;
+    QVERIFY(!WireStrings().decode("[5,0]", &decoded));
+    QVERIFY(!receiver.decode("[5,1]", &decoded));
+
+    // Passage de relais : le successeur comprend les numéros déjà donnés
+    WireStrings successor;
+    successor.restore(receiver.names());
+    QVERIFY(successor.decode(sender.encode(join), &decoded));
+    QCOMPARE(decoded, join);
+}
+
+QTEST_APPLESS_MAIN(QuizzTests)
+
+#include "quizztests.moc"
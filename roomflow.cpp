@@ -0,0 +1,54 @@
+#include "roomflow.h"
+
+void RoomWaker::Awaiter::await_suspend(std::coroutine_handle<RoomTask::promise_type> handle)
+{
+    handle.promise().running = false;
+    waker->waiting = handle;
+    if (deadlineMs >= 0) {
+        RoomWaker *target = waker;
+        waker->timer = waker->clock->schedule(deadlineMs - waker->clock->nowMs(), [target]() {
+            target->timer = 0;
+            target->wake(DEADLINE);
+        });
+    }
+}
+
+RoomWaker::Reason RoomWaker::Awaiter::await_resume() const
+{
+    return waker->reason;
+}
+
+RoomWaker::RoomWaker(GameClock *clock)
+    : clock(clock), timer(0), reason(EVENT)
+{
+}
+
+RoomWaker::~RoomWaker()
+{
+    cancel();
+}
+
+void RoomWaker::notify()
+{
+    wake(EVENT);
+}
+
+void RoomWaker::cancel()
+{
+    clock->cancel(timer);
+    timer = 0;
+    waiting = {};
+}
+
+void RoomWaker::wake(Reason why)
+{
+    if (!waiting)
+        return;
+
+    clock->cancel(timer);
+    timer = 0;
+    reason = why;
+    const auto handle = std::exchange(waiting, {});
+    handle.promise().running = true;
+    handle.resume();
+}
@@ -0,0 +1,114 @@
+#ifndef ROOMFLOW_H
+#define ROOMFLOW_H
+
+#include <coroutine>
+#include <exception>
+#include <utility>
+#include "gameclock.h"
+
+// Déroulé d'une salle écrit comme une coroutine (voir Game::playRounds) :
+// démarre aussitôt, s'exécute jusqu'à sa première attente puis n'existe plus
+// que sous forme de cadre suspendu. Le RoomTask possède ce cadre.
+class RoomTask
+{
+public:
+    struct promise_type
+    {
+        bool running = true;        // faux tant que le cadre est suspendu
+        bool detached = false;      // lâché en cours d'exécution : se détruit à la fin
+
+        struct FinalAwaiter
+        {
+            bool await_ready() noexcept { return false; }
+            bool await_suspend(std::coroutine_handle<promise_type> handle) noexcept
+            {
+                handle.promise().running = false;
+                return !handle.promise().detached;
+            }
+            void await_resume() noexcept {}
+        };
+
+        RoomTask get_return_object() { return RoomTask(std::coroutine_handle<promise_type>::from_promise(*this)); }
+        std::suspend_never initial_suspend() noexcept { return {}; }
+        FinalAwaiter final_suspend() noexcept { return {}; }
+        void return_void() {}
+        void unhandled_exception() { std::terminate(); }
+    };
+
+    RoomTask() = default;
+    RoomTask(RoomTask &&other) noexcept : handle(std::exchange(other.handle, {})) {}
+    RoomTask &operator=(RoomTask &&other) noexcept
+    {
+        if (this != &other) {
+            reset();
+            handle = std::exchange(other.handle, {});
+        }
+        return *this;
+    }
+    RoomTask(const RoomTask &) = delete;
+    RoomTask &operator=(const RoomTask &) = delete;
+    ~RoomTask() { reset(); }
+
+    bool isRunning() const { return handle && !handle.done(); }
+
+    // Détruit le cadre ; appelé depuis la coroutine elle-même (slot connecté à
+    // un de ses signaux), il est seulement lâché et la coroutine doit se
+    // terminer avant sa prochaine attente
+    void reset()
+    {
+        if (!handle)
+            return;
+        if (handle.promise().running)
+            handle.promise().detached = true;
+        else
+            handle.destroy();
+        handle = {};
+    }
+
+private:
+    explicit RoomTask(std::coroutine_handle<promise_type> handle) : handle(handle) {}
+
+    std::coroutine_handle<promise_type> handle;
+};
+
+// Point d'attente d'une salle : « échéance ou événement », sur l'échéancier
+// partagé de GameClock. Une seule coroutine attend à la fois ; notify() la
+// réveille, à elle de revérifier ce qu'elle attend.
+class RoomWaker
+{
+public:
+    enum Reason {
+        DEADLINE,
+        EVENT
+    };
+
+    struct Awaiter
+    {
+        RoomWaker *waker;
+        qint64 deadlineMs;          // < 0 : pas d'échéance
+
+        bool await_ready() const { return false; }
+        void await_suspend(std::coroutine_handle<RoomTask::promise_type> handle);
+        Reason await_resume() const;
+    };
+
+    explicit RoomWaker(GameClock *clock);
+    ~RoomWaker();
+
+    Awaiter until(qint64 deadlineMs) { return Awaiter{this, deadlineMs}; }
+    Awaiter event() { return Awaiter{this, -1}; }
+
+    bool isWaiting() const { return bool(waiting); }
+    void notify();
+    void cancel();          // oublie l'attente sans reprendre la coroutine
+
+private:
+    void wake(Reason why);
+
+    GameClock *clock;
+    std::coroutine_handle<RoomTask::promise_type> waiting;
+    int timer;
+    Reason reason;
+};
+
+#endif // ROOMFLOW_H
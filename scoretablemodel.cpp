@@ -0,0 +1,272 @@
+#include "scoretablemodel.h"
+#include <algorithm>
+
+// Au-delà de ce nombre de changements, un tri global coûte moins cher
+// qu'une suite de déplacements de lignes.
+static const int BULK_THRESHOLD = 32;
+
+ScoreTableModel::ScoreTableModel(QObject *parent)
+    : QAbstractTableModel(parent)
+{
+}
+
+int ScoreTableModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : entries.size();
+}
+
+int ScoreTableModel::columnCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : COLUMN_COUNT;
+}
+
+QVariant ScoreTableModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= entries.size())
+        return QVariant();
+
+    const Entry &entry = entries.at(index.row());
+
+    if (role == Qt::DisplayRole) {
+        switch (index.column()) {
+        case RANK_COLUMN:
+            return ranks.value(index.row(), index.row() + 1);
+        case NAME_COLUMN:
+            return entry.name;
+        case SCORE_COLUMN:
+            return QString("%1 points").arg(entry.score);
+        }
+    } else if (role == Qt::TextAlignmentRole && index.column() != NAME_COLUMN) {
+        return int(Qt::AlignCenter);
+    }
+
+    return QVariant();
+}
+
+QVariant ScoreTableModel::headerData(int section, Qt::Orientation orientation, int role) const
+{
+    if (orientation != Qt::Horizontal || role != Qt::DisplayRole)
+        return QVariant();
+
+    switch (section) {
+    case RANK_COLUMN:
+        return QString("#");
+    case NAME_COLUMN:
+        return QString("Joueur");
+    case SCORE_COLUMN:
+        return QString("Score");
+    }
+    return QVariant();
+}
+
+void ScoreTableModel::setScores(const QMap<QString, int> &scores)
+{
+    QStringList removed;
+    int added = 0;
+    int changed = 0;
+
+    for (const Entry &entry : entries) {
+        if (!scores.contains(entry.name))
+            removed.append(entry.name);
+    }
+    for (auto it = scores.begin(); it != scores.end(); ++it) {
+        auto row = rowOf.constFind(it.key());
+        if (row == rowOf.constEnd())
+            ++added;
+        else if (entries.at(row.value()).score != it.value())
+            ++changed;
+    }
+
+    if (removed.isEmpty() && added == 0 && changed == 0)
+        return;
+
+    if (removed.size() + added + changed <= BULK_THRESHOLD) {
+        for (const QString &name : removed)
+            removePlayer(name);
+        for (auto it = scores.begin(); it != scores.end(); ++it) {
+            auto row = rowOf.constFind(it.key());
+            if (row == rowOf.constEnd() || entries.at(row.value()).score != it.value())
+                setScore(it.key(), it.value());
+        }
+        return;
+    }
+
+    if (!removed.isEmpty() || added > 0) {
+        // Remplissage initial ou roster très différent : on repart de zéro
+        beginResetModel();
+        entries.clear();
+        entries.reserve(scores.size());
+        for (auto it = scores.begin(); it != scores.end(); ++it)
+            entries.append({it.key(), it.value()});
+        std::stable_sort(entries.begin(), entries.end(), &ScoreTableModel::lessThan);
+        rowOf.clear();
+        reindex(0, entries.size() - 1);
+        recomputeRanks();
+        endResetModel();
+        return;
+    }
+
+    for (auto it = scores.begin(); it != scores.end(); ++it)
+        entries[rowOf.value(it.key())].score = it.value();
+    resortAll();
+}
+
+void ScoreTableModel::setScore(const QString &playerName, int score)
+{
+    auto found = rowOf.constFind(playerName);
+
+    if (found == rowOf.constEnd()) {
+        Entry entry{playerName, score};
+        const int row = insertionRow(entry, -1);
+        beginInsertRows(QModelIndex(), row, row);
+        entries.insert(row, entry);
+        ranks.insert(row, 0);
+        reindex(row, entries.size() - 1);
+        // Les lignes décalées changent de rang (sauf ex aequo) : jusqu'au bout
+        const int last = updateRanks(row, entries.size() - 1);
+        endInsertRows();
+        emitRanksChanged(row + 1, last);
+    } else {
+        const int from = found.value();
+        if (entries.at(from).score == score)
+            return;
+
+        entries[from].score = score;
+        const int to = insertionRow(entries.at(from), from);
+        moveEntry(from, to);
+        // Hors de [from, to], seules les lignes ex aequo juste en dessous peuvent changer
+        const int first = qMin(from, to);
+        const int last = updateRanks(first, qMin(qMax(from, to) + 1, int(entries.size()) - 1));
+        emit dataChanged(index(to, SCORE_COLUMN), index(to, SCORE_COLUMN));
+        emitRanksChanged(first, last);
+    }
+}
+
+void ScoreTableModel::removePlayer(const QString &playerName)
+{
+    auto found = rowOf.find(playerName);
+    if (found == rowOf.end())
+        return;
+
+    const int row = found.value();
+    beginRemoveRows(QModelIndex(), row, row);
+    entries.removeAt(row);
+    ranks.removeAt(row);
+    rowOf.erase(found);
+    reindex(row, entries.size() - 1);
+    const int last = updateRanks(row, entries.size() - 1);
+    endRemoveRows();
+    emitRanksChanged(row, last);
+}
+
+void ScoreTableModel::clear()
+{
+    if (entries.isEmpty())
+        return;
+
+    beginResetModel();
+    entries.clear();
+    rowOf.clear();
+    ranks.clear();
+    endResetModel();
+}
+
+QString ScoreTableModel::leader() const
+{
+    return entries.isEmpty() ? QString() : entries.first().name;
+}
+
+bool ScoreTableModel::lessThan(const Entry &a, const Entry &b)
+{
+    if (a.score != b.score)
+        return a.score > b.score;
+    return a.name < b.name;
+}
+
+int ScoreTableModel::insertionRow(const Entry &entry, int ignoreRow) const
+{
+    // Sans la ligne ignoreRow le vecteur est trié : on cherche dans les deux moitiés
+    auto countBefore = [&entry](QVector<Entry>::const_iterator first,
+                                QVector<Entry>::const_iterator last) {
+        return int(std::lower_bound(first, last, entry, &ScoreTableModel::lessThan) - first);
+    };
+
+    if (ignoreRow < 0)
+        return countBefore(entries.cbegin(), entries.cend());
+
+    return countBefore(entries.cbegin(), entries.cbegin() + ignoreRow)
+         + countBefore(entries.cbegin() + ignoreRow + 1, entries.cend());
+}
+
+void ScoreTableModel::moveEntry(int from, int to)
+{
+    if (from == to)
+        return;
+
+    const int destination = (to < from) ? to : to + 1;
+    beginMoveRows(QModelIndex(), from, from, QModelIndex(), destination);
+    entries.move(from, to);
+    reindex(qMin(from, to), qMax(from, to));
+    endMoveRows();
+}
+
+void ScoreTableModel::reindex(int first, int last)
+{
+    for (int i = first; i <= last; ++i)
+        rowOf[entries.at(i).name] = i;
+}
+
+void ScoreTableModel::recomputeRanks()
+{
+    ranks.resize(entries.size());
+    for (int i = 0; i < entries.size(); ++i) {
+        if (i > 0 && entries.at(i).score == entries.at(i - 1).score)
+            ranks[i] = ranks.at(i - 1);
+        else
+            ranks[i] = i + 1;
+    }
+}
+
+int ScoreTableModel::updateRanks(int first, int last)
+{
+    // Les lignes avant first gardent leur rang. Après last, les lignes n'ont pas
+    // bougé : au premier rang inchangé, tout ce qui suit l'est aussi.
+    int row = first;
+    for (; row < entries.size(); ++row) {
+        const int rank = (row > 0 && entries.at(row).score == entries.at(row - 1).score) ? ranks.at(row - 1)
+                                                                                        : row + 1;
+        if (row > last && rank == ranks.at(row))
+            break;
+        ranks[row] = rank;
+    }
+    return row - 1;
+}
+
+void ScoreTableModel::emitRanksChanged(int first, int last)
+{
+    if (first <= last)
+        emit dataChanged(index(first, RANK_COLUMN), index(last, RANK_COLUMN));
+}
+
+void ScoreTableModel::resortAll()
+{
+    emit layoutAboutToBeChanged({}, QAbstractItemModel::VerticalSortHint);
+
+    const QModelIndexList oldIndexes = persistentIndexList();
+    QStringList oldNames;
+    oldNames.reserve(oldIndexes.size());
+    for (const QModelIndex &idx : oldIndexes)
+        oldNames.append(entries.at(idx.row()).name);
+
+    std::stable_sort(entries.begin(), entries.end(), &ScoreTableModel::lessThan);
+    reindex(0, entries.size() - 1);
+    recomputeRanks();
+
+    QModelIndexList newIndexes;
+    newIndexes.reserve(oldIndexes.size());
+    for (int i = 0; i < oldIndexes.size(); ++i)
+        newIndexes.append(index(rowOf.value(oldNames.at(i)), oldIndexes.at(i).column()));
+    changePersistentIndexList(oldIndexes, newIndexes);
+
+    emit layoutChanged({}, QAbstractItemModel::VerticalSortHint);
+}
@@ -0,0 +1,57 @@
+#ifndef SCORETABLEMODEL_H
+#define SCORETABLEMODEL_H
+
+#include <QAbstractTableModel>
+#include <QVector>
+#include <QHash>
+#include <QMap>
+
+// Leaderboard sorted by score (desc) then name. Score changes are applied
+// as row moves; large batches fall back to a single layout change.
+class ScoreTableModel : public QAbstractTableModel
+{
+    Q_OBJECT
+
+public:
+    enum Column {
+        RANK_COLUMN = 0,
+        NAME_COLUMN = 1,
+        SCORE_COLUMN = 2,
+        COLUMN_COUNT = 3
+    };
+
+    explicit ScoreTableModel(QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    int columnCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+    QVariant headerData(int section, Qt::Orientation orientation, int role = Qt::DisplayRole) const override;
+
+    void setScores(const QMap<QString, int> &scores);
+    void setScore(const QString &playerName, int score);
+    void removePlayer(const QString &playerName);
+    void clear();
+
+    QString leader() const;
+
+private:
+    struct Entry {
+        QString name;
+        int score;
+    };
+
+    QVector<Entry> entries;
+    QHash<QString, int> rowOf;
+    QVector<int> ranks;   // rang "compétition" (1, 1, 3, ...) par ligne
+
+    static bool lessThan(const Entry &a, const Entry &b);
+    int insertionRow(const Entry &entry, int ignoreRow) const;
+    void moveEntry(int from, int to);
+    void reindex(int first, int last);
+    void recomputeRanks();
+    int updateRanks(int first, int last);   // dernière ligne recalculée
+    void emitRanksChanged(int first, int last);
+    void resortAll();
+};
+
+#endif // SCORETABLEMODEL_H
@@ -0,0 +1,343 @@
+#include "sockethandoff.h"
+#include <QDataStream>
+#include <QSocketNotifier>
+#include <QDebug>
+
+#ifdef Q_OS_LINUX
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstddef>
+#include <cstring>
+#endif
+
+// Enregistrements SOCK_SEQPACKET : un octet de type puis la charge
+enum RecordType : char {
+    RECORD_FDS = 1,         // descripteurs seuls (écoute d'abord, puis connexions)
+    RECORD_DATA = 2,        // tranche des métadonnées sérialisées
+    RECORD_END = 3
+};
+
+static constexpr int MAX_FDS_PER_RECORD = 64;
+static constexpr int DATA_CHUNK_SIZE = 32 * 1024;
+static constexpr int SEND_TIMEOUT_S = 5;
+
+#ifdef Q_OS_LINUX
+static socklen_t handoffAddress(quint16 port, sockaddr_un *address)
+{
+    // Espace de noms abstrait : rien à nettoyer sur disque après un arrêt brutal
+    const QByteArray name = "quizzgame-handoff-" + QByteArray::number(port);
+    std::memset(address, 0, sizeof(*address));
+    address->sun_family = AF_UNIX;
+    std::memcpy(address->sun_path + 1, name.constData(), name.size());
+    return socklen_t(offsetof(sockaddr_un, sun_path) + 1 + name.size());
+}
+
+static bool sendRecord(int fd, char type, const char *data, int size, const int *fds, int fdCount)
+{
+    QByteArray record(1 + size, Qt::Uninitialized);
+    record[0] = type;
+    if (size > 0)
+        std::memcpy(record.data() + 1, data, size);
+
+    iovec iov;
+    iov.iov_base = record.data();
+    iov.iov_len = size_t(record.size());
+    msghdr message;
+    std::memset(&message, 0, sizeof(message));
+    message.msg_iov = &iov;
+    message.msg_iovlen = 1;
+
+    QByteArray control;
+    if (fdCount > 0) {
+        control.fill(0, qsizetype(CMSG_SPACE(sizeof(int) * fdCount)));
+        message.msg_control = control.data();
+        message.msg_controllen = size_t(control.size());
+        cmsghdr *header = CMSG_FIRSTHDR(&message);
+        header->cmsg_level = SOL_SOCKET;
+        header->cmsg_type = SCM_RIGHTS;
+        header->cmsg_len = CMSG_LEN(sizeof(int) * fdCount);
+        std::memcpy(CMSG_DATA(header), fds, sizeof(int) * fdCount);
+    }
+
+    ssize_t sent;
+    do {
+        sent = ::sendmsg(fd, &message, MSG_NOSIGNAL);
+    } while (sent < 0 && errno == EINTR);
+    return sent == ssize_t(record.size());
+}
+#endif
+
+SocketHandoff::SocketHandoff(QObject *parent)
+    : QObject(parent), listenerFd(-1), peerFd(-1), requester(false),
+      listenerNotifier(nullptr), peerNotifier(nullptr)
+{
+}
+
+SocketHandoff::~SocketHandoff()
+{
+    close();
+}
+
+void SocketHandoff::closeDescriptors(const Bundle &bundle)
+{
+#ifdef Q_OS_LINUX
+    if (bundle.listenerDescriptor >= 0)
+        ::close(bundle.listenerDescriptor);
+    for (const Connection &connection : bundle.connections) {
+        if (connection.descriptor >= 0)
+            ::close(connection.descriptor);
+    }
+#else
+    Q_UNUSED(bundle);
+#endif
+}
+
+bool SocketHandoff::listen(quint16 port)
+{
+    close();
+#ifdef Q_OS_LINUX
+    listenerFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+    sockaddr_un address;
+    const socklen_t length = handoffAddress(port, &address);
+    if (listenerFd < 0 || ::bind(listenerFd, reinterpret_cast<sockaddr *>(&address), length) != 0
+        || ::listen(listenerFd, 1) != 0) {
+        qWarning() << "Handoff socket not available:" << strerror(errno);
+        close();
+        return false;
+    }
+
+    listenerNotifier = new QSocketNotifier(listenerFd, QSocketNotifier::Read, this);
+    connect(listenerNotifier, &QSocketNotifier::activated, this, &SocketHandoff::onListenerReadable);
+    return true;
+#else
+    Q_UNUSED(port);
+    return false;
+#endif
+}
+
+void SocketHandoff::close()
+{
+    closePeer();
+    closeListener();
+}
+
+void SocketHandoff::closeListener()
+{
+#ifdef Q_OS_LINUX
+    delete listenerNotifier;
+    listenerNotifier = nullptr;
+    if (listenerFd >= 0)
+        ::close(listenerFd);
+    listenerFd = -1;
+#endif
+}
+
+void SocketHandoff::closePeer()
+{
+#ifdef Q_OS_LINUX
+    delete peerNotifier;
+    peerNotifier = nullptr;
+    if (peerFd >= 0)
+        ::close(peerFd);
+    peerFd = -1;
+    for (int fd : std::as_const(receivedFds))
+        ::close(fd);
+#endif
+    receivedFds.clear();
+    receivedData.clear();
+}
+
+void SocketHandoff::onListenerReadable()
+{
+#ifdef Q_OS_LINUX
+    const int fd = ::accept4(listenerFd, nullptr, nullptr, SOCK_CLOEXEC);
+    if (fd < 0)
+        return;
+
+    // Sockets et état de partie : seul un processus du même utilisateur les reçoit
+    ucred credentials;
+    socklen_t length = sizeof(credentials);
+    if (peerFd >= 0 || ::getsockopt(fd, SOL_SOCKET, SO_PEERCRED, &credentials, &length) != 0
+        || credentials.uid != ::getuid()) {
+        ::close(fd);
+        return;
+    }
+
+    peerFd = fd;
+    requester = false;
+    peerNotifier = new QSocketNotifier(peerFd, QSocketNotifier::Read, this);
+    connect(peerNotifier, &QSocketNotifier::activated, this, &SocketHandoff::onPeerReadable);
+    qDebug() << "Handoff requested by process" << credentials.pid;
+    emit handoffRequested();
+#endif
+}
+
+bool SocketHandoff::send(const Bundle &bundle, QString *error)
+{
+#ifdef Q_OS_LINUX
+    if (peerFd < 0) {
+        *error = "no successor waiting";
+        return false;
+    }
+
+    // Libère le nom tout de suite : le successeur l'écoutera à son tour
+    closeListener();
+
+    const timeval timeout = {SEND_TIMEOUT_S, 0};
+    ::setsockopt(peerFd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+
+    QVector<int> fds;
+    fds.reserve(1 + bundle.connections.size());
+    fds.append(bundle.listenerDescriptor);
+    for (const Connection &connection : bundle.connections)
+        fds.append(connection.descriptor);
+
+    QByteArray data;
+    {
+        QDataStream out(&data, QIODevice::WriteOnly);
+        out.setVersion(QDataStream::Qt_6_0);
+        out << qint32(bundle.connections.size());
+        for (const Connection &connection : bundle.connections)
+            out << connection.clientId << connection.spectator << connection.compressed << connection.interned
+                << connection.strings << connection.pendingInput;
+        out << bundle.state;
+    }
+
+    bool ok = true;
+    for (int i = 0; ok && i < fds.size(); i += MAX_FDS_PER_RECORD)
+        ok = sendRecord(peerFd, RECORD_FDS, nullptr, 0, fds.constData() + i, qMin<int>(MAX_FDS_PER_RECORD, fds.size() - i));
+    for (int i = 0; ok && i < data.size(); i += DATA_CHUNK_SIZE)
+        ok = sendRecord(peerFd, RECORD_DATA, data.constData() + i, qMin<int>(DATA_CHUNK_SIZE, data.size() - i), nullptr, 0);
+    if (ok)
+        ok = sendRecord(peerFd, RECORD_END, nullptr, 0, nullptr, 0);
+
+    if (!ok)
+        *error = QString::fromLocal8Bit(strerror(errno));
+    closePeer();
+    return ok;
+#else
+    Q_UNUSED(bundle);
+    *error = "socket handoff requires Linux";
+    return false;
+#endif
+}
+
+bool SocketHandoff::request(quint16 port, QString *error)
+{
+    close();
+#ifdef Q_OS_LINUX
+    peerFd = ::socket(AF_UNIX, SOCK_SEQPACKET | SOCK_CLOEXEC, 0);
+    sockaddr_un address;
+    const socklen_t length = handoffAddress(port, &address);
+    if (peerFd < 0 || ::connect(peerFd, reinterpret_cast<sockaddr *>(&address), length) != 0) {
+        *error = QString("no running host on port %1: %2").arg(port).arg(QString::fromLocal8Bit(strerror(errno)));
+        closePeer();
+        return false;
+    }
+
+    requester = true;
+    peerNotifier = new QSocketNotifier(peerFd, QSocketNotifier::Read, this);
+    connect(peerNotifier, &QSocketNotifier::activated, this, &SocketHandoff::onPeerReadable);
+    return true;
+#else
+    Q_UNUSED(port);
+    *error = "socket handoff requires Linux";
+    return false;
+#endif
+}
+
+void SocketHandoff::onPeerReadable()
+{
+#ifdef Q_OS_LINUX
+    if (!requester) {
+        // Côté hôte, le successeur n'envoie rien : lisible = il a abandonné
+        qDebug() << "Handoff request cancelled";
+        closePeer();
+        emit requestCancelled();
+        return;
+    }
+
+    QByteArray buffer(1 + DATA_CHUNK_SIZE, Qt::Uninitialized);
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(int) * MAX_FDS_PER_RECORD)];
+
+    for (;;) {
+        iovec iov;
+        iov.iov_base = buffer.data();
+        iov.iov_len = size_t(buffer.size());
+        msghdr message;
+        std::memset(&message, 0, sizeof(message));
+        message.msg_iov = &iov;
+        message.msg_iovlen = 1;
+        message.msg_control = control;
+        message.msg_controllen = sizeof(control);
+
+        const ssize_t size = ::recvmsg(peerFd, &message, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+        if (size < 0 && errno == EINTR)
+            continue;
+        if (size < 0 && (errno == EAGAIN || errno == EWOULDBLOCK))
+            return;
+
+        // Descripteurs reçus d'abord : ils doivent être fermés même en cas d'erreur
+        for (cmsghdr *header = CMSG_FIRSTHDR(&message); header; header = CMSG_NXTHDR(&message, header)) {
+            if (header->cmsg_level == SOL_SOCKET && header->cmsg_type == SCM_RIGHTS) {
+                const int count = int((header->cmsg_len - CMSG_LEN(0)) / sizeof(int));
+                const int *fds = reinterpret_cast<const int *>(CMSG_DATA(header));
+                for (int i = 0; i < count; ++i)
+                    receivedFds.append(fds[i]);
+            }
+        }
+
+        if (size <= 0) {
+            fail(size == 0 ? QString("host closed the handoff") : QString::fromLocal8Bit(strerror(errno)));
+            return;
+        }
+        if (message.msg_flags & (MSG_TRUNC | MSG_CTRUNC)) {
+            fail("truncated handoff record");
+            return;
+        }
+
+        const char type = buffer.at(0);
+        if (type == RECORD_DATA) {
+            receivedData.append(buffer.constData() + 1, size - 1);
+        } else if (type == RECORD_END) {
+            Bundle bundle;
+            qint32 count = -1;
+            QDataStream in(receivedData);
+            in.setVersion(QDataStream::Qt_6_0);
+            in >> count;
+            if (in.status() != QDataStream::Ok || count < 0 || receivedFds.size() != 1 + count) {
+                fail("inconsistent handoff");
+                return;
+            }
+            bundle.listenerDescriptor = receivedFds.at(0);
+            bundle.connections.resize(count);
+            for (qint32 i = 0; i < count; ++i) {
+                Connection &connection = bundle.connections[i];
+                connection.descriptor = receivedFds.at(1 + i);
+                in >> connection.clientId >> connection.spectator >> connection.compressed >> connection.interned
+                   >> connection.strings >> connection.pendingInput;
+            }
+            in >> bundle.state;
+            if (in.status() != QDataStream::Ok) {
+                fail("inconsistent handoff");
+                return;
+            }
+
+            receivedFds.clear();    // appartiennent désormais au destinataire du bundle
+            closePeer();
+            emit received(bundle);
+            return;
+        }
+    }
+#endif
+}
+
+void SocketHandoff::fail(const QString &error)
+{
+    qWarning() << "Socket handoff failed:" << error;
+    closePeer();
+    emit failed(error);
+}
@@ -0,0 +1,79 @@
+#ifndef SOCKETHANDOFF_H
+#define SOCKETHANDOFF_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+class QSocketNotifier;
+
+// Passage des sockets vivantes d'un processus hôte à son successeur
+// (mise à jour sans coupure, Linux uniquement).
+//
+// L'hôte écoute sur une socket Unix abstraite "quizzgame-handoff-<port>".
+// Le nouveau processus (--takeover) s'y connecte ; l'hôte lui envoie par
+// SCM_RIGHTS la socket d'écoute et toutes les connexions, puis les
+// métadonnées (identifiants, tampons non lus, état de la partie). Les
+// clients ne voient qu'une courte pause : leurs connexions TCP ne sont
+// jamais fermées, seul le processus qui les lit change.
+class SocketHandoff : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Connection {
+        int descriptor = -1;
+        QString clientId;
+        bool spectator = false;
+        bool compressed = false;
+        bool interned = false;
+        QStringList strings;            // WireStrings::names() de la connexion
+        QByteArray pendingInput;        // reçu mais pas encore traité
+    };
+
+    struct Bundle {
+        int listenerDescriptor = -1;
+        QVector<Connection> connections;
+        QByteArray state;               // GameCheckpoint::encode()
+    };
+
+    explicit SocketHandoff(QObject *parent = nullptr);
+    ~SocketHandoff();
+
+    static void closeDescriptors(const Bundle &bundle);
+
+    // Ancien processus
+    bool listen(quint16 port);
+    void close();
+    bool send(const Bundle &bundle, QString *error);     // libère aussi le nom d'écoute
+
+    // Nouveau processus
+    bool request(quint16 port, QString *error);
+
+signals:
+    void handoffRequested();
+    void requestCancelled();
+    void received(const SocketHandoff::Bundle &bundle);
+    void failed(const QString &error);
+
+private:
+    void onListenerReadable();
+    void onPeerReadable();
+    void closePeer();
+    void closeListener();
+    void fail(const QString &error);
+
+    int listenerFd;
+    int peerFd;
+    bool requester;
+    QSocketNotifier *listenerNotifier;
+    QSocketNotifier *peerNotifier;
+
+    // Réception en cours (nouveau processus)
+    QVector<int> receivedFds;
+    QByteArray receivedData;
+};
+
+#endif // SOCKETHANDOFF_H
@@ -0,0 +1,111 @@
+#include "spectatorfeed.h"
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <algorithm>
+
+SpectatorFeed::SpectatorFeed(Game *game, NetworkManager *networkManager, QObject *parent)
+    : QObject(parent), game(game), networkManager(networkManager), dirty(true), secondsLeft(0)
+{
+    tickTimer = new QTimer(this);
+    tickTimer->setInterval(DEFAULT_TICK_MS);
+    connect(tickTimer, &QTimer::timeout, this, &SpectatorFeed::onTick);
+    tickTimer->start();
+
+    connect(game, &Game::gameCreated, this, &SpectatorFeed::markDirty);
+    connect(game, &Game::playerJoined, this, &SpectatorFeed::markDirty);
+    connect(game, &Game::playerLeft, this, &SpectatorFeed::markDirty);
+    connect(game, &Game::questionChanged, this, [this]() {
+        // Reprise en cours de question : le chrono de Game est déjà entamé
+        secondsLeft = int((game->questionRemainingMs() + 999) / 1000);
+        markDirty();
+    });
+    connect(game, &Game::answerSubmitted, this, &SpectatorFeed::markDirty);
+    connect(game, &Game::timeUpdate, this, &SpectatorFeed::onTimeUpdate);
+    connect(game, &Game::resultsReady, this, &SpectatorFeed::onResultsReady);
+    connect(game, &Game::gameEnded, this, &SpectatorFeed::onResultsReady);
+}
+
+void SpectatorFeed::setTickInterval(int ms)
+{
+    tickTimer->setInterval(ms);
+}
+
+void SpectatorFeed::markDirty()
+{
+    dirty = true;
+}
+
+void SpectatorFeed::onTimeUpdate(int seconds)
+{
+    secondsLeft = seconds;
+    dirty = true;
+}
+
+void SpectatorFeed::onResultsReady()
+{
+    // Top-K par sélection partielle : O(n log K), une fois par question
+    const QMap<QString, int> scores = game->getPlayerScores();
+    QVector<QPair<int, QString>> ranked;
+    ranked.reserve(scores.size());
+    for (auto it = scores.begin(); it != scores.end(); ++it)
+        ranked.append({it.value(), it.key()});
+
+    const int k = qMin(int(TOP_K), int(ranked.size()));
+    std::partial_sort(ranked.begin(), ranked.begin() + k, ranked.end(),
+                      [](const QPair<int, QString> &a, const QPair<int, QString> &b) {
+                          return a.first != b.first ? a.first > b.first : a.second < b.second;
+                      });
+
+    topPlayers = QJsonArray();
+    for (int i = 0; i < k; ++i) {
+        QJsonObject entry;
+        entry["playerName"] = ranked[i].second;
+        entry["score"] = ranked[i].first;
+        topPlayers.append(entry);
+    }
+    dirty = true;
+}
+
+void SpectatorFeed::onTick()
+{
+    if (!dirty || !networkManager->isServer() || networkManager->spectatorCount() == 0)
+        return;
+
+    networkManager->broadcastToSpectators(encodeFrame());
+    dirty = false;
+}
+
+QByteArray SpectatorFeed::encodeFrame() const
+{
+    QJsonObject data;
+    data["gameCode"] = game->getGameCode();
+    data["state"] = static_cast<int>(game->getState());
+    data["players"] = game->getPlayerScores().size();
+
+    if (game->getState() == Game::QUESTION_ACTIVE || game->getState() == Game::SHOWING_RESULTS) {
+        const Question question = game->getCurrentQuestion();
+        data["questionIndex"] = game->getCurrentQuestionIndex();
+        data["totalQuestions"] = game->getTotalQuestions();
+        data["question"] = question.getQuestionText();
+        data["answers"] = QJsonArray::fromStringList(question.getAnswers());
+        data["secondsLeft"] = secondsLeft;
+
+        QJsonArray histogram;
+        for (int count : game->getAnswerHistogram())
+            histogram.append(count);
+        data["histogram"] = histogram;
+
+        if (game->getState() == Game::SHOWING_RESULTS)
+            data["correctAnswer"] = question.getCorrectAnswerIndex();
+    }
+
+    data["leaderboard"] = topPlayers;
+
+    QJsonObject message;
+    message["type"] = "spectator_state";
+    message["data"] = data;
+
+    QByteArray frame = QJsonDocument(message).toJson(QJsonDocument::Compact);
+    frame.append('\n');
+    return frame;
+}
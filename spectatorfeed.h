@@ -0,0 +1,43 @@
+#ifndef SPECTATORFEED_H
+#define SPECTATORFEED_H
+
+#include <QObject>
+#include <QTimer>
+#include <QJsonArray>
+#include "game.h"
+#include "networkmanager.h"
+
+// Flux des spectateurs : l'état de la partie (question, compte à rebours,
+// histogramme des réponses, top-K) est fusionné puis encodé une seule fois
+// par tick, et la même trame est écrite sur chaque connexion spectateur.
+class SpectatorFeed : public QObject
+{
+    Q_OBJECT
+
+public:
+    static const int DEFAULT_TICK_MS = 250;
+    static const int TOP_K = 10;
+
+    explicit SpectatorFeed(Game *game, NetworkManager *networkManager, QObject *parent = nullptr);
+
+    void setTickInterval(int ms);
+
+private slots:
+    void onTick();
+    void markDirty();
+    void onTimeUpdate(int secondsLeft);
+    void onResultsReady();
+
+private:
+    Game *game;
+    NetworkManager *networkManager;
+    QTimer *tickTimer;
+
+    bool dirty;
+    int secondsLeft;
+    QJsonArray topPlayers;   // recalculé seulement quand les scores changent
+
+    QByteArray encodeFrame() const;
+};
+
+#endif // SPECTATORFEED_H
@@ -0,0 +1,62 @@
+#include "startuptrace.h"
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QTimer>
+#include <QWidget>
+#include <QDebug>
+#include <cstring>
+
+static QElapsedTimer startupClock;
+static bool traceEnabled = false;
+
+StartupTrace::StartupTrace(QObject *parent)
+    : QObject(parent)
+{
+}
+
+void StartupTrace::begin(int argc, char *argv[])
+{
+    // Appelé avant QApplication : on lit argv et l'environnement à la main
+    traceEnabled = qEnvironmentVariableIntValue("QUIZZ_TRACE_STARTUP") != 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--trace-startup") == 0)
+            traceEnabled = true;
+    }
+    startupClock.start();
+}
+
+bool StartupTrace::isEnabled()
+{
+    return traceEnabled;
+}
+
+void StartupTrace::mark(const QString &label)
+{
+    if (!traceEnabled)
+        return;
+
+    qInfo().noquote() << QString("[startup] %1 ms  %2")
+                         .arg(startupClock.nsecsElapsed() / 1e6, 8, 'f', 2)
+                         .arg(label);
+}
+
+void StartupTrace::watchFirstFrame(QWidget *window)
+{
+    if (!traceEnabled || !window)
+        return;
+
+    window->installEventFilter(new StartupTrace(window));
+}
+
+bool StartupTrace::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() == QEvent::Paint) {
+        watched->removeEventFilter(this);
+        // Le backing store est vidé à l'écran juste après ce paint
+        QTimer::singleShot(0, this, [this]() {
+            mark("first frame");
+            deleteLater();
+        });
+    }
+    return QObject::eventFilter(watched, event);
+}
@@ -0,0 +1,30 @@
+#ifndef STARTUPTRACE_H
+#define STARTUPTRACE_H
+
+#include <QObject>
+#include <QString>
+
+QT_BEGIN_NAMESPACE
+class QWidget;
+QT_END_NAMESPACE
+
+// Mode trace de démarrage (--trace-startup ou QUIZZ_TRACE_STARTUP=1) :
+// affiche le temps écoulé depuis main() à chaque étape, jusqu'au premier frame.
+class StartupTrace : public QObject
+{
+    Q_OBJECT
+
+public:
+    static void begin(int argc, char *argv[]);
+    static bool isEnabled();
+    static void mark(const QString &label);
+    static void watchFirstFrame(QWidget *window);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    explicit StartupTrace(QObject *parent = nullptr);
+};
+
+#endif // STARTUPTRACE_H
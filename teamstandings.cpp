@@ -0,0 +1,345 @@
+#include "teamstandings.h"
+#include <algorithm>
+#include <numeric>
+
+// Au-delà, un delta client reconstruit les paliers au lieu de monter point par point
+static const int MAX_RAISE_STEPS = 4096;
+
+void TeamStandings::clear()
+{
+    teams.clear();
+    teamIds.clear();
+    memberTeams.clear();
+    buckets.clear();
+    freeBuckets.clear();
+    bucketByScore.clear();
+    topBucket = -1;
+    bottomBucket = -1;
+}
+
+int TeamStandings::addMember(const QString &player, const QString &team)
+{
+    const QString name = team.trimmed();
+    if (name.isEmpty())
+        return -1;
+
+    int id = teamIds.value(name, -1);
+    if (id < 0) {
+        if (teams.size() >= MAX_TEAMS)
+            return -1;
+        id = createTeam(name);
+    }
+    if (teamOf(player) == id)
+        return id;
+
+    removeMember(player);
+    memberTeams.insert(player, id);
+    ++teams[id].members;
+    teams[id].changed = true;
+    return id;
+}
+
+void TeamStandings::removeMember(const QString &player)
+{
+    const auto it = memberTeams.constFind(player);
+    if (it == memberTeams.constEnd())
+        return;
+    Team &team = teams[it.value()];
+    --team.members;
+    team.changed = true;
+    memberTeams.erase(it);
+}
+
+int TeamStandings::teamOf(const QString &player) const
+{
+    return memberTeams.value(player, -1);
+}
+
+void TeamStandings::credit(const QString &player, bool correct)
+{
+    const int id = teamOf(player);
+    if (id < 0)
+        return;
+    ++teams[id].attempts;
+    teams[id].changed = true;
+    if (correct)
+        raise(id);
+}
+
+int TeamStandings::rank(int id) const
+{
+    return buckets.at(teams.at(id).bucket).rank;
+}
+
+QVector<TeamStandings::Standing> TeamStandings::standings(int limit) const
+{
+    QVector<Standing> rows;
+    if (limit < 0)
+        limit = size();
+    // Du palier le plus haut vers le bas : seuls les paliers affichés sont parcourus
+    for (int b = topBucket; b >= 0 && rows.size() < limit; b = buckets.at(b).lower) {
+        const qsizetype start = rows.size();
+        for (int id = buckets.at(b).first; id >= 0; id = teams.at(id).next) {
+            const Team &team = teams.at(id);
+            Standing row;
+            row.name = team.name;
+            row.score = team.score;
+            row.rank = buckets.at(b).rank;
+            row.members = team.members;
+            row.accuracy = team.attempts > 0 ? double(team.score) / team.attempts : 0.0;
+            rows.append(row);
+        }
+        std::sort(rows.begin() + start, rows.end(), [](const Standing &a, const Standing &b) {
+            return a.name < b.name;
+        });
+    }
+    rows.resize(qMin(rows.size(), qsizetype(limit)));
+    return rows;
+}
+
+QJsonArray TeamStandings::takeDelta()
+{
+    QJsonArray delta;
+    for (int id = 0; id < teams.size(); ++id) {
+        Team &team = teams[id];
+        if (!team.changed && team.announced)
+            continue;
+        QJsonArray entry{id, team.score, team.attempts, team.members};
+        if (!team.announced)
+            entry.append(team.name);
+        delta.append(entry);
+        team.changed = false;
+        team.announced = true;
+    }
+    return delta;
+}
+
+QJsonArray TeamStandings::toJson() const
+{
+    QJsonArray all;
+    for (int id = 0; id < teams.size(); ++id) {
+        const Team &team = teams.at(id);
+        all.append(QJsonArray{id, team.score, team.attempts, team.members, team.name});
+    }
+    return all;
+}
+
+bool TeamStandings::applyDelta(const QJsonArray &delta)
+{
+    // Vérifié en entier avant d'appliquer quoi que ce soit
+    int created = size();
+    QStringList names;
+    for (const QJsonValue &value : delta) {
+        const QJsonArray entry = value.toArray();
+        if (entry.size() < 4 || entry.size() > 5)
+            return false;
+        const int id = entry.at(0).toInt(-1);
+        if (id < 0 || id > created || entry.at(1).toInt(-1) < 0 || entry.at(2).toInt(-1) < 0 || entry.at(3).toInt(-1) < 0)
+            return false;
+        if (id == created) {
+            // Nouvelle équipe : ids contigus, nom obligatoire et libre
+            const QString name = entry.at(4).toString();
+            if (name.isEmpty() || teamIds.contains(name) || names.contains(name) || created >= MAX_TEAMS)
+                return false;
+            names.append(name);
+            ++created;
+        }
+    }
+
+    bool stale = false;
+    for (const QJsonValue &value : delta) {
+        const QJsonArray entry = value.toArray();
+        const int id = entry.at(0).toInt();
+        if (id == size())
+            createTeam(entry.at(4).toString());
+        Team &team = teams[id];
+        team.attempts = entry.at(2).toInt();
+        team.members = entry.at(3).toInt();
+
+        const int score = entry.at(1).toInt();
+        if (stale || score < team.score || score - team.score > MAX_RAISE_STEPS) {
+            team.score = score;
+            stale = true;
+        } else {
+            while (team.score < score)
+                raise(id);
+        }
+    }
+    if (stale)
+        rebuild();
+    return true;
+}
+
+TeamStandings::State TeamStandings::state() const
+{
+    State saved;
+    for (const Team &team : teams) {
+        saved.names.append(team.name);
+        saved.scores.append(team.score);
+        saved.attempts.append(team.attempts);
+    }
+    for (auto it = memberTeams.cbegin(); it != memberTeams.cend(); ++it)
+        saved.members.insert(it.key(), it.value());
+    return saved;
+}
+
+void TeamStandings::restore(const State &saved)
+{
+    clear();
+    const int count = qMin(int(saved.names.size()), MAX_TEAMS);
+    for (int id = 0; id < count; ++id) {
+        createTeam(saved.names.at(id));
+        Team &team = teams[id];
+        team.score = qMax(0, saved.scores.value(id));
+        team.attempts = qMax(0, saved.attempts.value(id));
+        team.announced = true;      // les joueurs reçoivent le même point de reprise
+    }
+    for (auto it = saved.members.cbegin(); it != saved.members.cend(); ++it) {
+        if (it.value() >= 0 && it.value() < count) {
+            memberTeams.insert(it.key(), it.value());
+            ++teams[it.value()].members;
+        }
+    }
+    rebuild();
+}
+
+int TeamStandings::createTeam(const QString &name)
+{
+    const int id = size();
+    Team team;
+    team.name = name;
+    teams.append(team);
+    teamIds.insert(name, id);
+
+    // Score nul : palier le plus bas, sous toutes les équipes existantes
+    int bottom = bucketByScore.value(0, -1);
+    if (bottom < 0) {
+        bottom = newBucket(0);
+        buckets[bottom].rank = id + 1;
+        appendBucket(bottom);
+    }
+    link(id, bottom);
+    return id;
+}
+
+void TeamStandings::raise(int id)
+{
+    const int from = teams.at(id).bucket;
+    const int score = teams.at(id).score + 1;
+    int to = bucketByScore.value(score, -1);
+    if (to < 0) {
+        // Palier inséré juste au-dessus : mêmes équipes au-dessus que l'ancien
+        to = newBucket(score);
+        Bucket &bucket = buckets[to];
+        bucket.rank = buckets.at(from).rank;
+        bucket.lower = from;
+        bucket.higher = buckets.at(from).higher;
+        if (bucket.higher >= 0)
+            buckets[bucket.higher].lower = to;
+        else
+            topBucket = to;
+        buckets[from].higher = to;
+    }
+
+    unlink(id);
+    teams[id].score = score;
+    link(id, to);
+    ++buckets[from].rank;           // une équipe de plus au-dessus
+    if (buckets.at(from).teams == 0)
+        releaseBucket(from);
+}
+
+void TeamStandings::rebuild()
+{
+    buckets.clear();
+    freeBuckets.clear();
+    bucketByScore.clear();
+    topBucket = -1;
+    bottomBucket = -1;
+
+    QVector<int> order(teams.size());
+    std::iota(order.begin(), order.end(), 0);
+    std::stable_sort(order.begin(), order.end(), [this](int a, int b) {
+        return teams.at(a).score > teams.at(b).score;
+    });
+    for (int i = 0; i < order.size(); ++i) {
+        const int id = order.at(i);
+        int bucket = bucketByScore.value(teams.at(id).score, -1);
+        if (bucket < 0) {
+            bucket = newBucket(teams.at(id).score);
+            buckets[bucket].rank = i + 1;   // toutes les équipes déjà placées sont au-dessus
+            appendBucket(bucket);
+        }
+        link(id, bucket);
+    }
+}
+
+int TeamStandings::newBucket(int score)
+{
+    int index;
+    if (!freeBuckets.isEmpty()) {
+        index = freeBuckets.takeLast();
+    } else {
+        index = int(buckets.size());
+        buckets.append(Bucket());
+    }
+    buckets[index] = Bucket();
+    buckets[index].score = score;
+    bucketByScore.insert(score, index);
+    return index;
+}
+
+void TeamStandings::releaseBucket(int index)
+{
+    const Bucket &bucket = buckets.at(index);
+    if (bucket.higher >= 0)
+        buckets[bucket.higher].lower = bucket.lower;
+    else
+        topBucket = bucket.lower;
+    if (bucket.lower >= 0)
+        buckets[bucket.lower].higher = bucket.higher;
+    else
+        bottomBucket = bucket.higher;
+    bucketByScore.remove(bucket.score);
+    freeBuckets.append(index);
+}
+
+void TeamStandings::appendBucket(int index)
+{
+    buckets[index].higher = bottomBucket;
+    buckets[index].lower = -1;
+    if (bottomBucket >= 0)
+        buckets[bottomBucket].lower = index;
+    else
+        topBucket = index;
+    bottomBucket = index;
+}
+
+void TeamStandings::link(int id, int bucket)
+{
+    Team &team = teams[id];
+    Bucket &target = buckets[bucket];
+    team.bucket = bucket;
+    team.previous = -1;
+    team.next = target.first;
+    if (target.first >= 0)
+        teams[target.first].previous = id;
+    target.first = id;
+    ++target.teams;
+}
+
+void TeamStandings::unlink(int id)
+{
+    Team &team = teams[id];
+    Bucket &source = buckets[team.bucket];
+    if (team.previous >= 0)
+        teams[team.previous].next = team.next;
+    else
+        source.first = team.next;
+    if (team.next >= 0)
+        teams[team.next].previous = team.previous;
+    --source.teams;
+    team.bucket = -1;
+    team.previous = -1;
+    team.next = -1;
+}
@@ -0,0 +1,111 @@
+#ifndef TEAMSTANDINGS_H
+#define TEAMSTANDINGS_H
+
+#include <QHash>
+#include <QJsonArray>
+#include <QMap>
+#include <QString>
+#include <QStringList>
+#include <QVector>
+
+// Classement des équipes, tenu à jour à chaque réponse créditée.
+//
+// Une équipe ne gagne jamais qu'un point à la fois (une bonne réponse d'un
+// membre). Les équipes sont donc rangées par paliers de score, chaînés du
+// plus haut au plus bas, et chaque palier garde son rang (1 + équipes
+// au-dessus) : un point fait passer l'équipe au palier voisin et ne change
+// que le rang de celui qu'elle quitte. O(1) par réponse, quel que soit le
+// nombre d'équipes ou de membres. Points et précision restent à l'équipe
+// quand un membre s'en va.
+class TeamStandings
+{
+public:
+    struct Team
+    {
+        QString name;
+        int score = 0;              // bonnes réponses des membres
+        int attempts = 0;           // réponses attendues des membres (une par question)
+        int members = 0;
+
+        // Chaînage dans le palier de score, suivi des deltas
+        int bucket = -1;
+        int previous = -1;
+        int next = -1;
+        bool announced = false;     // nom déjà diffusé
+        bool changed = false;       // depuis le dernier takeDelta()
+    };
+
+    struct Standing
+    {
+        QString name;
+        int score = 0;
+        int rank = 0;               // ex aequo au même rang
+        int members = 0;
+        double accuracy = 0.0;      // 0..1
+    };
+
+    // Point de reprise : équipes par id (ordre de création), conservé tel quel
+    struct State
+    {
+        QStringList names;
+        QVector<int> scores;
+        QVector<int> attempts;
+        QMap<QString, int> members;     // joueur -> id d'équipe
+    };
+
+    static const int MAX_TEAMS = 1024;
+
+    void clear();
+    bool isEmpty() const { return teams.isEmpty(); }
+
+    int addMember(const QString &player, const QString &team);  // id de l'équipe, -1 si team est vide
+    void removeMember(const QString &player);
+    int teamOf(const QString &player) const;                    // -1 sans équipe
+    void credit(const QString &player, bool correct);           // O(1)
+
+    int size() const { return int(teams.size()); }
+    const Team &team(int id) const { return teams.at(id); }
+    int rank(int id) const;                                     // O(1)
+    QVector<Standing> standings(int limit = -1) const;          // par rang puis par nom
+
+    // Diffusion : [[id, score, attempts, members(, nom)], ...] ; takeDelta()
+    // ne donne que les équipes changées depuis l'appel précédent, et leur nom
+    // seulement à la première apparition
+    QJsonArray takeDelta();
+    QJsonArray toJson() const;
+    bool applyDelta(const QJsonArray &delta);   // false : delta incohérent, rien n'est appliqué
+
+    State state() const;
+    void restore(const State &state);
+
+private:
+    struct Bucket
+    {
+        int score = 0;
+        int rank = 1;
+        int teams = 0;
+        int first = -1;             // première équipe du palier
+        int higher = -1;            // palier de score supérieur, -1 en tête
+        int lower = -1;
+    };
+
+    int createTeam(const QString &name);
+    void raise(int id);
+    void rebuild();
+    int newBucket(int score);
+    void releaseBucket(int index);
+    void appendBucket(int index);   // en bas de la chaîne
+    void link(int id, int bucket);
+    void unlink(int id);
+
+    QVector<Team> teams;
+    QHash<QString, int> teamIds;
+    QHash<QString, int> memberTeams;    // joueur -> id
+    QVector<Bucket> buckets;
+    QVector<int> freeBuckets;
+    QHash<int, int> bucketByScore;      // score -> palier
+    int topBucket = -1;
+    int bottomBucket = -1;
+};
+
+#endif // TEAMSTANDINGS_H
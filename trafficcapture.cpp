@@ -0,0 +1,147 @@
+#include "trafficcapture.h"
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QtEndian>
+#include <QDebug>
+#include <cstring>
+#include <memory>
+
+static const char CAPTURE_MAGIC[4] = {'Q', 'Z', 'T', '1'};
+static constexpr int CAPTURE_HEADER_SIZE = 16;       // magic + version + début (ms)
+static constexpr int EVENT_HEADER_SIZE = 21;         // type + connexion + horodatage + taille
+static constexpr quint32 MAX_EVENT_PAYLOAD = 64 * 1024 * 1024;
+
+TrafficCapture::TrafficCapture(const QString &path)
+    : file(path)
+{
+    // Fichier déjà pris (capture de l'hôte qui nous passe la main) : suffixe du processus
+    if (!file.open(QIODevice::WriteOnly | QIODevice::NewOnly)) {
+        file.setFileName(path + '.' + QString::number(QCoreApplication::applicationPid()));
+        file.open(QIODevice::WriteOnly | QIODevice::NewOnly);
+    }
+    if (!file.isOpen()) {
+        qWarning() << "Traffic capture disabled:" << file.errorString();
+        return;
+    }
+
+    uchar header[CAPTURE_HEADER_SIZE];
+    std::memcpy(header, CAPTURE_MAGIC, 4);
+    qToLittleEndian<quint32>(FORMAT_VERSION, header + 4);
+    qToLittleEndian<qint64>(QDateTime::currentMSecsSinceEpoch(), header + 8);
+    file.write(reinterpret_cast<const char *>(header), CAPTURE_HEADER_SIZE);
+    clock.start();
+    pending.reserve(2 * FLUSH_THRESHOLD);
+}
+
+TrafficCapture::~TrafficCapture()
+{
+    flush();
+}
+
+TrafficCapture *TrafficCapture::shared()
+{
+    static std::unique_ptr<TrafficCapture> instance = []() -> std::unique_ptr<TrafficCapture> {
+        const QString path = qEnvironmentVariable("QUIZZ_CAPTURE");
+        if (path.isEmpty())
+            return nullptr;
+        auto capture = std::make_unique<TrafficCapture>(path);
+        if (!capture->isOpen())
+            return nullptr;
+        qDebug() << "Capturing traffic to" << capture->path();
+        return capture;
+    }();
+    return instance.get();
+}
+
+bool TrafficCapture::isOpen() const
+{
+    return file.isOpen();
+}
+
+QString TrafficCapture::path() const
+{
+    return file.fileName();
+}
+
+void TrafficCapture::record(EventKind kind, quint64 connection, const char *data, int size)
+{
+    if (!file.isOpen())
+        return;
+
+    const qsizetype start = pending.size();
+    pending.resize(start + EVENT_HEADER_SIZE + size);
+    uchar *p = reinterpret_cast<uchar *>(pending.data() + start);
+
+    *p++ = kind;
+    qToLittleEndian<quint64>(connection, p);                 p += 8;
+    qToLittleEndian<qint64>(clock.nsecsElapsed(), p);        p += 8;
+    qToLittleEndian<quint32>(quint32(size), p);              p += 4;
+    if (size > 0)
+        std::memcpy(p, data, size);
+
+    if (pending.size() >= FLUSH_THRESHOLD)
+        flush();
+}
+
+void TrafficCapture::flush()
+{
+    if (pending.isEmpty() || !file.isOpen())
+        return;
+    file.write(pending);
+    file.flush();
+    pending.clear();
+}
+
+TrafficCapture::Reader::Reader(const QString &path)
+    : file(path), data(nullptr), size(0), position(0), startMs(0)
+{
+    if (!file.open(QIODevice::ReadOnly) || file.size() < CAPTURE_HEADER_SIZE)
+        return;
+    data = file.map(0, file.size());
+    if (!data)
+        return;
+
+    if (std::memcmp(data, CAPTURE_MAGIC, 4) != 0 || qFromLittleEndian<quint32>(data + 4) != FORMAT_VERSION) {
+        file.unmap(const_cast<uchar *>(data));
+        data = nullptr;
+        return;
+    }
+    size = file.size();
+    startMs = qFromLittleEndian<qint64>(data + 8);
+    position = CAPTURE_HEADER_SIZE;
+}
+
+TrafficCapture::Reader::~Reader()
+{
+    if (data)
+        file.unmap(const_cast<uchar *>(data));
+}
+
+bool TrafficCapture::Reader::isValid() const
+{
+    return data != nullptr;
+}
+
+qint64 TrafficCapture::Reader::startedAt() const
+{
+    return startMs;
+}
+
+bool TrafficCapture::Reader::next(Event *event)
+{
+    // Un enregistrement tronqué (processus tué en pleine écriture) termine la lecture
+    if (!data || size - position < EVENT_HEADER_SIZE)
+        return false;
+
+    const uchar *p = data + position;
+    const quint32 length = qFromLittleEndian<quint32>(p + 17);
+    if (length > MAX_EVENT_PAYLOAD || qint64(length) > size - position - EVENT_HEADER_SIZE)
+        return false;
+
+    event->kind = p[0];
+    event->connection = qFromLittleEndian<quint64>(p + 1);
+    event->timestampNs = qFromLittleEndian<qint64>(p + 9);
+    event->payload = QByteArray(reinterpret_cast<const char *>(p + EVENT_HEADER_SIZE), qsizetype(length));
+    position += EVENT_HEADER_SIZE + length;
+    return true;
+}
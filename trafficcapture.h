@@ -0,0 +1,84 @@
+#ifndef TRAFFICCAPTURE_H
+#define TRAFFICCAPTURE_H
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QFile>
+#include <QString>
+
+// Capture du trafic de NetworkManager (QUIZZ_CAPTURE=<fichier>), rejouée
+// par QuizzReplay.
+//
+// Chaque trame est enregistrée décodée (JSON sans terminateur, après
+// décompression) avec l'identifiant de sa connexion et un horodatage
+// monotone depuis le début de la capture. Les diffusions ne sont écrites
+// qu'une fois, sous une connexion fictive. Tout vit sur le thread réseau :
+// les enregistrements s'accumulent en mémoire et partent par blocs, au plus
+// tard FLUSH_INTERVAL_MS après (NetworkManager). Un fichier existant n'est
+// jamais écrasé : un successeur (--takeover) capture dans "<fichier>.<pid>".
+class TrafficCapture
+{
+public:
+    enum EventKind : quint8 {
+        FRAME_IN = 1,
+        FRAME_OUT = 2,
+        CONNECTION_OPENED = 3,
+        CONNECTION_CLOSED = 4
+    };
+
+    // Connexions fictives (les vraies sont des ClientHandle::key())
+    static constexpr quint64 HOST_CONNECTION = 0;               // côté client : la connexion à l'hôte
+    static constexpr quint64 ALL_PLAYERS = ~quint64(0);
+    static constexpr quint64 ALL_SPECTATORS = ~quint64(0) - 1;
+
+    static constexpr quint32 FORMAT_VERSION = 1;
+    static constexpr int FLUSH_THRESHOLD = 64 * 1024;
+    static constexpr int FLUSH_INTERVAL_MS = 250;
+
+    struct Event {
+        quint8 kind = 0;
+        quint64 connection = 0;
+        qint64 timestampNs = 0;     // depuis le début de la capture
+        QByteArray payload;
+    };
+
+    explicit TrafficCapture(const QString &path);
+    ~TrafficCapture();
+
+    TrafficCapture(const TrafficCapture &) = delete;
+    TrafficCapture &operator=(const TrafficCapture &) = delete;
+
+    // Instance du processus, null si QUIZZ_CAPTURE n'est pas défini
+    static TrafficCapture *shared();
+
+    bool isOpen() const;
+    QString path() const;
+    void record(EventKind kind, quint64 connection, const char *data = nullptr, int size = 0);
+    void flush();
+
+    // Lecture séquentielle (mmap)
+    class Reader
+    {
+    public:
+        explicit Reader(const QString &path);
+        ~Reader();
+
+        bool isValid() const;
+        qint64 startedAt() const;   // ms depuis l'époque Unix
+        bool next(Event *event);
+
+    private:
+        QFile file;
+        const uchar *data;
+        qint64 size;
+        qint64 position;
+        qint64 startMs;
+    };
+
+private:
+    QFile file;
+    QElapsedTimer clock;
+    QByteArray pending;
+};
+
+#endif // TRAFFICCAPTURE_H
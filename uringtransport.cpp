@@ -0,0 +1,710 @@
+#include "uringtransport.h"
+#include <QDebug>
+
+#ifdef QUIZZ_HAVE_URING
+#include <QDeadlineTimer>
+#include <QHostAddress>
+#include <QSocketNotifier>
+#include <QSysInfo>
+#include <QTimer>
+#include <QVarLengthArray>
+#include <QVersionNumber>
+#include <liburing.h>
+#include <netinet/in.h>
+#include <sys/eventfd.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+
+static constexpr unsigned RING_ENTRIES = 4096;
+static constexpr unsigned COMPLETION_ENTRIES = 16384;   // multishot : plusieurs complétions par SQE
+static constexpr int BUFFER_GROUP = 0;
+static constexpr int BUFFER_COUNT = 4096;               // puissance de 2
+static constexpr int BUFFER_SIZE = 4096;                // 16 Mio partagés par toutes les connexions
+static constexpr int MAX_IOVECS = 64;                   // trames par sendmsg
+static constexpr int ACCEPT_RETRY_MS = 100;
+
+// user_data : opération (8 bits) | génération de la connexion (24) | descripteur (32)
+enum Operation : quint64 {
+    ACCEPT = 1,
+    RECV,
+    SEND,
+    CANCEL
+};
+
+static quint64 userData(Operation operation, quint32 generation, int descriptor)
+{
+    return (quint64(operation) << 56) | (quint64(generation & 0xffffff) << 32) | quint32(descriptor);
+}
+
+struct UringTransport::Connection
+{
+    int descriptor = -1;
+    quint32 generation = 0;
+    quint64 tag = 0;
+    bool recvArmed = false;
+    bool sending = false;
+    bool closing = false;
+    bool dirty = false;                 // dans la liste du prochain flush
+    int inFlight = 0;                   // trames de tête dans le sendmsg en vol
+    QList<QByteArray> queue;            // trames partagées avec l'appelant, pas de copie
+    qsizetype headOffset = 0;           // déjà parti de la première trame
+    qint64 queuedBytes = 0;
+    iovec iov[MAX_IOVECS];              // tenus ici tant que le sendmsg est en vol
+    msghdr message;
+};
+
+UringTransport::UringTransport(QObject *parent)
+    : QObject(parent), ring(nullptr), buffers(nullptr), bufferPool(nullptr), bufferMask(0), buffersToRecycle(0),
+      eventDescriptor(-1), notifier(nullptr), listener(-1), port(0), acceptArmed(false), acceptPaused(false),
+      detached(false), flushQueued(false), reaping(false), nextGeneration(1)
+{
+}
+
+UringTransport::~UringTransport()
+{
+    stop();
+    delete notifier;
+    if (ring) {
+        // Anneau fermé d'abord : plus aucune opération ne vise nos tampons
+        if (buffers)
+            io_uring_free_buf_ring(ring, buffers, BUFFER_COUNT, BUFFER_GROUP);
+        io_uring_queue_exit(ring);
+        delete ring;
+    }
+    for (Connection *connection : connections) {
+        if (connection) {
+            ::close(connection->descriptor);
+            delete connection;
+        }
+    }
+    std::free(bufferPool);
+    if (eventDescriptor >= 0)
+        ::close(eventDescriptor);
+}
+
+bool UringTransport::isSupported()
+{
+    static const bool supported = []() {
+        // recv multishot : noyau 6.0 ; io_uring peut aussi être interdit (seccomp, io_uring_disabled)
+        if (QVersionNumber::fromString(QSysInfo::kernelVersion()) < QVersionNumber(6, 0))
+            return false;
+        io_uring probe;
+        if (io_uring_queue_init(2, &probe, 0) < 0)
+            return false;
+        io_uring_queue_exit(&probe);
+        return true;
+    }();
+    return supported;
+}
+
+bool UringTransport::listen(quint16 listenPort, QString *error)
+{
+    stop();
+
+    if (!ring) {
+        io_uring *created = new io_uring;
+        io_uring_params params = {};
+        params.flags = IORING_SETUP_CQSIZE | IORING_SETUP_SUBMIT_ALL;
+        params.cq_entries = COMPLETION_ENTRIES;
+        const int result = io_uring_queue_init_params(RING_ENTRIES, created, &params);
+        if (result < 0) {
+            delete created;
+            *error = "io_uring_queue_init: " + qt_error_string(-result);
+            return false;
+        }
+        ring = created;
+
+        // Anneau de tampons enregistré : le noyau y choisit un tampon à chaque réception
+        int bufferError = 0;
+        buffers = io_uring_setup_buf_ring(ring, BUFFER_COUNT, BUFFER_GROUP, 0, &bufferError);
+        if (!buffers) {
+            *error = "io_uring_setup_buf_ring: " + qt_error_string(-bufferError);
+            return false;
+        }
+        bufferPool = static_cast<char *>(std::aligned_alloc(4096, size_t(BUFFER_COUNT) * BUFFER_SIZE));
+        bufferMask = io_uring_buf_ring_mask(BUFFER_COUNT);
+        for (int i = 0; i < BUFFER_COUNT; ++i)
+            io_uring_buf_ring_add(buffers, bufferPool + qsizetype(i) * BUFFER_SIZE, BUFFER_SIZE, i, bufferMask, i);
+        io_uring_buf_ring_advance(buffers, BUFFER_COUNT);
+
+        eventDescriptor = ::eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (eventDescriptor < 0 || io_uring_register_eventfd(ring, eventDescriptor) < 0) {
+            *error = "eventfd: " + qt_error_string(errno);
+            return false;
+        }
+        notifier = new QSocketNotifier(eventDescriptor, QSocketNotifier::Read, this);
+        connect(notifier, &QSocketNotifier::activated, this, &UringTransport::onCompletions);
+    }
+
+    // Double pile comme QHostAddress::Any, IPv4 seul en repli
+    sockaddr_storage address = {};
+    socklen_t length = 0;
+    int descriptor = ::socket(AF_INET6, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (descriptor >= 0) {
+        const int off = 0;
+        ::setsockopt(descriptor, IPPROTO_IPV6, IPV6_V6ONLY, &off, sizeof(off));
+        sockaddr_in6 *any = reinterpret_cast<sockaddr_in6 *>(&address);
+        any->sin6_family = AF_INET6;
+        any->sin6_port = htons(listenPort);
+        any->sin6_addr = in6addr_any;
+        length = sizeof(sockaddr_in6);
+    } else {
+        descriptor = ::socket(AF_INET, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        sockaddr_in *any = reinterpret_cast<sockaddr_in *>(&address);
+        any->sin_family = AF_INET;
+        any->sin_port = htons(listenPort);
+        any->sin_addr.s_addr = htonl(INADDR_ANY);
+        length = sizeof(sockaddr_in);
+    }
+    const int on = 1;
+    if (descriptor < 0 || ::setsockopt(descriptor, SOL_SOCKET, SO_REUSEADDR, &on, sizeof(on)) < 0
+        || ::bind(descriptor, reinterpret_cast<sockaddr *>(&address), length) < 0
+        || ::listen(descriptor, SOMAXCONN) < 0) {
+        *error = qt_error_string(errno);
+        if (descriptor >= 0)
+            ::close(descriptor);
+        return false;
+    }
+
+    length = sizeof(address);
+    ::getsockname(descriptor, reinterpret_cast<sockaddr *>(&address), &length);
+    port = ntohs(address.ss_family == AF_INET6 ? reinterpret_cast<sockaddr_in6 *>(&address)->sin6_port
+                                               : reinterpret_cast<sockaddr_in *>(&address)->sin_port);
+    listener = descriptor;
+    armAccept();
+    submit();
+    return true;
+}
+
+void UringTransport::stop()
+{
+    // Après detach(), le successeur tient les mêmes connexions : on lâche nos descripteurs
+    const CloseMode mode = detached ? RELEASE : GRACEFUL;
+    for (Connection *connection : connections) {
+        if (connection)
+            close(connection->descriptor, mode);
+    }
+    while (!pending.isEmpty())
+        ::close(pending.dequeue().descriptor);
+
+    if (listener >= 0) {
+        if (acceptArmed)
+            cancel(userData(ACCEPT, 0, listener));
+        ::close(listener);
+        listener = -1;
+    }
+    port = 0;
+    acceptPaused = false;
+    detached = false;
+    submit();
+}
+
+bool UringTransport::isListening() const
+{
+    return listener >= 0;
+}
+
+quint16 UringTransport::serverPort() const
+{
+    return port;
+}
+
+int UringTransport::listenerDescriptor() const
+{
+    return listener;
+}
+
+bool UringTransport::hasPendingConnections() const
+{
+    return !pending.isEmpty();
+}
+
+UringTransport::Accepted UringTransport::nextPendingConnection()
+{
+    return pending.isEmpty() ? Accepted() : pending.dequeue();
+}
+
+void UringTransport::reject(int descriptor)
+{
+    ::close(descriptor);
+}
+
+void UringTransport::pauseAccepting()
+{
+    // Les connexions suivantes attendent dans la file du noyau
+    acceptPaused = true;
+    if (acceptArmed) {
+        cancel(userData(ACCEPT, 0, listener));
+        submit();
+    }
+}
+
+void UringTransport::resumeAccepting()
+{
+    acceptPaused = false;
+    if (listener >= 0 && !acceptArmed && !detached) {
+        armAccept();
+        submit();
+    }
+}
+
+void UringTransport::attach(int descriptor, quint64 tag)
+{
+    if (descriptor < 0)
+        return;
+    if (size_t(descriptor) >= connections.size())
+        connections.resize(size_t(descriptor) + 1, nullptr);
+
+    Connection *connection = new Connection;
+    connection->descriptor = descriptor;
+    connection->generation = nextGeneration;
+    connection->tag = tag;
+    nextGeneration = (nextGeneration + 1) & 0xffffff;
+    if (nextGeneration == 0)
+        nextGeneration = 1;
+    connections[size_t(descriptor)] = connection;
+
+    armRecv(connection);
+    scheduleFlush();
+}
+
+bool UringTransport::send(int descriptor, const QByteArray &frame)
+{
+    Connection *target = connection(descriptor);
+    if (!target || target->closing || frame.isEmpty())
+        return false;
+
+    target->queue.append(frame);
+    target->queuedBytes += frame.size();
+    if (!target->sending && !target->dirty) {
+        target->dirty = true;
+        dirty.append(descriptor);
+        scheduleFlush();
+    }
+    return true;
+}
+
+qint64 UringTransport::bytesToWrite(int descriptor) const
+{
+    const Connection *target = connection(descriptor);
+    return target ? target->queuedBytes : 0;
+}
+
+void UringTransport::close(int descriptor, CloseMode mode)
+{
+    Connection *target = connection(descriptor);
+    if (!target || target->closing)
+        return;
+
+    target->closing = true;
+    if (target->recvArmed)
+        cancel(userData(RECV, target->generation, descriptor));
+
+    if (mode == ABORT) {
+        // La trame en vol échoue aussitôt ; les suivantes sont perdues
+        ::shutdown(descriptor, SHUT_RDWR);
+        while (target->queue.size() > (target->sending ? target->inFlight : 0)) {
+            target->queuedBytes -= target->queue.constLast().size();
+            target->queue.removeLast();
+        }
+    } else if (mode == GRACEFUL && !target->sending && !target->queue.isEmpty()) {
+        startSend(target);
+    }
+
+    if (!target->sending)
+        finishClose(target);
+    scheduleFlush();
+}
+
+bool UringTransport::detach(int msecs)
+{
+    detached = true;
+    if (acceptArmed)
+        cancel(userData(ACCEPT, 0, listener));
+    for (Connection *target : connections) {
+        if (target && target->recvArmed)
+            cancel(userData(RECV, target->generation, target->descriptor));
+    }
+    flush();
+
+    // Acceptées mais pas encore remises : perdues pour le successeur, le client se reconnectera
+    while (!pending.isEmpty())
+        ::close(pending.dequeue().descriptor);
+
+    // Réceptions arrêtées et écritures vidées, comme waitForBytesWritten() côté Qt
+    const QDeadlineTimer deadline(msecs);
+    for (;;) {
+        bool busy = acceptArmed;
+        for (const Connection *target : connections)
+            busy = busy || (target && (target->recvArmed || target->sending));
+        if (!busy)
+            return true;
+
+        const qint64 remaining = deadline.remainingTime();
+        if (remaining <= 0)
+            return false;
+        __kernel_timespec timeout = {};
+        timeout.tv_sec = remaining / 1000;
+        timeout.tv_nsec = (remaining % 1000) * 1000000;
+        io_uring_cqe *cqe = nullptr;
+        const int result = io_uring_wait_cqe_timeout(ring, &cqe, &timeout);
+        if (result < 0 && result != -EINTR)
+            return false;
+        reap();
+    }
+}
+
+void UringTransport::resume()
+{
+    detached = false;
+    if (listener >= 0 && !acceptArmed && !acceptPaused)
+        armAccept();
+    for (Connection *target : connections) {
+        if (!target || target->closing)
+            continue;
+        if (!target->recvArmed)
+            armRecv(target);
+        if (!target->sending && !target->queue.isEmpty())
+            startSend(target);
+    }
+    submit();
+}
+
+UringTransport::Connection *UringTransport::connection(int descriptor) const
+{
+    return descriptor >= 0 && size_t(descriptor) < connections.size() ? connections[size_t(descriptor)] : nullptr;
+}
+
+UringTransport::Connection *UringTransport::connection(int descriptor, quint32 generation) const
+{
+    Connection *target = connection(descriptor);
+    return target && target->generation == generation ? target : nullptr;
+}
+
+void UringTransport::onCompletions()
+{
+    eventfd_t count = 0;
+    ::eventfd_read(eventDescriptor, &count);
+    reap();
+}
+
+void UringTransport::reap()
+{
+    struct Completion
+    {
+        quint64 data;
+        int result;
+        quint32 flags;
+    };
+
+    // Complétions copiées avant traitement : un rappel peut fermer n'importe quelle connexion
+    reaping = true;
+    QVarLengthArray<Completion, 256> batch;
+    for (;;) {
+        unsigned head;
+        unsigned count = 0;
+        io_uring_cqe *cqe;
+        io_uring_for_each_cqe(ring, head, cqe) {
+            batch.append(Completion{io_uring_cqe_get_data64(cqe), cqe->res, cqe->flags});
+            ++count;
+        }
+        if (count == 0)
+            break;
+        io_uring_cq_advance(ring, count);
+
+        for (const Completion &completion : std::as_const(batch)) {
+            const int descriptor = int(quint32(completion.data));
+            const quint32 generation = quint32(completion.data >> 32) & 0xffffff;
+            switch (Operation(completion.data >> 56)) {
+            case ACCEPT:
+                onAcceptComplete(completion.result, completion.flags);
+                break;
+            case RECV:
+                onRecvComplete(descriptor, generation, completion.result, completion.flags);
+                break;
+            case SEND:
+                onSendComplete(descriptor, generation, completion.result);
+                break;
+            case CANCEL:
+                break;
+            }
+        }
+        batch.clear();
+    }
+    reaping = false;
+
+    if (buffersToRecycle > 0) {
+        io_uring_buf_ring_advance(buffers, buffersToRecycle);
+        buffersToRecycle = 0;
+    }
+    flush();
+}
+
+void UringTransport::submit()
+{
+    if (!ring || io_uring_sq_ready(ring) == 0)
+        return;
+    const int result = io_uring_submit(ring);
+    if (result < 0 && result != -EBUSY && result != -EAGAIN)
+        qWarning() << "io_uring_submit:" << qt_error_string(-result);
+}
+
+io_uring_sqe *UringTransport::nextSqe()
+{
+    io_uring_sqe *sqe = io_uring_get_sqe(ring);
+    if (!sqe) {
+        // File de soumission pleine : soumise tout de suite, puis on continue
+        io_uring_submit(ring);
+        sqe = io_uring_get_sqe(ring);
+    }
+    return sqe;
+}
+
+void UringTransport::scheduleFlush()
+{
+    // Pendant reap(), le flush de fin de tour s'en charge
+    if (reaping || flushQueued)
+        return;
+    flushQueued = true;
+    QMetaObject::invokeMethod(this, [this]() { flush(); }, Qt::QueuedConnection);
+}
+
+void UringTransport::flush()
+{
+    // Toutes les connexions qui ont des trames en file, en un seul io_uring_submit()
+    flushQueued = false;
+    for (int descriptor : std::as_const(dirty)) {
+        Connection *target = connection(descriptor);
+        if (!target)
+            continue;
+        target->dirty = false;
+        if (!target->sending && !target->queue.isEmpty())
+            startSend(target);
+    }
+    dirty.clear();
+    submit();
+}
+
+void UringTransport::armAccept()
+{
+    io_uring_sqe *sqe = nextSqe();
+    io_uring_prep_multishot_accept(sqe, listener, nullptr, nullptr, SOCK_CLOEXEC);
+    io_uring_sqe_set_data64(sqe, userData(ACCEPT, 0, listener));
+    acceptArmed = true;
+}
+
+void UringTransport::armRecv(Connection *target)
+{
+    io_uring_sqe *sqe = nextSqe();
+    io_uring_prep_recv_multishot(sqe, target->descriptor, nullptr, 0, 0);
+    sqe->flags |= IOSQE_BUFFER_SELECT;
+    sqe->buf_group = BUFFER_GROUP;
+    io_uring_sqe_set_data64(sqe, userData(RECV, target->generation, target->descriptor));
+    target->recvArmed = true;
+}
+
+void UringTransport::cancel(quint64 data)
+{
+    io_uring_sqe *sqe = nextSqe();
+    io_uring_prep_cancel64(sqe, data, 0);
+    io_uring_sqe_set_data64(sqe, userData(CANCEL, 0, 0));
+}
+
+void UringTransport::startSend(Connection *target)
+{
+    // Un sendmsg pour toutes les trames en file (jusqu'à MAX_IOVECS)
+    const int count = int(qMin<qsizetype>(target->queue.size(), MAX_IOVECS));
+    for (int i = 0; i < count; ++i) {
+        const QByteArray &frame = target->queue.at(i);
+        const qsizetype offset = i == 0 ? target->headOffset : 0;
+        target->iov[i].iov_base = const_cast<char *>(frame.constData()) + offset;
+        target->iov[i].iov_len = size_t(frame.size() - offset);
+    }
+    target->message = {};
+    target->message.msg_iov = target->iov;
+    target->message.msg_iovlen = size_t(count);
+
+    io_uring_sqe *sqe = nextSqe();
+    io_uring_prep_sendmsg(sqe, target->descriptor, &target->message, MSG_NOSIGNAL);
+    io_uring_sqe_set_data64(sqe, userData(SEND, target->generation, target->descriptor));
+    target->sending = true;
+    target->inFlight = count;
+}
+
+void UringTransport::onAcceptComplete(int result, quint32 flags)
+{
+    if (!(flags & IORING_CQE_F_MORE))
+        acceptArmed = false;
+
+    if (result >= 0) {
+        if (listener < 0 || detached) {
+            ::close(result);
+        } else {
+            Accepted accepted;
+            accepted.descriptor = result;
+            sockaddr_storage address = {};
+            socklen_t length = sizeof(address);
+            if (::getpeername(result, reinterpret_cast<sockaddr *>(&address), &length) == 0)
+                accepted.address = QHostAddress(reinterpret_cast<const sockaddr *>(&address)).toString();
+            pending.enqueue(accepted);
+        }
+    } else if (result != -ECANCELED) {
+        qDebug() << "io_uring accept:" << qt_error_string(-result);
+    }
+
+    if (!acceptArmed && listener >= 0 && !acceptPaused && !detached) {
+        if (result >= 0 || result == -ECANCELED) {
+            armAccept();
+        } else {
+            // EMFILE, ENFILE... : pas de réarmement en boucle
+            QTimer::singleShot(ACCEPT_RETRY_MS, this, [this]() { resumeAccepting(); });
+        }
+    }
+
+    if (!pending.isEmpty() && !acceptPaused && newConnection)
+        newConnection();
+}
+
+void UringTransport::onRecvComplete(int descriptor, quint32 generation, int result, quint32 flags)
+{
+    if (flags & IORING_CQE_F_BUFFER) {
+        const int bufferId = int(flags >> IORING_CQE_BUFFER_SHIFT);
+        const Connection *target = connection(descriptor, generation);
+        if (target && !target->closing && result > 0 && received)
+            received(target->tag, bufferPool + qsizetype(bufferId) * BUFFER_SIZE, result);
+        recycleBuffer(bufferId);
+    }
+    if (flags & IORING_CQE_F_MORE)
+        return;
+
+    // Fin du multishot
+    Connection *target = connection(descriptor, generation);
+    if (!target)
+        return;
+    target->recvArmed = false;
+    if (target->closing || detached)
+        return;
+    if (result > 0 || result == -ENOBUFS) {
+        // Tampons épuisés un instant : ils sont rendus avant la prochaine soumission
+        armRecv(target);
+        return;
+    }
+    peerClosed(target);     // 0 : fin de flux, < 0 : erreur (ECONNRESET...)
+}
+
+void UringTransport::onSendComplete(int descriptor, quint32 generation, int result)
+{
+    Connection *target = connection(descriptor, generation);
+    if (!target)
+        return;
+    target->sending = false;
+    target->inFlight = 0;
+
+    if (result < 0) {
+        target->queue.clear();
+        target->headOffset = 0;
+        target->queuedBytes = 0;
+        if (target->closing)
+            finishClose(target);
+        else
+            peerClosed(target);
+        return;
+    }
+
+    // Envoi partiel : la suite repart de headOffset
+    qint64 remaining = result;
+    target->queuedBytes -= remaining;
+    while (remaining > 0 && !target->queue.isEmpty()) {
+        const qsizetype available = target->queue.constFirst().size() - target->headOffset;
+        if (remaining < available) {
+            target->headOffset += remaining;
+            break;
+        }
+        remaining -= available;
+        target->headOffset = 0;
+        target->queue.removeFirst();
+    }
+
+    if (!target->queue.isEmpty()) {
+        startSend(target);
+    } else if (target->closing) {
+        finishClose(target);
+        return;
+    }
+    if (!target->closing && sent)
+        sent(target->tag);
+}
+
+void UringTransport::peerClosed(Connection *target)
+{
+    const quint64 tag = target->tag;
+    close(target->descriptor, ABORT);
+    if (closed)
+        closed(tag);
+}
+
+void UringTransport::finishClose(Connection *target)
+{
+    // Fermée tout de suite, même si l'annulation de la réception n'est pas
+    // encore revenue : le noyau garde sa propre référence à la socket jusque-là.
+    // Le numéro de descripteur, lui, peut être réattribué aussitôt ; c'est la
+    // génération portée par chaque complétion (connection()) qui écarte les
+    // CQE tardifs de l'ancienne connexion.
+    connections[size_t(target->descriptor)] = nullptr;
+    ::close(target->descriptor);
+    delete target;
+}
+
+void UringTransport::recycleBuffer(int bufferId)
+{
+    io_uring_buf_ring_add(buffers, bufferPool + qsizetype(bufferId) * BUFFER_SIZE, BUFFER_SIZE, bufferId, bufferMask,
+                          buffersToRecycle++);
+}
+
+#else
+
+// Sans liburing : jamais disponible, NetworkManager reste sur QTcpServer
+
+struct UringTransport::Connection
+{
+};
+
+UringTransport::UringTransport(QObject *parent)
+    : QObject(parent), ring(nullptr), buffers(nullptr), bufferPool(nullptr), bufferMask(0), buffersToRecycle(0),
+      eventDescriptor(-1), notifier(nullptr), listener(-1), port(0), acceptArmed(false), acceptPaused(false),
+      detached(false), flushQueued(false), reaping(false), nextGeneration(1)
+{
+}
+
+UringTransport::~UringTransport() = default;
+
+bool UringTransport::isSupported()
+{
+    return false;
+}
+
+bool UringTransport::listen(quint16, QString *error)
+{
+    *error = "io_uring transport not built";
+    return false;
+}
+
+void UringTransport::stop() {}
+bool UringTransport::isListening() const { return false; }
+quint16 UringTransport::serverPort() const { return 0; }
+int UringTransport::listenerDescriptor() const { return -1; }
+bool UringTransport::hasPendingConnections() const { return false; }
+UringTransport::Accepted UringTransport::nextPendingConnection() { return Accepted(); }
+void UringTransport::reject(int) {}
+void UringTransport::pauseAccepting() {}
+void UringTransport::resumeAccepting() {}
+void UringTransport::attach(int, quint64) {}
+bool UringTransport::send(int, const QByteArray &) { return false; }
+qint64 UringTransport::bytesToWrite(int) const { return 0; }
+void UringTransport::close(int, CloseMode) {}
+bool UringTransport::detach(int) { return false; }
+void UringTransport::resume() {}
+
+#endif // QUIZZ_HAVE_URING
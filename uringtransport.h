@@ -0,0 +1,117 @@
+#ifndef URINGTRANSPORT_H
+#define URINGTRANSPORT_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QQueue>
+#include <QString>
+#include <QVector>
+#include <functional>
+#include <vector>
+
+class QSocketNotifier;
+struct io_uring;
+struct io_uring_buf_ring;
+struct io_uring_sqe;
+
+// Transport hôte sur io_uring (Linux, liburing, noyau 6.0 ou plus), derrière
+// NetworkManager quand QUIZZ_IO_URING=1 ; sinon, ou s'il est indisponible,
+// QTcpServer reste le transport.
+//
+// Un seul anneau par transport : accept et recv multishot (un SQE armé une
+// fois par écoute ou par connexion), réception dans un anneau de tampons
+// enregistré partagé par toutes les connexions, envois mis en file puis
+// soumis en un seul io_uring_submit() par tour de boucle d'événements (un
+// sendmsg par connexion, toutes ses trames en attente dans les iovec).
+// Les complétions réveillent la boucle Qt par un eventfd.
+class UringTransport : public QObject
+{
+public:
+    enum CloseMode {
+        GRACEFUL,       // ce qui est en file part d'abord
+        ABORT,          // tout de suite, file perdue
+        RELEASE         // notre descripteur seulement (passage de relais)
+    };
+
+    struct Accepted {
+        int descriptor = -1;
+        QString address;
+    };
+
+    // Appelés depuis la boucle d'événements ; ils peuvent envoyer ou fermer
+    std::function<void()> newConnection;                                 // nextPendingConnection()
+    std::function<void(quint64 tag, const char *data, int size)> received;
+    std::function<void(quint64 tag)> sent;                              // une partie de la file est partie
+    std::function<void(quint64 tag)> closed;                            // fermée par le pair ou en erreur
+
+    explicit UringTransport(QObject *parent = nullptr);
+    ~UringTransport();
+
+    static bool isSupported();          // compilé avec liburing et anneau créé par le noyau
+
+    bool listen(quint16 port, QString *error);
+    void stop();                        // ferme tout (GRACEFUL, RELEASE après detach())
+    bool isListening() const;
+    quint16 serverPort() const;
+    int listenerDescriptor() const;
+
+    bool hasPendingConnections() const;
+    Accepted nextPendingConnection();
+    void reject(int descriptor);        // refusée à l'admission, jamais confiée
+    void pauseAccepting();
+    void resumeAccepting();
+
+    // Connexion acceptée confiée au transport ; tag repris dans les rappels
+    void attach(int descriptor, quint64 tag);
+    bool send(int descriptor, const QByteArray &frame);
+    qint64 bytesToWrite(int descriptor) const;
+    void close(int descriptor, CloseMode mode);
+
+    // Passage de relais : plus rien d'armé ni en vol sur les descripteurs,
+    // qui restent ouverts ; resume() réarme tout (relais annulé)
+    bool detach(int msecs);
+    void resume();
+
+private:
+    struct Connection;
+
+    Connection *connection(int descriptor) const;
+    Connection *connection(int descriptor, quint32 generation) const;
+    void onCompletions();
+    void reap();
+    void submit();
+    io_uring_sqe *nextSqe();
+    void scheduleFlush();
+    void flush();
+    void armAccept();
+    void armRecv(Connection *target);
+    void cancel(quint64 data);
+    void startSend(Connection *target);
+    void onAcceptComplete(int result, quint32 flags);
+    void onRecvComplete(int descriptor, quint32 generation, int result, quint32 flags);
+    void onSendComplete(int descriptor, quint32 generation, int result);
+    void peerClosed(Connection *target);
+    void finishClose(Connection *target);
+    void recycleBuffer(int bufferId);
+
+    io_uring *ring;
+    io_uring_buf_ring *buffers;
+    char *bufferPool;
+    int bufferMask;
+    int buffersToRecycle;
+    int eventDescriptor;
+    QSocketNotifier *notifier;
+    int listener;
+    quint16 port;
+    bool acceptArmed;
+    bool acceptPaused;
+    bool detached;
+    bool flushQueued;
+    bool reaping;                               // dans reap() : le flush de fin de tour suffit
+    quint32 nextGeneration;
+    QQueue<Accepted> pending;
+    std::vector<Connection *> connections;      // indexées par descripteur
+    QVector<int> dirty;                         // descripteurs à envoyer au prochain flush
+};
+
+#endif // URINGTRANSPORT_H
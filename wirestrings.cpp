@@ -0,0 +1,273 @@
+#include "wirestrings.h"
+#include <QJsonDocument>
+#include <cmath>
+#include <zlib.h>
+
+// Même ordre que WireStrings::Id ; toute modification change tableId()
+static const char *const TABLE[WireStrings::ID_COUNT] = {
+    "join_game", "setup_game", "rejoin_game", "resume_game", "start_game", "answer", "next_question",
+    "playerName", "gameCode", "theme", "questions", "question", "answers", "correct", "checkpoint",
+};
+
+static const QHash<QString, int> &tableIndex()
+{
+    static const QHash<QString, int> index = []() {
+        QHash<QString, int> entries;
+        for (int i = 0; i < WireStrings::ID_COUNT; ++i)
+            entries.insert(QString::fromLatin1(TABLE[i]), i);
+        return entries;
+    }();
+    return index;
+}
+
+static bool startsWithDigit(const QString &key)
+{
+    return !key.isEmpty() && key.at(0) >= u'0' && key.at(0) <= u'9';
+}
+
+// Entier JSON positif ou nul, -1 sinon
+static int integerOf(const QJsonValue &value)
+{
+    if (!value.isDouble())
+        return -1;
+    const double number = value.toDouble();
+    if (number < 0 || number > 1e9 || number != std::floor(number))
+        return -1;
+    return int(number);
+}
+
+static QString wireKey(const QString &key)
+{
+    const int id = WireStrings::id(key);
+    if (id >= 0)
+        return QString::number(id);
+    if (startsWithDigit(key) || key.startsWith(u'~'))
+        return QStringLiteral("~") + key;
+    return key;
+}
+
+static bool plainKey(const QString &key, QString *plain)
+{
+    if (key.startsWith(u'~')) {
+        *plain = key.mid(1);
+        return true;
+    }
+    if (startsWithDigit(key)) {
+        bool ok = false;
+        *plain = WireStrings::string(key.toInt(&ok));
+        return ok && !plain->isEmpty();
+    }
+    *plain = key;
+    return true;
+}
+
+quint32 WireStrings::tableId()
+{
+    static const quint32 id = []() {
+        QByteArray table = QByteArray::number(MAX_NAMES);
+        for (const char *entry : TABLE) {
+            table += '\0';
+            table += entry;
+        }
+        return quint32(crc32(crc32(0L, Z_NULL, 0), reinterpret_cast<const Bytef *>(table.constData()),
+                             uInt(table.size())));
+    }();
+    return id;
+}
+
+QString WireStrings::string(int id)
+{
+    return id >= 0 && id < ID_COUNT ? QString::fromLatin1(TABLE[id]) : QString();
+}
+
+int WireStrings::id(const QString &string)
+{
+    return tableIndex().value(string, -1);
+}
+
+QByteArray WireStrings::encode(const QJsonObject &message)
+{
+    // Seuls les messages de GameSession : type, sender, data
+    for (auto it = message.begin(); it != message.end(); ++it) {
+        if (it.key() != QLatin1String("type") && it.key() != QLatin1String("sender") && it.key() != QLatin1String("data"))
+            return QByteArray();
+    }
+    const QJsonValue type = message.value("type");
+    const QJsonValue sender = message.value("sender");
+    const QJsonValue data = message.value("data");
+    if (!type.isString() || !sender.isString() || !(data.isUndefined() || data.isObject()))
+        return QByteArray();
+    const QJsonValue playerName = data.toObject().value("playerName");
+    if (!playerName.isUndefined() && !playerName.isString())
+        return QByteArray();
+
+    QJsonArray frame;
+    const int typeId = id(type.toString());
+    frame.append(typeId >= 0 ? QJsonValue(typeId) : type);
+    frame.append(nameRef(sender.toString()));           // avant playerName : même ordre au décodage
+    if (data.isObject()) {
+        QJsonObject fields = data.toObject();
+        fields.remove("playerName");
+        QJsonObject compact = compactObject(fields);
+        if (playerName.isString())
+            compact[QString::number(PLAYER_NAME)] = nameRef(playerName.toString());
+        frame.append(compact);
+    }
+    return QJsonDocument(frame).toJson(QJsonDocument::Compact);
+}
+
+bool WireStrings::decode(const QByteArray &frame, QJsonObject *message)
+{
+    QJsonParseError error;
+    const QJsonDocument document = QJsonDocument::fromJson(frame, &error);
+    if (error.error != QJsonParseError::NoError || !document.isArray())
+        return false;
+    const QJsonArray array = document.array();
+    if (array.size() < 2 || array.size() > 3)
+        return false;
+
+    const QString type = array.at(0).isString() ? array.at(0).toString() : string(integerOf(array.at(0)));
+    if (type.isEmpty())
+        return false;
+
+    // Noms définis par cette trame : retenus seulement si elle est valide
+    QStringList pending;
+    QString sender;
+    if (!resolveName(array.at(1), &pending, &sender))
+        return false;
+
+    QJsonObject result;
+    result["type"] = type;
+    result["sender"] = sender;
+    if (array.size() == 3) {
+        if (!array.at(2).isObject())
+            return false;
+        QJsonObject compact = array.at(2).toObject();
+        const QJsonValue playerName = compact.take(QString::number(PLAYER_NAME));
+        QJsonObject data;
+        if (!expandObject(compact, &data))
+            return false;
+        if (!playerName.isUndefined()) {
+            QString name;
+            if (!resolveName(playerName, &pending, &name))
+                return false;
+            data["playerName"] = name;
+        }
+        result["data"] = data;
+    }
+
+    definedNames.append(pending);
+    *message = result;
+    return true;
+}
+
+const QString *WireStrings::name(int id) const
+{
+    return id >= 0 && id < definedNames.size() ? &definedNames.at(id) : nullptr;
+}
+
+void WireStrings::restore(const QStringList &names)
+{
+    definedNames = names.mid(0, MAX_NAMES);
+    nameIds.clear();
+    for (int i = 0; i < definedNames.size(); ++i)
+        nameIds.insert(definedNames.at(i), i);
+}
+
+QJsonValue WireStrings::nameRef(const QString &name)
+{
+    const auto it = nameIds.constFind(name);
+    if (it != nameIds.constEnd())
+        return it.value();
+    if (definedNames.size() < MAX_NAMES) {
+        nameIds.insert(name, int(definedNames.size()));
+        definedNames.append(name);
+    }
+    return name;
+}
+
+bool WireStrings::resolveName(const QJsonValue &value, QStringList *pending, QString *name) const
+{
+    if (value.isString()) {
+        *name = value.toString();
+        if (definedNames.size() + pending->size() < MAX_NAMES)
+            pending->append(*name);
+        return true;
+    }
+    const int id = integerOf(value);
+    if (id < 0 || id >= definedNames.size() + pending->size())
+        return false;
+    *name = id < definedNames.size() ? definedNames.at(id) : pending->at(id - definedNames.size());
+    return true;
+}
+
+QJsonObject WireStrings::compactObject(const QJsonObject &object)
+{
+    QJsonObject compact;
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        if (it.value().isObject())
+            compact[wireKey(it.key())] = compactObject(it.value().toObject());
+        else if (it.value().isArray())
+            compact[wireKey(it.key())] = compactArray(it.value().toArray());
+        else
+            compact[wireKey(it.key())] = it.value();
+    }
+    return compact;
+}
+
+QJsonArray WireStrings::compactArray(const QJsonArray &array)
+{
+    QJsonArray compact;
+    for (const QJsonValue &value : array) {
+        if (value.isObject())
+            compact.append(compactObject(value.toObject()));
+        else if (value.isArray())
+            compact.append(compactArray(value.toArray()));
+        else
+            compact.append(value);
+    }
+    return compact;
+}
+
+bool WireStrings::expandObject(const QJsonObject &object, QJsonObject *expanded)
+{
+    for (auto it = object.begin(); it != object.end(); ++it) {
+        QString key;
+        if (!plainKey(it.key(), &key))
+            return false;
+        if (it.value().isObject()) {
+            QJsonObject child;
+            if (!expandObject(it.value().toObject(), &child))
+                return false;
+            expanded->insert(key, child);
+        } else if (it.value().isArray()) {
+            QJsonArray child;
+            if (!expandArray(it.value().toArray(), &child))
+                return false;
+            expanded->insert(key, child);
+        } else {
+            expanded->insert(key, it.value());
+        }
+    }
+    return true;
+}
+
+bool WireStrings::expandArray(const QJsonArray &array, QJsonArray *expanded)
+{
+    for (const QJsonValue &value : array) {
+        if (value.isObject()) {
+            QJsonObject child;
+            if (!expandObject(value.toObject(), &child))
+                return false;
+            expanded->append(child);
+        } else if (value.isArray()) {
+            QJsonArray child;
+            if (!expandArray(value.toArray(), &child))
+                return false;
+            expanded->append(child);
+        } else {
+            expanded->append(value);
+        }
+    }
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef WIRESTRINGS_H
+#define WIRESTRINGS_H
+
+#include <QByteArray>
+#include <QHash>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QString>
+#include <QStringList>
+
+// Dictionnaire de chaînes d'une connexion client → hôte, négocié par
+// "hello" ("strings": tableId()).
+//
+// Une trame compacte est un tableau JSON [type, sender, data]. Le type et
+// les clés connues sont remplacés par leur rang dans une table fixe (clé
+// "7" ; une clé inconnue qui commence par un chiffre ou '~' prend un '~'
+// devant). Un nom de joueur (sender, data.playerName) passe une fois en
+// clair, ce qui lui donne le numéro suivant de la connexion, puis ne passe
+// plus que par ce numéro.
+class WireStrings
+{
+public:
+    enum Id {
+        JOIN_GAME, SETUP_GAME, REJOIN_GAME, RESUME_GAME, START_GAME, ANSWER, NEXT_QUESTION,
+        PLAYER_NAME, GAME_CODE, THEME, QUESTIONS, QUESTION, ANSWERS, CORRECT, CHECKPOINT,
+        ID_COUNT
+    };
+    static constexpr int MAX_NAMES = 256;      // par connexion ; les suivants restent en clair
+
+    static quint32 tableId();
+    static QString string(int id);              // vide hors table
+    static int id(const QString &string);       // -1 hors table
+
+    // Émetteur : vide si le message ne s'y prête pas (à envoyer en JSON)
+    QByteArray encode(const QJsonObject &message);
+    // Récepteur : false si la trame est invalide ou cite un nom inconnu
+    bool decode(const QByteArray &frame, QJsonObject *message);
+    const QString *name(int id) const;
+
+    // Passage de relais : noms déjà définis, dans l'ordre
+    QStringList names() const { return definedNames; }
+    void restore(const QStringList &names);
+
+private:
+    QJsonValue nameRef(const QString &name);
+    bool resolveName(const QJsonValue &value, QStringList *pending, QString *name) const;
+    static QJsonObject compactObject(const QJsonObject &object);
+    static QJsonArray compactArray(const QJsonArray &array);
+    static bool expandObject(const QJsonObject &object, QJsonObject *expanded);
+    static bool expandArray(const QJsonArray &array, QJsonArray *expanded);
+
+    QHash<QString, int> nameIds;                // côté émetteur
+    QStringList definedNames;
+};
+
+#endif // WIRESTRINGS_H